@@ -11,6 +11,8 @@
 #include <ctype.h>
 #include <time.h>
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <math.h>
 
 #define WISAM_VERSION "2.0"
@@ -22,6 +24,16 @@
 #define MAX_ARRAY_SIZE 10000
 #define MAX_CLASSES 100
 #define MAX_MODULES 50
+#define OBJECT_INDEX_THRESHOLD 8
+#define SHAPE_MAX_KEYS 64
+#define SHAPE_MAX_TRANSITIONS 64
+#define SWITCH_JUMP_TABLE_MAX 1024
+#define MEMO_MAX_ENTRIES 4096
+#define MEMO_PROBE_LIMIT 8
+#define MAP_MIN_CAPACITY 8
+#define SET_SMALL_MAX 16
+#define VECTOR_BITS 5
+#define VECTOR_WIDTH (1 << VECTOR_BITS)
 
 // أنواع الرموز (Token Types)
 typedef enum {
@@ -60,6 +72,7 @@ typedef enum {
     TOKEN_DO,           // نفذ
     TOKEN_UNTIL,        // حتى
     TOKEN_FOREACH,      // لكل_عنصر
+    TOKEN_PARALLEL_FOR, // لكل_متوازي
     TOKEN_YIELD,        // أنتج
     TOKEN_ASYNC,        // غير_متزامن
     TOKEN_AWAIT,        // انتظر
@@ -160,6 +173,7 @@ typedef struct {
 // أنواع القيم
 typedef enum {
     VAL_NUMBER,
+    VAL_INT,
     VAL_STRING,
     VAL_BOOLEAN,
     VAL_NULL,
@@ -167,14 +181,22 @@ typedef enum {
     VAL_OBJECT,
     VAL_FUNCTION,
     VAL_STRUCT_DEF,
+    VAL_STRUCT,
     VAL_CLASS_DEF,
     VAL_INSTANCE,
+    VAL_MAP,
+    VAL_SET,
+    VAL_VECTOR,
+    VAL_RANGE,
+    VAL_PIPELINE,
     VAL_MIND,
     VAL_SYSTEM,
     VAL_NEURAL,
     VAL_MODULE,
     VAL_PROMISE,
     VAL_ITERATOR,
+    VAL_CHANNEL,
+    VAL_FROZEN,
     VAL_EXCEPTION
 } ValueType;
 
@@ -193,23 +215,87 @@ typedef struct Object Object;
 // هيكل الوعد (Promise) - تعريف مسبق
 typedef struct Promise Promise;
 
+// المهمة: إطار دالة غير متزامنة قابل للاستئناف - تعريف مسبق
+typedef struct Task Task;
+
+// مرحلة في سلسلة كسولة - تعريف مسبق
+typedef struct Pipeline Pipeline;
+
+// القناة: حلقة محدودة تتشاركها الخيوط بعداد ذري - تعريف مسبق
+typedef struct Channel Channel;
+
+// القيمة المجمدة: حاوية لا تتغير تتشاركها الخيوط بعداد ذري - تعريف مسبق
+typedef struct Frozen Frozen;
+
+// الشكل (Shape): تسلسل مفاتيح مشترك بين الكائنات ذات البنية نفسها
+// الكائنات التي تضاف إليها المفاتيح بالترتيب نفسه تتشارك شكلاً واحداً
+typedef struct Shape {
+    char **keys;                    // المفاتيح بترتيب الإدراج
+    int count;
+    int *index;                     // فهرس تجزئة للأشكال الكبيرة (NULL للصغيرة)
+    int index_capacity;
+    struct Shape *parent;
+    struct Shape **transitions;     // الأشكال الناتجة عن إضافة مفتاح واحد (جدول تجزئة بآخر مفتاح)
+    int transition_count;
+    int transition_capacity;        // قوة للعدد 2، والخانة الفارغة NULL
+} Shape;
+
+// تعريف الهيكل: تخطيط حقول ثابت يحسب عند التحليل
+// موضع كل حقل هو موضعه في الشكل، فتتشارك الهياكل والكائنات الذاكرة المؤقتة المضمنة
+typedef struct StructDef {
+    char *name;
+    Shape *shape;                   // الحقول بترتيب التعريف
+} StructDef;
+
+// نسخة الهيكل - تعريف مسبق
+typedef struct StructInstance StructInstance;
+
+// ذاكرة نتائج دالة نقية - تعريف مسبق
+typedef struct FunctionMemo FunctionMemo;
+
+// الخريطة - تعريف مسبق
+typedef struct Map Map;
+
+// المجموعة - تعريف مسبق
+typedef struct Set Set;
+
+// عقدة المتجه الدائم - تعريف مسبق
+typedef struct VectorNode VectorNode;
+
+// هيكل النص (String) - ترويسة تسبق محارف النص في الذاكرة
+// القيمة as.string تشير إلى chars مباشرة فتبقى صالحة كـ char* عادي
+typedef struct {
+    size_t length;          // الطول بالبايت
+    size_t capacity;        // السعة المحجوزة للمحارف (دون المنهي)
+    int char_count;         // عدد محارف UTF-8، أو -1 إن لم يحسب بعد
+    unsigned int hash;      // قيمة التجزئة المخزنة
+    bool has_hash;          // هل حسبت التجزئة
+    char chars[];           // المحارف متبوعة بـ '\0'
+} String;
+
 // هيكل القيمة (Value)
 typedef struct Value {
     ValueType type;
     union {
         double number;
+        int64_t integer;
         char *string;
         bool boolean;
         struct {
             struct Value **items;
             int count;
-            int capacity;
+            int capacity;           // الخانات المتاحة من items فصاعداً
+            int offset;             // خانات فارغة قبل items (بداية الحجز items - offset)
         } array;
         struct {
-            char **keys;
+            char **keys;            // مفاتيح الشكل، أو مفاتيح مملوكة للكائن في وضع القاموس
             struct Value **values;
             int count;
             int capacity;
+            Shape *shape;           // NULL: وضع القاموس (كائن كبير بمفاتيح مملوكة)
+            int *index;             // فهرس التجزئة للكائنات الكبيرة (NULL للصغيرة)
+            int index_capacity;     // عدد خانات الفهرس (قوة للعدد 2)
+            int indexed_count;      // عدد المفاتيح المضافة إلى الفهرس
         } object;
         struct {
             char *name;
@@ -219,16 +305,29 @@ typedef struct Value {
             Environment *closure;
             bool is_native;
             struct Value (*native_fn)(struct Value *args, int arg_count);
+            FunctionMemo *memo;     // ذاكرة النتائج (NULL للدوال الأصلية ودوال الأصناف)
+            bool is_async;          // يعيد استدعاؤها وعداً وتنفذ كمهمة
+            bool is_generator;      // تحتوي 'أنتج': يعيد استدعاؤها مكرراً كسولاً
+            bool shares_frozen;     // أصلية تأخذ القيم المجمدة كما هي (وغيرها يأخذ نسخة قابلة للتعديل)
         } function;
         struct {
-            char *name;
-            char **fields;
-            int field_count;
+            StructDef *def;         // يملكه المحلل ويبقى طوال التشغيل
         } struct_def;
+        StructInstance *structure;
+        struct {
+            Class *def;             // الأصناف تبقى طوال التشغيل
+        } class_def;
         struct {
             Class *class_def;
-            Object *instance;
+            Object *instance;       // مرجع مشترك بعداد (النسخ لا تنسخ الحقول)
         } instance;
+        Map *map;
+        Set *set;
+        struct {
+            VectorNode *root;       // مشتركة بين النسخ بعداد مراجع
+            int count;
+            int shift;              // عمق الشجرة × VECTOR_BITS (0: الجذر ورقة)
+        } vector;
         struct {
             char *name;
             struct Value **memories;
@@ -251,15 +350,16 @@ typedef struct Value {
             struct Value **exports;
             int export_count;
         } module;
+        Promise *promise;           // مرجع مشترك بعداد
         struct {
-            bool resolved;
-            struct Value *value;
-            struct Promise *next;
-        } promise;
-        struct {
-            struct Value *collection;
-            int index;
-        } iterator;
+            int64_t start;
+            int64_t stop;               // غير مشمول
+            int64_t step;
+        } range;                        // مدى عددي كسول: لا يحجز عناصره
+        Task *iterator;             // مولد مشترك بعداد (النسخ تتقدم معاً)
+        Pipeline *pipeline;         // آخر مرحلة في سلسلة كسولة ثابتة مشتركة بعداد
+        Channel *channel;           // مرجع مشترك بين الخيوط
+        Frozen *frozen;             // حاوية مجمدة مشتركة بعداد ذري (النسخ لا تنسخ المحتوى)
         struct {
             char *message;
             int code;
@@ -268,25 +368,131 @@ typedef struct Value {
     } as;
 } Value;
 
+// نسخة الهيكل: ترويسة وحقول في كتلة واحدة متصلة
+struct StructInstance {
+    StructDef *def;
+    Value fields[];
+};
+
+// مدخل في الخريطة
+typedef struct {
+    Value key;
+    Value *value;               // مخصصة منفردة فيبقى عنوانها ثابتاً عند الإزاحة والتوسع
+    unsigned int hash;
+    int distance;               // البعد عن الخانة الأصلية، -1: خانة فارغة
+} MapEntry;
+
+// خريطة بمفاتيح من أي قيمة قابلة للتجزئة: عنونة مفتوحة بأسلوب روبن هود
+// (المدخل الأبعد عن خانته يتقدم) مع حذف بالإزاحة للخلف دون شواهد قبور
+struct Map {
+    MapEntry *entries;
+    int capacity;               // قوة للعدد 2، أو 0 قبل أول إضافة
+    int count;
+};
+
+// مجموعة: العناصر متصلة بترتيب الإضافة وتجزئاتها في مصفوفة موازية
+// الصغيرة تبحث بمسح التجزئات المتصلة، والأكبر من SET_SMALL_MAX تبني فهرساً
+struct Set {
+    Value *items;
+    unsigned int *hashes;
+    int count;
+    int capacity;
+    int *index;                 // موضع العنصر + 1 (0: خانة فارغة)، NULL للصغيرة
+    int index_capacity;         // قوة للعدد 2
+};
+
+// عقدة في المتجه الدائم: شجرة بتفرع VECTOR_WIDTH تتشارك النسخ عقدها،
+// والتعديل ينسخ المسار من الجذر إلى الورقة فقط (O(log n)) إن كانت مشتركة
+struct VectorNode {
+    int refcount;
+    union {
+        struct VectorNode *children[VECTOR_WIDTH];  // العقد الداخلية (NULL: لم تنشأ بعد)
+        Value values[VECTOR_WIDTH];                 // الأوراق (الخانات غير المستخدمة فارغة)
+    } as;
+};
+
+// مدخل في ذاكرة النتائج: المعاملات مفتاحاً والنتيجة قيمة
+typedef struct {
+    unsigned int hash;
+    int arg_count;              // -1: خانة فارغة
+    Value *args;
+    Value result;
+} MemoEntry;
+
+// ذاكرة نتائج دالة نقية: جدول محدود الحجم بالتجزئة البنيوية للمعاملات
+// يحدد نقاء الدالة عند أول استدعاء، ويعاد التحليل إذا تغيرت دوال البيئة العامة
+// بعده. والدوال غير النقية لا تخزن نتائجها
+struct FunctionMemo {
+    char *name;
+    int purity;                 // -1 لم يحلل، 0 غير نقية، 1 نقية، 2 قيد التحليل
+    unsigned int epoch;         // إصدار البيئة العامة عند التحليل
+    bool registered;            // في سجل الدوال النقية
+    MemoEntry *entries;
+    int capacity;               // قوة للعدد 2 لا تتجاوز MEMO_MAX_ENTRIES
+    int count;
+    long hits;
+    long misses;
+    FunctionMemo *next;         // سجل الدوال النقية (لمكتبة الميتا)
+};
+
 // هيكل الدالة - تعريف مسبق
 typedef struct Function Function;
 
 // هيكل الصنف
+// جدول الدوال مسطح: يبدأ بنسخة من جدول الأب بالمواضع نفسها، والدالة المعاد
+// تعريفها تحل محل الأصل في موضعه، والجديدة تضاف في آخره
 struct Class {
     char *name;
-    char **fields;
+    char **fields;              // الحقول المعلنة شاملة حقول الأب
     int field_count;
-    struct Function **methods;
+    Shape *method_shape;        // أسماء الدوال ومواضعها في الجدول (امتداد لشكل الأب)
+    Value *vtable;
     int method_count;
     Class *parent;
     bool is_abstract;
 };
 
-// هيكل الكائن
+// هيكل الكائن (نسخة صنف)
 struct Object {
     Class *class_def;
-    Value **field_values;
-    int field_count;
+    Value fields;               // الحقول ككائن: نسخ الصنف الواحد تتشارك شكلاً واحداً
+    int refcount;
+};
+
+// القيمة المجمدة: المحتوى لا يتغير بعد التجميد، وكل حاوية فيه مجمدة بدورها،
+// فقراءة عنصر تزيد عداداً ولا تنسخ شيئاً
+struct Frozen {
+    int refcount;
+    Value value;
+};
+
+// الوعد: نتيجة عملية غير متزامنة تتشاركها كل نسخه
+struct Promise {
+    int refcount;
+    bool resolved;
+    Value value;                // النتيجة، أو استثناء إذا رفض الوعد
+    Task **waiters;             // المهام المعلقة حتى يتحقق
+    int waiter_count;
+    int waiter_capacity;
+};
+
+// السلسلة الكسولة: قائمة مراحل مرتبطة من الأخيرة إلى المصدر
+// إضافة مرحلة تنشئ عقدة جديدة تشارك ما قبلها، فالسلاسل لا تتغير بعد إنشائها
+typedef enum {
+    STAGE_SOURCE,                   // value هو المصدر (أي قيمة يمر عليها value_iterate)
+    STAGE_MAP,                      // value دالة تحول العنصر
+    STAGE_FILTER,                   // value دالة تبقي العنصر إن أعادت قيمة صادقة
+    STAGE_TAKE,                     // أول count عنصر ثم تتوقف السلسلة
+    STAGE_SKIP                      // تتجاوز أول count عنصر
+} PipelineStage;
+
+struct Pipeline {
+    int refcount;
+    PipelineStage stage;
+    Value value;
+    int64_t count;
+    int depth;                      // عدد المراحل حتى المصدر (المصدر 0)
+    Pipeline *parent;
 };
 
 // عقدة شجرة النحو (AST Node)
@@ -345,7 +551,11 @@ typedef enum {
     AST_PROPERTY_ACCESS,
     AST_STATIC_CALL,
     AST_INCREMENT,
-    AST_DECREMENT
+    AST_DECREMENT,
+    AST_OBJECT,
+    AST_MAP,
+    AST_INDEX_ASSIGN,
+    AST_PROPERTY_ASSIGN
 } ASTNodeType;
 
 typedef struct ASTNode {
@@ -369,6 +579,7 @@ typedef struct ASTNode {
         struct {
             char *name;
             struct ASTNode *value;
+            bool is_append;     // س = س + تعبير (إلحاق في المكان)
         } assign;
         struct {
             struct ASTNode *condition;
@@ -381,6 +592,7 @@ typedef struct ASTNode {
             struct ASTNode *end;
             struct ASTNode *step;
             struct ASTNode *body;
+            bool is_parallel;           // لكل_متوازي: الدورات توزع على خيوط العمال
         } for_loop;
         struct {
             struct ASTNode *condition;
@@ -401,6 +613,7 @@ typedef struct ASTNode {
             int param_count;
             struct ASTNode *body;
             bool is_async;
+            bool is_generator;
             bool is_static;
             char *return_type;
         } function_def;
@@ -418,6 +631,7 @@ typedef struct ASTNode {
             char *name;
             char **fields;
             int field_count;
+            StructDef *layout;
         } struct_def;
         struct {
             struct ASTNode *object;
@@ -426,12 +640,14 @@ typedef struct ASTNode {
         struct {
             char *struct_name;
             char *var_name;
+            StructDef *layout;
+            struct ASTNode **values;    // قيم الحقول مرتبة بموضعها (NULL: فارغ)
         } struct_create;
         struct {
             char *name;
             char **fields;
             int field_count;
-            Function **methods;
+            struct ASTNode **methods;   // عقد AST_FUNCTION_DEF
             int method_count;
             char *parent_name;
             bool is_abstract;
@@ -448,6 +664,8 @@ typedef struct ASTNode {
             char *method_name;
             struct ASTNode **args;
             int arg_count;
+            Class *cache_class;         // ذاكرة مؤقتة مضمنة: آخر صنف رؤي هنا
+            int cache_index;            // وموضع الدالة في جدوله
         } method_call;
         struct {
             char *module_name;
@@ -531,6 +749,14 @@ typedef struct ASTNode {
             struct ASTNode **cases;
             int case_count;
             struct ASTNode *default_case;
+            // جداول الاختيار تبنى عند التحليل من التسميات الثابتة (رقم الحالة + 1، و 0 فارغ)
+            int *jump_table;            // جدول قفز كثيف للأعداد الصحيحة المتقاربة
+            int64_t jump_min;
+            int jump_size;
+            int *label_table;           // جدول تجزئة لبقية التسميات الثابتة (نصوص وأعداد متباعدة)
+            int label_capacity;
+            int *dynamic_cases;         // الحالات ذات التسميات غير الثابتة بترتيبها
+            int dynamic_count;
         } switch_stmt;
         struct {
             struct ASTNode *value;
@@ -585,6 +811,8 @@ typedef struct ASTNode {
         struct {
             struct ASTNode *object;
             char *property;
+            Shape *cache_shape;         // ذاكرة مؤقتة مضمنة: آخر شكل رؤي هنا
+            int cache_index;            // وموضع الخاصية فيه
         } property_access;
         struct {
             char *class_name;
@@ -600,6 +828,21 @@ typedef struct ASTNode {
             struct ASTNode *operand;
             bool is_prefix;
         } decrement;
+        struct {
+            char **keys;
+            struct ASTNode **values;
+            int count;
+        } object;
+        struct {
+            struct ASTNode **keys;
+            struct ASTNode **values;
+            int count;
+        } map;
+        struct {
+            struct ASTNode *target;     // عقدة AST_ARRAY_ACCESS أو AST_PROPERTY_ACCESS
+            struct ASTNode *value;
+            TokenType op;               // TOKEN_ASSIGN أو المعامل الحسابي للتعيين المركب
+        } place_assign;
     } as;
 } ASTNode;
 
@@ -619,6 +862,7 @@ typedef struct Environment {
     char *name;
     bool is_class_scope;
     bool is_function_scope;
+    unsigned int version;           // يزيد مع كل تعريف أو استبدال لدالة فيها
 } Environment;
 
 // الليكسر
@@ -640,8 +884,31 @@ typedef struct {
     char *error_message;
     int error_line;
     int error_column;
+    StructDef **structs;            // الهياكل المعرفة حتى الآن
+    int struct_count;
+    int struct_capacity;
+    char **functions;               // أسماء الدوال المعرفة (لاستدعائها دون أقواس)
+    int function_count;
+    int function_capacity;
+    bool saw_yield;                 // ظهرت 'أنتج' في جسم الدالة الجاري تحليلها
 } Parser;
 
+// حالة المكتبات الأصلية: يملكها المفسر فلا تتشارك المفسرات المستقلة شيئاً منها،
+// وكل مكتبة تنشئ حالتها عند أول استخدام وتحررها مع المفسر
+typedef struct AIState AIState;
+typedef struct StoreState StoreState;
+typedef struct GUIState GUIState;
+typedef struct TimeState TimeState;
+typedef struct EventLoop EventLoop;
+
+typedef struct {
+    AIState *ai;                    // العقول والأنظمة والشبكات
+    StoreState *store;              // المخازن
+    GUIState *gui;                  // النوافذ
+    TimeState *time;                // المؤقت وعلامات الوقت
+    EventLoop *loop;                // حلقة الأحداث ومهامها
+} LibraryContext;
+
 // المفسر
 typedef struct {
     Environment *global_env;
@@ -652,6 +919,10 @@ typedef struct {
     bool is_continuing;
     Value *exception;
     bool is_try_block;
+    bool is_worker;                 // عامل متواز: لا يكتب في الذواكر المؤقتة المشتركة بين الخيوط
+    bool is_isolated;               // عامل يملك نسخة خاصة من البيئة العامة (خيط مستقل أو مهمة شغّل)
+    LibraryContext libs;
+    FunctionMemo *memo_list;        // سجل ذواكر الدوال النقية (لمكتبة الميتا)
 } Interpreter;
 
 // دوال الليكسر
@@ -670,6 +941,15 @@ int parser_get_error_column(Parser *parser);
 
 // دوال المفسر
 Interpreter *interpreter_create(void);
+Interpreter *interpreter_create_worker(Interpreter *parent);
+Interpreter *interpreter_create_snapshot(Interpreter *parent);
+Interpreter *interpreter_create_isolated(Interpreter *parent);
+Value interpreter_run_isolated(Interpreter *isolated, Value *func, Value *args, int arg_count);
+Interpreter *interpreter_current(void);
+Value interpreter_call(Interpreter *interpreter, Value *func, Value *args, int arg_count);
+Value interpreter_await(Interpreter *interpreter, Value promise);
+LibraryContext *library_context(void);
+bool value_is_pure_function(Interpreter *interpreter, Value *func);
 void interpreter_destroy(Interpreter *interpreter);
 Value interpreter_evaluate(Interpreter *interpreter, ASTNode *node);
 void interpreter_run(Interpreter *interpreter, ASTNode *program);
@@ -678,7 +958,10 @@ Value *interpreter_get_variable(Interpreter *interpreter, const char *name);
 
 // دوال القيم
 Value value_create_number(double num);
+Value value_create_int(int64_t integer);
 Value value_create_string(const char *str);
+Value value_create_string_len(const char *str, size_t length);
+Value value_wrap_string(char *str);
 Value value_create_boolean(bool boolean);
 Value value_create_null(void);
 Value value_create_array(void);
@@ -687,12 +970,124 @@ Value value_create_function(const char *name, char **params, int param_count, AS
 Value value_create_class(const char *name, char **fields, int field_count);
 Value value_create_instance(Class *class_def);
 Value value_create_exception(const char *message, int code);
+Value value_create_struct(StructDef *def);
+Value value_create_map(void);
+Value value_create_set(void);
+Value value_create_vector(void);
+Value value_create_native(const char *name, Value (*native_fn)(Value *args, int arg_count));
+Value value_create_promise(void);
+Value value_create_range(int64_t start, int64_t stop, int64_t step);
+Value value_create_pipeline(Value source);
+Value pipeline_extend(Value *pipeline, PipelineStage stage, Value value, int64_t count);
+Value pipeline_collect(Value *pipeline);
+Value value_call(Value *func, Value *args, int arg_count);
 void value_free(Value *value);
 char *value_to_string(Value *value);
 bool value_is_truthy(Value *value);
 bool value_equals(Value *a, Value *b);
+unsigned int value_hash(Value *value);
+bool value_is_hashable(Value *value);
+bool value_is_sendable(Value *value);
+bool value_is_iterable(Value *value);
+bool value_iterate(Value *collection, int64_t *position, Value *out);
+void value_iterate_end(Value *collection, int64_t *position);
+bool value_is_number(Value *value);
+double value_as_number(Value *value);
 Value value_copy(Value *value);
 
+// ذاكرة نتائج الدوال النقية
+FunctionMemo *memo_registry(void);
+
+// دوال الكائنات
+Value *object_get(Value *object, const char *key);
+Value *object_set(Value *object, const char *key, Value value);
+int object_find(Value *object, const char *key);
+int shape_find(Shape *shape, const char *key);
+Shape *shape_root(void);
+Shape *shape_transition(Shape *shape, const char *key);
+
+// دوال المصفوفات (تراعي الفراغ قبل أول عنصر)
+void array_reserve(Value *array, int capacity);
+void array_append(Value *array, Value *item);
+void array_prepend(Value *array, Value *item);
+Value *array_remove_first(Value *array);
+
+// دوال المتجهات الدائمة
+Value *vector_get(Value *vector, int index);
+Value *vector_slot(Value *vector, int index);
+void vector_push(Value *vector, Value item);
+
+// دوال المدى (العنصر i هو start + i * step)
+int64_t range_length(Value *range);
+int64_t range_index_of(Value *range, Value *item);
+void range_materialize(Value *range);
+
+// دوال الخرائط
+Value *map_get(Value *map, Value *key);
+Value *map_set(Value *map, Value key, Value value);
+bool map_delete(Value *map, Value *key);
+
+// دوال المجموعات (العناصر يجب أن تكون قابلة للتجزئة)
+bool set_add(Value *set, Value item);
+bool set_has(Value *set, Value *item);
+bool set_remove(Value *set, Value *item);
+Value set_union(Value *a, Value *b);
+Value set_intersection(Value *a, Value *b);
+Value set_difference(Value *a, Value *b);
+
+// الوعود والمهام
+void promise_settle(Value *promise, Value value);
+void task_resume(Task *task);
+
+// حلقة الأحداث (epoll): تستأنف المهام الجاهزة وتنتظر المؤقتات والمقابس دون انشغال
+void event_loop_schedule(Task *task);
+bool event_loop_run_once(void);
+void event_loop_run(void);
+void event_loop_free(EventLoop *loop);
+
+// إكمال عملية تنفذ على خيط عامل: العامل يسلم الناتج، والحلقة تحقق الوعد في خيطها ثم تحرر السجل
+typedef struct Completion {
+    Value promise;                  // لا يمسه إلا خيط الحلقة
+    Value result;
+    EventLoop *loop;                // حلقة المفسر الذي بدأ العملية
+    struct Completion *next;
+} Completion;
+Completion *event_loop_expect(Value *promise);
+void event_loop_complete(Completion *completion, Value result);
+
+// المجدول المتوازي: خيوط عمل بطوابير Chase-Lev وسرقة المهام، تتشاركه كل العمليات المتوازية
+// المهمة التي لها parent تنفذ بمفسر عامل خاص بها يشارك بيئة المفسر العامة
+typedef void (*ParallelTaskFn)(Interpreter *worker, void *context);
+typedef void (*ParallelChunkFn)(Interpreter *worker, void *context, int chunk);
+int parallel_worker_count(void);
+bool parallel_set_worker_count(int count);
+int parallel_chunk_count(int64_t items);
+void parallel_spawn(Interpreter *parent, ParallelTaskFn run, void *context);
+bool parallel_help(void);
+void parallel_run(Interpreter *parent, int chunk_count, ParallelChunkFn run, void *context);
+
+// القنوات: تنقل القيم بين الخيوط دون نسخ، وتنتظر حين تمتلئ أو تفرغ
+Value value_create_channel(int capacity);
+void channel_retain(Channel *channel);
+void channel_release(Channel *channel);
+bool channel_next(Channel *channel, Value *out);
+
+// التجميد يمتلك القيمة ويعيدها مجمدة (الأعداد والنصوص تبقى كما هي)،
+// والإذابة تعيد من المجمدة نسخة عادية قابلة للتعديل
+Value value_freeze(Value value);
+Value value_thaw(Value value);
+
+// دوال النصوص
+char *string_new(const char *chars, size_t length);
+char *string_copy(const char *str);
+char *string_append(char *str, const char *chars, size_t length);
+void string_free(char *str);
+String *string_header(const char *str);
+size_t string_length(const char *str);
+int string_char_count(const char *str);
+size_t string_char_offset(const char *str, int char_index);
+unsigned int string_hash(const char *str);
+
 // دوال البيئة
 Environment *environment_create(Environment *parent, const char *name);
 void environment_destroy(Environment *env);
@@ -725,6 +1120,7 @@ Value lib_text_reverse(Value *args, int arg_count);
 Value lib_text_format(Value *args, int arg_count);
 
 // مكتبة الزمن
+void lib_time_state_free(TimeState *state);
 Value lib_time_now(Value *args, int arg_count);
 Value lib_time_format(Value *args, int arg_count);
 Value lib_time_sleep(Value *args, int arg_count);
@@ -771,6 +1167,7 @@ Value lib_math_fibonacci(Value *args, int arg_count);
 
 // مكتبة القوائم
 Value lib_list_create(Value *args, int arg_count);
+Value lib_list_add(Value *args, int arg_count);
 Value lib_list_push(Value *args, int arg_count);
 Value lib_list_pop(Value *args, int arg_count);
 Value lib_list_shift(Value *args, int arg_count);
@@ -796,6 +1193,73 @@ Value lib_list_some(Value *args, int arg_count);
 Value lib_list_flatten(Value *args, int arg_count);
 Value lib_list_unique(Value *args, int arg_count);
 Value lib_list_chunk(Value *args, int arg_count);
+Value lib_list_range(Value *args, int arg_count);
+Value lib_list_take(Value *args, int arg_count);
+Value lib_list_skip(Value *args, int arg_count);
+Value lib_list_lazy(Value *args, int arg_count);
+Value lib_list_collect(Value *args, int arg_count);
+
+// مكتبة العمليات المتوازية (للدوال النقية، وإلا تنفذ متسلسلة)
+Value lib_parallel_map(Value *args, int arg_count);
+Value lib_parallel_filter(Value *args, int arg_count);
+Value lib_parallel_reduce(Value *args, int arg_count);
+Value lib_parallel_spawn(Value *args, int arg_count);
+Value lib_parallel_join(Value *args, int arg_count);
+Value lib_parallel_set_workers(Value *args, int arg_count);
+Value lib_parallel_thread(Value *args, int arg_count);
+Value lib_parallel_freeze(Value *args, int arg_count);
+Value lib_parallel_is_frozen(Value *args, int arg_count);
+
+// مكتبة القنوات (أرسل واستقبل وأغلق تحول إليها حين يكون المعامل الأول قناة)
+Value lib_channel_create(Value *args, int arg_count);
+Value lib_channel_send(Value *args, int arg_count);
+Value lib_channel_receive(Value *args, int arg_count);
+Value lib_channel_close(Value *args, int arg_count);
+Value lib_channel_select(Value *args, int arg_count);
+
+// مكتبة الخرائط
+Value lib_map_create(Value *args, int arg_count);
+Value lib_map_get(Value *args, int arg_count);
+Value lib_map_set(Value *args, int arg_count);
+Value lib_map_delete(Value *args, int arg_count);
+Value lib_map_has(Value *args, int arg_count);
+Value lib_map_size(Value *args, int arg_count);
+Value lib_map_keys(Value *args, int arg_count);
+Value lib_map_values(Value *args, int arg_count);
+Value lib_map_entries(Value *args, int arg_count);
+Value lib_map_merge(Value *args, int arg_count);
+Value lib_map_count(Value *args, int arg_count);
+Value lib_map_group(Value *args, int arg_count);
+
+// مكتبة المجموعات
+Value lib_set_create(Value *args, int arg_count);
+Value lib_set_add(Value *args, int arg_count);
+Value lib_set_remove(Value *args, int arg_count);
+Value lib_set_has(Value *args, int arg_count);
+Value lib_set_size(Value *args, int arg_count);
+Value lib_set_to_array(Value *args, int arg_count);
+Value lib_set_union(Value *args, int arg_count);
+Value lib_set_intersection(Value *args, int arg_count);
+Value lib_set_difference(Value *args, int arg_count);
+Value lib_set_is_subset(Value *args, int arg_count);
+
+// مكتبة المتجهات الدائمة
+Value lib_vector_create(Value *args, int arg_count);
+Value lib_vector_get(Value *args, int arg_count);
+Value lib_vector_set(Value *args, int arg_count);
+Value lib_vector_push(Value *args, int arg_count);
+Value lib_vector_size(Value *args, int arg_count);
+Value lib_vector_to_array(Value *args, int arg_count);
+
+// مكتبة العمليات غير المتزامنة (تعيد وعوداً تحققها حلقة الأحداث)
+Value lib_async_sleep(Value *args, int arg_count);
+Value lib_async_read_file(Value *args, int arg_count);
+Value lib_async_listen(Value *args, int arg_count);
+Value lib_async_accept(Value *args, int arg_count);
+Value lib_async_connect(Value *args, int arg_count);
+Value lib_async_receive(Value *args, int arg_count);
+Value lib_async_send(Value *args, int arg_count);
+Value lib_async_close(Value *args, int arg_count);
 
 // مكتبة الملفات
 Value lib_file_read(Value *args, int arg_count);
@@ -870,6 +1334,7 @@ Value lib_system_home_dir(Value *args, int arg_count);
 
 // مكتبة المخزن
 void lib_store_init(void);
+void lib_store_state_free(StoreState *state);
 Value lib_store_create(Value *args, int arg_count);
 Value lib_store_add(Value *args, int arg_count);
 Value lib_store_read(Value *args, int arg_count);
@@ -881,6 +1346,7 @@ Value lib_store_load(Value *args, int arg_count);
 
 // مكتبة الذكاء
 void lib_ai_init(void);
+void lib_ai_state_free(AIState *state);
 Value lib_mind_create(Value *args, int arg_count);
 Value lib_mind_learn(Value *args, int arg_count);
 Value lib_mind_ask(Value *args, int arg_count);
@@ -911,6 +1377,7 @@ Value lib_media_get_info(Value *args, int arg_count);
 Value lib_media_resize_image(Value *args, int arg_count);
 
 // مكتبة الواجهات
+void lib_gui_state_free(GUIState *state);
 Value lib_gui_create_window(Value *args, int arg_count);
 Value lib_gui_add_button(Value *args, int arg_count);
 Value lib_gui_add_label(Value *args, int arg_count);
@@ -968,6 +1435,7 @@ Value lib_meta_memory_usage(Value *args, int arg_count);
 Value lib_meta_gc(Value *args, int arg_count);
 Value lib_meta_call_stack(Value *args, int arg_count);
 Value lib_meta_loaded_modules(Value *args, int arg_count);
+Value lib_meta_memo_stats(Value *args, int arg_count);
 
 // دوال مساعدة
 char *utf8_strdup(const char *src);
@@ -3,6 +3,125 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <inttypes.h>
+#include <ucontext.h>
+#include <pthread.h>
+#include <sys/mman.h>
+
+// عدادات المراجع المشتركة ذرية: العمال المتوازيون قد ينسخون القيمة نفسها ويحررونها معاً
+#define REF_RETAIN(count) __atomic_add_fetch(&(count), 1, __ATOMIC_RELAXED)
+#define REF_RELEASE(count) __atomic_sub_fetch(&(count), 1, __ATOMIC_ACQ_REL)
+
+// الحصول على ترويسة النص من مؤشر محارفه
+String *string_header(const char *str) {
+    return (String *)(str - offsetof(String, chars));
+}
+
+// إنشاء نص جديد بطول معروف (chars قد يكون NULL لحجز مساحة فقط)
+char *string_new(const char *chars, size_t length) {
+    String *s = malloc(sizeof(String) + length + 1);
+    s->length = length;
+    s->capacity = length;
+    s->char_count = -1;
+    s->hash = 0;
+    s->has_hash = false;
+    if (chars) memcpy(s->chars, chars, length);
+    s->chars[length] = '\0';
+    return s->chars;
+}
+
+// نسخ نص مع القيم المخزنة في ترويسته
+char *string_copy(const char *str) {
+    String *src = string_header(str);
+    char *copy = string_new(str, src->length);
+    String *dst = string_header(copy);
+    dst->char_count = src->char_count;
+    dst->hash = src->hash;
+    dst->has_hash = src->has_hash;
+    return copy;
+}
+
+// إلحاق محارف بنهاية نص مع سعة احتياطية (قد يتغير المؤشر المعاد)
+char *string_append(char *str, const char *chars, size_t length) {
+    String *s = string_header(str);
+    size_t needed = s->length + length;
+    
+    if (needed > s->capacity) {
+        // مضاعفة السعة تجعل الإلحاق المتكرر بتكلفة ثابتة مطفأة
+        size_t capacity = s->capacity * 2;
+        if (capacity < needed) capacity = needed;
+        if (capacity < 16) capacity = 16;
+        s = realloc(s, sizeof(String) + capacity + 1);
+        s->capacity = capacity;
+    }
+    
+    memcpy(s->chars + s->length, chars, length);
+    if (s->char_count >= 0) {
+        for (size_t i = 0; i < length; i++) {
+            if (((unsigned char)chars[i] & 0xC0) != 0x80) s->char_count++;
+        }
+    }
+    s->length = needed;
+    s->chars[needed] = '\0';
+    s->has_hash = false;
+    return s->chars;
+}
+
+// تحرير نص
+void string_free(char *str) {
+    if (str) free(string_header(str));
+}
+
+// طول النص بالبايت
+size_t string_length(const char *str) {
+    return string_header(str)->length;
+}
+
+// عدد محارف UTF-8 (يحسب مرة واحدة ثم يخزن)
+int string_char_count(const char *str) {
+    String *s = string_header(str);
+    if (s->char_count < 0) {
+        int count = 0;
+        for (size_t i = 0; i < s->length; i++) {
+            if (((unsigned char)s->chars[i] & 0xC0) != 0x80) count++;
+        }
+        s->char_count = count;
+    }
+    return s->char_count;
+}
+
+// موضع المحرف رقم char_index بالبايت
+size_t string_char_offset(const char *str, int char_index) {
+    String *s = string_header(str);
+    if (char_index <= 0) return 0;
+    // نص ASCII: كل محرف بايت واحد
+    if (string_char_count(str) == (int)s->length) {
+        return (size_t)char_index < s->length ? (size_t)char_index : s->length;
+    }
+    int count = 0;
+    for (size_t i = 0; i < s->length; i++) {
+        if (((unsigned char)s->chars[i] & 0xC0) != 0x80) {
+            if (count == char_index) return i;
+            count++;
+        }
+    }
+    return s->length;
+}
+
+// تجزئة النص (FNV-1a) مع تخزينها في الترويسة
+unsigned int string_hash(const char *str) {
+    String *s = string_header(str);
+    if (!s->has_hash) {
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < s->length; i++) {
+            hash ^= (unsigned char)s->chars[i];
+            hash *= 16777619u;
+        }
+        s->hash = hash;
+        s->has_hash = true;
+    }
+    return s->hash;
+}
 
 // إنشاء قيمة رقمية
 Value value_create_number(double num) {
@@ -12,11 +131,32 @@ Value value_create_number(double num) {
     return v;
 }
 
+// إنشاء قيمة عددية صحيحة
+Value value_create_int(int64_t integer) {
+    Value v;
+    v.type = VAL_INT;
+    v.as.integer = integer;
+    return v;
+}
+
 // إنشاء قيمة نصية
 Value value_create_string(const char *str) {
+    return value_create_string_len(str, strlen(str));
+}
+
+// إنشاء قيمة نصية بطول معروف
+Value value_create_string_len(const char *str, size_t length) {
+    Value v;
+    v.type = VAL_STRING;
+    v.as.string = string_new(str, length);
+    return v;
+}
+
+// تغليف نص منشأ بـ string_new في قيمة دون نسخه
+Value value_wrap_string(char *str) {
     Value v;
     v.type = VAL_STRING;
-    v.as.string = strdup(str);
+    v.as.string = str;
     return v;
 }
 
@@ -42,20 +182,674 @@ Value value_create_array(void) {
     v.as.array.items = malloc(sizeof(Value*) * 10);
     v.as.array.count = 0;
     v.as.array.capacity = 10;
+    v.as.array.offset = 0;
     return v;
 }
 
+// ضمان سعة من items فصاعداً، مع استعادة الفراغ الأمامي إن كان يكفي
+// (نقل العناصر إليه لا يكلف أكثر من عدد الحذوفات من البداية التي صنعته)
+void array_reserve(Value *array, int capacity) {
+    if (capacity <= array->as.array.capacity) return;
+    
+    int offset = array->as.array.offset;
+    Value **base = array->as.array.items - offset;
+    if (offset >= array->as.array.count && offset + array->as.array.capacity >= capacity) {
+        memmove(base, array->as.array.items, sizeof(Value*) * array->as.array.count);
+        array->as.array.items = base;
+        array->as.array.capacity += offset;
+        array->as.array.offset = 0;
+        return;
+    }
+    
+    int new_capacity = array->as.array.capacity * 2;
+    if (new_capacity < capacity) new_capacity = capacity;
+    base = realloc(base, sizeof(Value*) * (offset + new_capacity));
+    array->as.array.items = base + offset;
+    array->as.array.capacity = new_capacity;
+}
+
+// إضافة عنصر في النهاية (تمتلك المصفوفة العنصر)
+void array_append(Value *array, Value *item) {
+    array_reserve(array, array->as.array.count + 1);
+    array->as.array.items[array->as.array.count++] = item;
+}
+
+// إضافة عنصر في البداية: O(1) مطفأة، فالفراغ الأمامي عند نفاده يحجز بقدر العناصر
+void array_prepend(Value *array, Value *item) {
+    if (array->as.array.offset == 0) {
+        int gap = array->as.array.count > 4 ? array->as.array.count : 4;
+        Value **base = malloc(sizeof(Value*) * (gap + array->as.array.capacity));
+        memcpy(base + gap, array->as.array.items, sizeof(Value*) * array->as.array.count);
+        free(array->as.array.items);
+        array->as.array.items = base + gap;
+        array->as.array.offset = gap;
+    }
+    
+    array->as.array.items--;
+    array->as.array.offset--;
+    array->as.array.capacity++;
+    array->as.array.items[0] = item;
+    array->as.array.count++;
+}
+
+// حذف أول عنصر وإعادته للمستدعي (NULL للفارغة) دون نقل الباقي
+Value *array_remove_first(Value *array) {
+    if (array->as.array.count == 0) return NULL;
+    
+    Value *item = array->as.array.items[0];
+    array->as.array.items++;
+    array->as.array.offset++;
+    array->as.array.capacity--;
+    array->as.array.count--;
+    
+    // المصفوفة الفارغة تعود إلى بداية حجزها
+    if (array->as.array.count == 0) {
+        array->as.array.items -= array->as.array.offset;
+        array->as.array.capacity += array->as.array.offset;
+        array->as.array.offset = 0;
+    }
+    return item;
+}
+
 // إنشاء كائن
 Value value_create_object(void) {
     Value v;
     v.type = VAL_OBJECT;
-    v.as.object.keys = malloc(sizeof(char*) * 10);
+    v.as.object.shape = shape_root();
+    v.as.object.keys = v.as.object.shape->keys;
     v.as.object.values = malloc(sizeof(Value*) * 10);
     v.as.object.count = 0;
     v.as.object.capacity = 10;
+    v.as.object.index = NULL;
+    v.as.object.index_capacity = 0;
+    v.as.object.indexed_count = 0;
+    return v;
+}
+
+// إنشاء دالة معرفة في البرنامج (الاسم والمعاملات والجسم تبقى ملكاً لشجرة النحو)
+Value value_create_function(const char *name, char **params, int param_count, ASTNode *body) {
+    Value v;
+    v.type = VAL_FUNCTION;
+    v.as.function.name = (char *)name;
+    v.as.function.params = params;
+    v.as.function.param_count = param_count;
+    v.as.function.body = body;
+    v.as.function.closure = NULL;
+    v.as.function.is_native = false;
+    v.as.function.native_fn = NULL;
+    v.as.function.memo = NULL;
+    v.as.function.is_async = false;
+    v.as.function.shares_frozen = false;
+    return v;
+}
+
+// إنشاء دالة أصلية تستدعى من البرنامج (تعيد قيمة جديدة لا تشارك المعاملات)
+Value value_create_native(const char *name, Value (*native_fn)(Value *args, int arg_count)) {
+    Value v = value_create_function(name, NULL, 0, NULL);
+    v.as.function.is_native = true;
+    v.as.function.native_fn = native_fn;
+    return v;
+}
+
+// دالة أصلية تنقل القيم بين الخيوط: تأخذ المجمدة كما هي فلا تنسخ ما تنقله
+static Value native_sharing_frozen(const char *name, Value (*native_fn)(Value *args, int arg_count)) {
+    Value v = value_create_native(name, native_fn);
+    v.as.function.shares_frozen = true;
+    return v;
+}
+
+// إنشاء صنف بحقوله وجدول دوال فارغ (الأصناف لا تحرر)
+Value value_create_class(const char *name, char **fields, int field_count) {
+    Class *cls = malloc(sizeof(Class));
+    cls->name = strdup(name);
+    cls->fields = malloc(sizeof(char*) * (field_count ? field_count : 1));
+    for (int i = 0; i < field_count; i++) {
+        cls->fields[i] = strdup(fields[i]);
+    }
+    cls->field_count = field_count;
+    cls->method_shape = shape_root();
+    cls->vtable = NULL;
+    cls->method_count = 0;
+    cls->parent = NULL;
+    cls->is_abstract = false;
+    
+    Value v;
+    v.type = VAL_CLASS_DEF;
+    v.as.class_def.def = cls;
+    return v;
+}
+
+// إنشاء نسخة من صنف: الحقول المعلنة فارغة وبترتيب ثابت فتتشارك النسخ شكلها
+Value value_create_instance(Class *class_def) {
+    Object *instance = malloc(sizeof(Object));
+    instance->class_def = class_def;
+    instance->fields = value_create_object();
+    instance->refcount = 1;
+    for (int i = 0; i < class_def->field_count; i++) {
+        object_set(&instance->fields, class_def->fields[i], value_create_null());
+    }
+    
+    Value v;
+    v.type = VAL_INSTANCE;
+    v.as.instance.class_def = class_def;
+    v.as.instance.instance = instance;
+    return v;
+}
+
+// إنشاء نسخة هيكل: كتلة واحدة تضم الترويسة وكل الحقول (فارغة مبدئياً)
+Value value_create_struct(StructDef *def) {
+    int count = def->shape->count;
+    StructInstance *instance = malloc(sizeof(StructInstance) + sizeof(Value) * count);
+    instance->def = def;
+    for (int i = 0; i < count; i++) {
+        instance->fields[i] = value_create_null();
+    }
+    
+    Value v;
+    v.type = VAL_STRUCT;
+    v.as.structure = instance;
+    return v;
+}
+
+// إنشاء خريطة فارغة (يحجز الجدول عند أول إضافة)
+Value value_create_map(void) {
+    Value v;
+    v.type = VAL_MAP;
+    v.as.map = calloc(1, sizeof(Map));
+    return v;
+}
+
+// موضع مفتاح في الخريطة، أو -1 إن لم يوجد
+// ترتيب روبن هود يوقف البحث عند أول مدخل أقرب إلى خانته منا
+static int map_find(Map *map, Value *key, unsigned int hash) {
+    if (map->count == 0) return -1;
+    
+    unsigned int mask = (unsigned int)map->capacity - 1;
+    unsigned int slot = hash & mask;
+    for (int distance = 0; ; distance++) {
+        MapEntry *entry = &map->entries[slot];
+        if (entry->distance < distance) return -1;
+        if (entry->hash == hash && value_equals(&entry->key, key)) return (int)slot;
+        slot = (slot + 1) & mask;
+    }
+}
+
+// وضع مدخل جديد (مفتاحه غير موجود) في الجدول مع إزاحة الأقرب إلى خانته
+static void map_place(Map *map, MapEntry entry) {
+    unsigned int mask = (unsigned int)map->capacity - 1;
+    unsigned int slot = entry.hash & mask;
+    entry.distance = 0;
+    
+    for (;;) {
+        MapEntry *current = &map->entries[slot];
+        if (current->distance < 0) {
+            *current = entry;
+            map->count++;
+            return;
+        }
+        if (current->distance < entry.distance) {
+            MapEntry displaced = *current;
+            *current = entry;
+            entry = displaced;
+        }
+        slot = (slot + 1) & mask;
+        entry.distance++;
+    }
+}
+
+// مضاعفة الجدول وإعادة وضع المدخلات (القيم لا تنقل فتبقى عناوينها صالحة)
+static void map_grow(Map *map) {
+    MapEntry *old = map->entries;
+    int old_capacity = map->capacity;
+    
+    map->capacity = old_capacity ? old_capacity * 2 : MAP_MIN_CAPACITY;
+    map->entries = malloc(sizeof(MapEntry) * map->capacity);
+    for (int i = 0; i < map->capacity; i++) {
+        map->entries[i].distance = -1;
+    }
+    map->count = 0;
+    
+    for (int i = 0; i < old_capacity; i++) {
+        if (old[i].distance >= 0) map_place(map, old[i]);
+    }
+    free(old);
+}
+
+// قيمة مفتاح في الخريطة، أو NULL إن لم يوجد
+Value *map_get(Value *map, Value *key) {
+    int i = map_find(map->as.map, key, value_hash(key));
+    return i < 0 ? NULL : map->as.map->entries[i].value;
+}
+
+// تعيين قيمة مفتاح (تمتلك الخريطة المفتاح والقيمة) وإعادة خانة القيمة
+Value *map_set(Value *map, Value key, Value value) {
+    Map *m = map->as.map;
+    unsigned int hash = value_hash(&key);
+    
+    int i = map_find(m, &key, hash);
+    if (i >= 0) {
+        value_free(&key);
+        value_free(m->entries[i].value);
+        *m->entries[i].value = value;
+        return m->entries[i].value;
+    }
+    
+    // نسبة امتلاء حتى 80%: سلاسل روبن هود تبقى قصيرة عندها
+    if ((m->count + 1) * 5 > m->capacity * 4) {
+        map_grow(m);
+    }
+    
+    MapEntry entry;
+    entry.key = key;
+    entry.value = malloc(sizeof(Value));
+    *entry.value = value;
+    entry.hash = hash;
+    map_place(m, entry);
+    return entry.value;
+}
+
+// حذف مفتاح: تزاح المدخلات التالية خانة للخلف حتى مدخل في خانته الأصلية
+bool map_delete(Value *map, Value *key) {
+    Map *m = map->as.map;
+    int i = map_find(m, key, value_hash(key));
+    if (i < 0) return false;
+    
+    value_free(&m->entries[i].key);
+    value_free(m->entries[i].value);
+    free(m->entries[i].value);
+    
+    unsigned int mask = (unsigned int)m->capacity - 1;
+    unsigned int slot = (unsigned int)i;
+    unsigned int next = (slot + 1) & mask;
+    while (m->entries[next].distance > 0) {
+        m->entries[slot] = m->entries[next];
+        m->entries[slot].distance--;
+        slot = next;
+        next = (next + 1) & mask;
+    }
+    m->entries[slot].distance = -1;
+    m->count--;
+    return true;
+}
+
+// إنشاء مجموعة فارغة
+Value value_create_set(void) {
+    Value v;
+    v.type = VAL_SET;
+    v.as.set = calloc(1, sizeof(Set));
+    return v;
+}
+
+// موضع عنصر في المجموعة، أو -1 إن لم يوجد
+// الصغيرة: مسح مصفوفة التجزئات المتصلة ولا تقارن القيم إلا عند تطابق التجزئة
+static int set_find(Set *set, Value *item, unsigned int hash) {
+    if (!set->index) {
+        for (int i = 0; i < set->count; i++) {
+            if (set->hashes[i] == hash && value_equals(&set->items[i], item)) return i;
+        }
+        return -1;
+    }
+    
+    unsigned int mask = (unsigned int)set->index_capacity - 1;
+    unsigned int slot = hash & mask;
+    while (set->index[slot] != 0) {
+        int i = set->index[slot] - 1;
+        if (set->hashes[i] == hash && value_equals(&set->items[i], item)) return i;
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// إضافة موضع عنصر إلى الفهرس (السبر الخطي)
+static void set_index_insert(Set *set, int entry) {
+    unsigned int mask = (unsigned int)set->index_capacity - 1;
+    unsigned int slot = set->hashes[entry] & mask;
+    while (set->index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    set->index[slot] = entry + 1;
+}
+
+// بناء الفهرس بسعة تبقي نسبة الامتلاء دون النصف
+static void set_index_rebuild(Set *set) {
+    int capacity = 32;
+    while (capacity < set->capacity * 2) capacity *= 2;
+    free(set->index);
+    set->index = calloc(capacity, sizeof(int));
+    set->index_capacity = capacity;
+    for (int i = 0; i < set->count; i++) {
+        set_index_insert(set, i);
+    }
+}
+
+// إلحاق عنصر غير موجود تعرف تجزئته (تمتلك المجموعة العنصر)
+static void set_append(Set *set, Value item, unsigned int hash) {
+    if (set->count >= set->capacity) {
+        set->capacity = set->capacity ? set->capacity * 2 : 8;
+        set->items = realloc(set->items, sizeof(Value) * set->capacity);
+        set->hashes = realloc(set->hashes, sizeof(unsigned int) * set->capacity);
+    }
+    
+    set->items[set->count] = item;
+    set->hashes[set->count] = hash;
+    set->count++;
+    if (set->index && set->index_capacity >= set->capacity * 2) {
+        set_index_insert(set, set->count - 1);
+    } else if (set->index || set->count > SET_SMALL_MAX) {
+        set_index_rebuild(set);
+    }
+}
+
+// إضافة عنصر، وتعيد false (وتحرر العنصر) إن كان موجوداً
+bool set_add(Value *set, Value item) {
+    unsigned int hash = value_hash(&item);
+    if (set_find(set->as.set, &item, hash) >= 0) {
+        value_free(&item);
+        return false;
+    }
+    set_append(set->as.set, item, hash);
+    return true;
+}
+
+// هل العنصر في المجموعة؟
+bool set_has(Value *set, Value *item) {
+    return set_find(set->as.set, item, value_hash(item)) >= 0;
+}
+
+// حذف عنصر: يحل آخر عنصر محله فتبقى العناصر متصلة
+bool set_remove(Value *set, Value *item) {
+    Set *s = set->as.set;
+    int i = set_find(s, item, value_hash(item));
+    if (i < 0) return false;
+    
+    int last = s->count - 1;
+    if (s->index) {
+        unsigned int mask = (unsigned int)s->index_capacity - 1;
+        
+        // حذف خانة i بالإزاحة للخلف: يعود كل مدخل لاحق لا تقع خانته الأصلية بين الفراغ وموضعه
+        unsigned int slot = s->hashes[i] & mask;
+        while (s->index[slot] != i + 1) slot = (slot + 1) & mask;
+        unsigned int next = (slot + 1) & mask;
+        while (s->index[next] != 0) {
+            unsigned int home = s->hashes[s->index[next] - 1] & mask;
+            if (((next - home) & mask) >= ((next - slot) & mask)) {
+                s->index[slot] = s->index[next];
+                slot = next;
+            }
+            next = (next + 1) & mask;
+        }
+        s->index[slot] = 0;
+        
+        // توجيه خانة آخر عنصر إلى موضعه الجديد
+        if (last != i) {
+            slot = s->hashes[last] & mask;
+            while (s->index[slot] != last + 1) slot = (slot + 1) & mask;
+            s->index[slot] = i + 1;
+        }
+    }
+    
+    value_free(&s->items[i]);
+    s->items[i] = s->items[last];
+    s->hashes[i] = s->hashes[last];
+    s->count--;
+    return true;
+}
+
+// الاتحاد: نسخة من الأولى مع ما ليس فيها من الثانية (التجزئات لا يعاد حسابها)
+Value set_union(Value *a, Value *b) {
+    Value result = value_copy(a);
+    Set *sb = b->as.set;
+    for (int i = 0; i < sb->count; i++) {
+        if (set_find(result.as.set, &sb->items[i], sb->hashes[i]) < 0) {
+            set_append(result.as.set, value_copy(&sb->items[i]), sb->hashes[i]);
+        }
+    }
+    return result;
+}
+
+// التقاطع: المرور على الأصغر والبحث في الأكبر، بترتيب الأولى إن كانت الأصغر
+Value set_intersection(Value *a, Value *b) {
+    Set *small = a->as.set->count <= b->as.set->count ? a->as.set : b->as.set;
+    Set *large = small == a->as.set ? b->as.set : a->as.set;
+    Value result = value_create_set();
+    for (int i = 0; i < small->count; i++) {
+        if (set_find(large, &small->items[i], small->hashes[i]) >= 0) {
+            set_append(result.as.set, value_copy(&small->items[i]), small->hashes[i]);
+        }
+    }
+    return result;
+}
+
+// الفرق: عناصر الأولى التي ليست في الثانية
+Value set_difference(Value *a, Value *b) {
+    Set *sa = a->as.set;
+    Value result = value_create_set();
+    for (int i = 0; i < sa->count; i++) {
+        if (set_find(b->as.set, &sa->items[i], sa->hashes[i]) < 0) {
+            set_append(result.as.set, value_copy(&sa->items[i]), sa->hashes[i]);
+        }
+    }
+    return result;
+}
+
+// إنشاء عقدة متجه: الأوراق تحمل القيم، والداخلية تحمل مؤشرات العقد فقط
+// (تحجز الداخلية بحجم العقدة كاملاً: الوصول إليها كـ VectorNode يتجاوز حجزاً أصغر،
+// وهي جزء من 32 من الأوراق فلا يكاد يزيد الحجز)
+static VectorNode *vector_node_new(bool leaf) {
+    VectorNode *node;
+    if (leaf) {
+        node = malloc(sizeof(VectorNode));
+        for (int i = 0; i < VECTOR_WIDTH; i++) {
+            node->as.values[i] = value_create_null();
+        }
+    } else {
+        node = calloc(1, sizeof(VectorNode));
+    }
+    node->refcount = 1;
+    return node;
+}
+
+// تحرير مرجع إلى عقدة، والعقدة نفسها مع أبنائها عند آخر مرجع
+static void vector_node_release(VectorNode *node, int shift) {
+    if (!node || REF_RELEASE(node->refcount) > 0) return;
+    
+    for (int i = 0; i < VECTOR_WIDTH; i++) {
+        if (shift == 0) {
+            value_free(&node->as.values[i]);
+        } else {
+            vector_node_release(node->as.children[i], shift - VECTOR_BITS);
+        }
+    }
+    free(node);
+}
+
+// عقدة يملكها المستدعي وحده: المشتركة تنسخ نسخة سطحية (الأبناء يبقون مشتركين)
+static VectorNode *vector_node_unique(VectorNode *node, int shift) {
+    if (__atomic_load_n(&node->refcount, __ATOMIC_ACQUIRE) == 1) return node;
+    
+    VectorNode *copy = vector_node_new(shift == 0);
+    for (int i = 0; i < VECTOR_WIDTH; i++) {
+        if (shift == 0) {
+            copy->as.values[i] = value_copy(&node->as.values[i]);
+        } else {
+            copy->as.children[i] = node->as.children[i];
+            if (copy->as.children[i]) REF_RETAIN(copy->as.children[i]->refcount);
+        }
+    }
+    vector_node_release(node, shift);
+    return copy;
+}
+
+// إنشاء متجه دائم فارغ
+Value value_create_vector(void) {
+    Value v;
+    v.type = VAL_VECTOR;
+    v.as.vector.root = vector_node_new(true);
+    v.as.vector.count = 0;
+    v.as.vector.shift = 0;
+    return v;
+}
+
+// خانة عنصر للقراءة فقط، أو NULL خارج النطاق
+Value *vector_get(Value *vector, int index) {
+    if (index < 0 || index >= vector->as.vector.count) return NULL;
+    
+    VectorNode *node = vector->as.vector.root;
+    for (int shift = vector->as.vector.shift; shift > 0; shift -= VECTOR_BITS) {
+        node = node->as.children[(index >> shift) & (VECTOR_WIDTH - 1)];
+    }
+    return &node->as.values[index & (VECTOR_WIDTH - 1)];
+}
+
+// خانة عنصر للكتابة: تنسخ العقد المشتركة على المسار فقط فلا تتأثر النسخ الأخرى
+// (index يصح حتى count، فتنشأ العقد الناقصة للإضافة في النهاية)
+Value *vector_slot(Value *vector, int index) {
+    if (index < 0 || index > vector->as.vector.count) return NULL;
+    
+    VectorNode **ref = &vector->as.vector.root;
+    for (int shift = vector->as.vector.shift; shift > 0; shift -= VECTOR_BITS) {
+        *ref = vector_node_unique(*ref, shift);
+        ref = &(*ref)->as.children[(index >> shift) & (VECTOR_WIDTH - 1)];
+        if (!*ref) *ref = vector_node_new(shift == VECTOR_BITS);
+    }
+    *ref = vector_node_unique(*ref, 0);
+    return &(*ref)->as.values[index & (VECTOR_WIDTH - 1)];
+}
+
+// إضافة عنصر في النهاية (يمتلك المتجه العنصر)، مع رفع الجذر مستوى عند الامتلاء
+void vector_push(Value *vector, Value item) {
+    int count = vector->as.vector.count;
+    if (count == (1 << (vector->as.vector.shift + VECTOR_BITS))) {
+        VectorNode *root = vector_node_new(false);
+        root->as.children[0] = vector->as.vector.root;
+        vector->as.vector.root = root;
+        vector->as.vector.shift += VECTOR_BITS;
+    }
+    
+    Value *slot = vector_slot(vector, count);
+    value_free(slot);
+    *slot = item;
+    vector->as.vector.count++;
+}
+
+// إنشاء مدى عددي: لا تحجز عناصره، وطوله وعناصره تحسب من حدوده
+Value value_create_range(int64_t start, int64_t stop, int64_t step) {
+    Value v;
+    v.type = VAL_RANGE;
+    v.as.range.start = start;
+    v.as.range.stop = stop;
+    v.as.range.step = step;
+    return v;
+}
+
+// عدد عناصر المدى في O(1)
+int64_t range_length(Value *range) {
+    int64_t start = range->as.range.start;
+    int64_t stop = range->as.range.stop;
+    int64_t step = range->as.range.step;
+    if (step > 0) return start < stop ? (stop - start + step - 1) / step : 0;
+    return start > stop ? (start - stop - step - 1) / -step : 0;
+}
+
+// موضع عدد في المدى في O(1)، أو -1 إن لم يكن فيه
+int64_t range_index_of(Value *range, Value *item) {
+    if (!value_is_number(item)) return -1;
+    double number = value_as_number(item);
+    if (number != (double)(int64_t)number) return -1;
+    
+    int64_t offset = (int64_t)number - range->as.range.start;
+    if (offset % range->as.range.step != 0) return -1;
+    int64_t index = offset / range->as.range.step;
+    return index >= 0 && index < range_length(range) ? index : -1;
+}
+
+// تحويل المدى في مكانه إلى مصفوفة، قبل أول تعديل عليه
+void range_materialize(Value *range) {
+    if (range->type != VAL_RANGE) return;
+    
+    int64_t length = range_length(range);
+    Value array = value_create_array();
+    array_reserve(&array, (int)length);
+    for (int64_t i = 0; i < length; i++) {
+        Value *item = malloc(sizeof(Value));
+        *item = value_create_int(range->as.range.start + i * range->as.range.step);
+        array_append(&array, item);
+    }
+    *range = array;
+}
+
+// بداية سلسلة كسولة فوق مصدر تملكه (مصفوفة، مدى، مولد، ...)
+Value value_create_pipeline(Value source) {
+    Pipeline *pipeline = malloc(sizeof(Pipeline));
+    pipeline->refcount = 1;
+    pipeline->stage = STAGE_SOURCE;
+    pipeline->value = source;
+    pipeline->count = 0;
+    pipeline->depth = 0;
+    pipeline->parent = NULL;
+    
+    Value v;
+    v.type = VAL_PIPELINE;
+    v.as.pipeline = pipeline;
+    return v;
+}
+
+// سلسلة جديدة بمرحلة إضافية (تملك value) تشارك مراحل الأصل دون نسخها
+Value pipeline_extend(Value *pipeline, PipelineStage stage, Value value, int64_t count) {
+    Pipeline *parent = pipeline->as.pipeline;
+    REF_RETAIN(parent->refcount);
+    
+    Value v = value_create_pipeline(value);
+    v.as.pipeline->stage = stage;
+    v.as.pipeline->count = count;
+    v.as.pipeline->depth = parent->depth + 1;
+    v.as.pipeline->parent = parent;
+    return v;
+}
+
+// تحرير مرجع إلى مرحلة، والمراحل السابقة التي لم يعد يشاركها أحد
+static void pipeline_release(Pipeline *pipeline) {
+    while (pipeline && REF_RELEASE(pipeline->refcount) == 0) {
+        Pipeline *parent = pipeline->parent;
+        value_free(&pipeline->value);
+        free(pipeline);
+        pipeline = parent;
+    }
+}
+
+// إنشاء وعد معلق
+Value value_create_promise(void) {
+    Value v;
+    v.type = VAL_PROMISE;
+    v.as.promise = malloc(sizeof(Promise));
+    v.as.promise->refcount = 1;
+    v.as.promise->resolved = false;
+    v.as.promise->value = value_create_null();
+    v.as.promise->waiters = NULL;
+    v.as.promise->waiter_count = 0;
+    v.as.promise->waiter_capacity = 0;
     return v;
 }
 
+// تحقيق وعد بقيمة (يملكها الوعد)، أو رفضه باستثناء، وجدولة المهام المعلقة عليه
+void promise_settle(Value *promise, Value value) {
+    Promise *p = promise->as.promise;
+    if (p->resolved) {
+        value_free(&value);
+        return;
+    }
+    
+    p->resolved = true;
+    p->value = value;
+    for (int i = 0; i < p->waiter_count; i++) {
+        event_loop_schedule(p->waiters[i]);
+    }
+    free(p->waiters);
+    p->waiters = NULL;
+    p->waiter_count = 0;
+    p->waiter_capacity = 0;
+}
+
 // إنشاء استثناء
 Value value_create_exception(const char *message, int code) {
     Value v;
@@ -66,29 +860,119 @@ Value value_create_exception(const char *message, int code) {
     return v;
 }
 
+// المهمة: استدعاء دالة غير متزامنة على مكدس خاص، فيعلق 'انتظر' الإطار كاملاً
+// ويستأنف من الموضع نفسه حين يتحقق الوعد
+// والمولد مهمة أيضاً: يعلق عند كل 'أنتج' ويستأنفه من يطلب العنصر التالي
+struct Task {
+    ucontext_t context;
+    ucontext_t caller;              // من استأنف المهمة آخر مرة، وإليه تعود عند التعليق
+    char *stack;
+    Interpreter *interp;
+    Value func;
+    Value *args;                    // تملكها الدالة عند بدئها
+    int arg_count;
+    Value promise;                  // وعد نتيجة الدالة
+    Environment *env;               // بيئة المهمة أثناء تعليقها
+    bool is_try_block;
+    bool started;
+    bool done;
+    bool is_generator;
+    int refcount;                   // للمولد: عدد قيم المكرر التي تشاركه
+    Value yielded;                  // آخر قيمة أنتجها المولد ولم تسلم بعد
+    bool has_yielded;
+    bool closing;                   // تحرير مولد لم ينته: 'أنتج' تعيد استثناء فيتفكك إطاره
+};
+
+static void generator_release(Task *task);
+
 // تحرير قيمة
 void value_free(Value *value) {
     if (!value) return;
     
     switch (value->type) {
         case VAL_STRING:
-            free(value->as.string);
+            string_free(value->as.string);
             break;
         case VAL_ARRAY:
             for (int i = 0; i < value->as.array.count; i++) {
                 value_free(value->as.array.items[i]);
                 free(value->as.array.items[i]);
             }
-            free(value->as.array.items);
+            free(value->as.array.items - value->as.array.offset);
             break;
         case VAL_OBJECT:
             for (int i = 0; i < value->as.object.count; i++) {
-                free(value->as.object.keys[i]);
                 value_free(value->as.object.values[i]);
                 free(value->as.object.values[i]);
             }
-            free(value->as.object.keys);
+            // مفاتيح الشكل مشتركة، ولا يملك الكائن مفاتيحه إلا في وضع القاموس
+            if (!value->as.object.shape) {
+                for (int i = 0; i < value->as.object.count; i++) {
+                    free(value->as.object.keys[i]);
+                }
+                free(value->as.object.keys);
+            }
             free(value->as.object.values);
+            free(value->as.object.index);
+            break;
+        case VAL_STRUCT:
+            for (int i = 0; i < value->as.structure->def->shape->count; i++) {
+                value_free(&value->as.structure->fields[i]);
+            }
+            free(value->as.structure);
+            break;
+        case VAL_INSTANCE:
+            if (REF_RELEASE(value->as.instance.instance->refcount) == 0) {
+                value_free(&value->as.instance.instance->fields);
+                free(value->as.instance.instance);
+            }
+            break;
+        case VAL_PROMISE:
+            // المهام المعلقة تملك نسخاً منه، فلا يحرر وفيه منتظرون
+            if (--value->as.promise->refcount == 0) {
+                value_free(&value->as.promise->value);
+                free(value->as.promise->waiters);
+                free(value->as.promise);
+            }
+            break;
+        case VAL_ITERATOR:
+            generator_release(value->as.iterator);
+            break;
+        case VAL_PIPELINE:
+            pipeline_release(value->as.pipeline);
+            break;
+        case VAL_CHANNEL:
+            channel_release(value->as.channel);
+            break;
+        case VAL_FROZEN:
+            // آخر مرجع في أي خيط يحرر المحتوى
+            if (REF_RELEASE(value->as.frozen->refcount) == 0) {
+                value_free(&value->as.frozen->value);
+                free(value->as.frozen);
+            }
+            break;
+        case VAL_MAP:
+            for (int i = 0; i < value->as.map->capacity; i++) {
+                MapEntry *entry = &value->as.map->entries[i];
+                if (entry->distance < 0) continue;
+                value_free(&entry->key);
+                value_free(entry->value);
+                free(entry->value);
+            }
+            free(value->as.map->entries);
+            free(value->as.map);
+            break;
+        case VAL_VECTOR:
+            vector_node_release(value->as.vector.root, value->as.vector.shift);
+            break;
+        case VAL_SET:
+            for (int i = 0; i < value->as.set->count; i++) {
+                value_free(&value->as.set->items[i]);
+            }
+            free(value->as.set->items);
+            free(value->as.set->hashes);
+            free(value->as.set->index);
+            free(value->as.set);
             break;
         case VAL_EXCEPTION:
             free(value->as.exception.message);
@@ -109,46 +993,164 @@ char *value_to_string(Value *value) {
         case VAL_NUMBER:
             snprintf(buffer, sizeof(buffer), "%g", value->as.number);
             return strdup(buffer);
+        case VAL_INT:
+            snprintf(buffer, sizeof(buffer), "%" PRId64, value->as.integer);
+            return strdup(buffer);
         case VAL_STRING:
-            return strdup(value->as.string);
+            return strndup(value->as.string, string_length(value->as.string));
         case VAL_BOOLEAN:
             return strdup(value->as.boolean ? "صحيح" : "خطأ");
         case VAL_NULL:
             return strdup("فارغ");
         case VAL_ARRAY:
             {
-                char *result = strdup("[");
+                // البناء بالإلحاق المطفأ بدل إعادة قياس النص مع كل عنصر
+                char *str = string_new("[", 1);
                 for (int i = 0; i < value->as.array.count; i++) {
                     char *item = value_to_string(value->as.array.items[i]);
-                    result = realloc(result, strlen(result) + strlen(item) + 4);
-                    strcat(result, item);
-                    if (i < value->as.array.count - 1) strcat(result, ", ");
+                    str = string_append(str, item, strlen(item));
+                    if (i < value->as.array.count - 1) str = string_append(str, ", ", 2);
                     free(item);
                 }
-                result = realloc(result, strlen(result) + 2);
-                strcat(result, "]");
+                str = string_append(str, "]", 1);
+                char *result = strndup(str, string_length(str));
+                string_free(str);
                 return result;
             }
         case VAL_OBJECT:
             {
-                char *result = strdup("{");
+                char *str = string_new("{", 1);
                 for (int i = 0; i < value->as.object.count; i++) {
-                    result = realloc(result, strlen(result) + strlen(value->as.object.keys[i]) + 10);
-                    strcat(result, value->as.object.keys[i]);
-                    strcat(result, ": ");
+                    str = string_append(str, value->as.object.keys[i], strlen(value->as.object.keys[i]));
+                    str = string_append(str, ": ", 2);
                     char *val = value_to_string(value->as.object.values[i]);
-                    result = realloc(result, strlen(result) + strlen(val) + 4);
-                    strcat(result, val);
+                    str = string_append(str, val, strlen(val));
                     free(val);
-                    if (i < value->as.object.count - 1) strcat(result, ", ");
+                    if (i < value->as.object.count - 1) str = string_append(str, ", ", 2);
                 }
-                result = realloc(result, strlen(result) + 2);
-                strcat(result, "}");
+                str = string_append(str, "}", 1);
+                char *result = strndup(str, string_length(str));
+                string_free(str);
                 return result;
             }
-        case VAL_EXCEPTION:
-            snprintf(buffer, sizeof(buffer), "استثناء: %s (الكود: %d)", 
-                     value->as.exception.message, value->as.exception.code);
+        case VAL_STRUCT:
+            {
+                StructDef *def = value->as.structure->def;
+                char *str = string_new(def->name, strlen(def->name));
+                str = string_append(str, "{", 1);
+                for (int i = 0; i < def->shape->count; i++) {
+                    str = string_append(str, def->shape->keys[i], strlen(def->shape->keys[i]));
+                    str = string_append(str, ": ", 2);
+                    char *val = value_to_string(&value->as.structure->fields[i]);
+                    str = string_append(str, val, strlen(val));
+                    free(val);
+                    if (i < def->shape->count - 1) str = string_append(str, ", ", 2);
+                }
+                str = string_append(str, "}", 1);
+                char *result = strndup(str, string_length(str));
+                string_free(str);
+                return result;
+            }
+        case VAL_MAP:
+            {
+                // بصيغة الحرف نفسها: [مفتاح: قيمة, ...] و [:] للفارغة
+                if (value->as.map->count == 0) return strdup("[:]");
+                char *str = string_new("[", 1);
+                int written = 0;
+                for (int i = 0; i < value->as.map->capacity; i++) {
+                    MapEntry *entry = &value->as.map->entries[i];
+                    if (entry->distance < 0) continue;
+                    char *key = value_to_string(&entry->key);
+                    char *val = value_to_string(entry->value);
+                    str = string_append(str, key, strlen(key));
+                    str = string_append(str, ": ", 2);
+                    str = string_append(str, val, strlen(val));
+                    if (++written < value->as.map->count) str = string_append(str, ", ", 2);
+                    free(key);
+                    free(val);
+                }
+                str = string_append(str, "]", 1);
+                char *result = strndup(str, string_length(str));
+                string_free(str);
+                return result;
+            }
+        case VAL_VECTOR:
+            {
+                const char *prefix = "متجه([";
+                char *str = string_new(prefix, strlen(prefix));
+                for (int i = 0; i < value->as.vector.count; i++) {
+                    char *item = value_to_string(vector_get(value, i));
+                    str = string_append(str, item, strlen(item));
+                    if (i < value->as.vector.count - 1) str = string_append(str, ", ", 2);
+                    free(item);
+                }
+                str = string_append(str, "])", 2);
+                char *result = strndup(str, string_length(str));
+                string_free(str);
+                return result;
+            }
+        case VAL_SET:
+            {
+                // بصيغة إنشائها من مصفوفة: مجموعة([1, 2])
+                const char *prefix = "مجموعة([";
+                char *str = string_new(prefix, strlen(prefix));
+                for (int i = 0; i < value->as.set->count; i++) {
+                    char *item = value_to_string(&value->as.set->items[i]);
+                    str = string_append(str, item, strlen(item));
+                    if (i < value->as.set->count - 1) str = string_append(str, ", ", 2);
+                    free(item);
+                }
+                str = string_append(str, "])", 2);
+                char *result = strndup(str, string_length(str));
+                string_free(str);
+                return result;
+            }
+        case VAL_STRUCT_DEF:
+            snprintf(buffer, sizeof(buffer), "<هيكل %s>", value->as.struct_def.def->name);
+            return strdup(buffer);
+        case VAL_CLASS_DEF:
+            snprintf(buffer, sizeof(buffer), "<صنف %s>", value->as.class_def.def->name);
+            return strdup(buffer);
+        case VAL_FUNCTION:
+            snprintf(buffer, sizeof(buffer), "<دالة %s>", value->as.function.name);
+            return strdup(buffer);
+        case VAL_INSTANCE:
+            {
+                char *fields = value_to_string(&value->as.instance.instance->fields);
+                snprintf(buffer, sizeof(buffer), "%s%s", value->as.instance.class_def->name, fields);
+                free(fields);
+                return strdup(buffer);
+            }
+        case VAL_RANGE:
+            if (value->as.range.step == 1) {
+                snprintf(buffer, sizeof(buffer), "مدى(%" PRId64 ", %" PRId64 ")",
+                         value->as.range.start, value->as.range.stop);
+            } else {
+                snprintf(buffer, sizeof(buffer), "مدى(%" PRId64 ", %" PRId64 ", %" PRId64 ")",
+                         value->as.range.start, value->as.range.stop, value->as.range.step);
+            }
+            return strdup(buffer);
+        case VAL_ITERATOR:
+            snprintf(buffer, sizeof(buffer), "<مولد %s>", value->as.iterator->func.as.function.name);
+            return strdup(buffer);
+        case VAL_PIPELINE:
+            snprintf(buffer, sizeof(buffer), "<سلسلة كسولة من %d مراحل>", value->as.pipeline->depth);
+            return strdup(buffer);
+        case VAL_CHANNEL:
+            return strdup("<قناة>");
+        case VAL_FROZEN:
+            return value_to_string(&value->as.frozen->value);
+        case VAL_PROMISE:
+            {
+                if (!value->as.promise->resolved) return strdup("<وعد معلق>");
+                char *result = value_to_string(&value->as.promise->value);
+                snprintf(buffer, sizeof(buffer), "<وعد: %s>", result);
+                free(result);
+                return strdup(buffer);
+            }
+        case VAL_EXCEPTION:
+            snprintf(buffer, sizeof(buffer), "استثناء: %s (الكود: %d)", 
+                     value->as.exception.message, value->as.exception.code);
             return strdup(buffer);
         default:
             return strdup("<كائن>");
@@ -166,36 +1168,374 @@ bool value_is_truthy(Value *value) {
             return value->as.boolean;
         case VAL_NUMBER:
             return value->as.number != 0;
+        case VAL_INT:
+            return value->as.integer != 0;
         case VAL_STRING:
-            return strlen(value->as.string) > 0;
+            return string_length(value->as.string) > 0;
         case VAL_ARRAY:
             return value->as.array.count > 0;
         case VAL_OBJECT:
             return value->as.object.count > 0;
+        case VAL_MAP:
+            return value->as.map->count > 0;
+        case VAL_SET:
+            return value->as.set->count > 0;
+        case VAL_VECTOR:
+            return value->as.vector.count > 0;
+        case VAL_RANGE:
+            return range_length(value) > 0;
+        case VAL_FROZEN:
+            return value_is_truthy(&value->as.frozen->value);
         default:
             return true;
     }
 }
 
+// تجزئة مفتاح كائن (FNV-1a)
+static unsigned int object_key_hash(const char *key) {
+    unsigned int hash = 2166136261u;
+    for (const unsigned char *p = (const unsigned char *)key; *p; p++) {
+        hash ^= *p;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 // مقارنة قيمتين
 bool value_equals(Value *a, Value *b) {
     if (!a || !b) return a == b;
-    if (a->type != b->type) return false;
+    // المجمدة تقارن بمحتواها: [1, 2] تساوي نسختها المجمدة
+    if (a->type == VAL_FROZEN) a = &a->as.frozen->value;
+    if (b->type == VAL_FROZEN) b = &b->as.frozen->value;
+    if (a->type != b->type) {
+        // 1 و 1.0 متساويان
+        return value_is_number(a) && value_is_number(b) &&
+               value_as_number(a) == value_as_number(b);
+    }
     
     switch (a->type) {
         case VAL_NULL:
             return true;
         case VAL_NUMBER:
             return a->as.number == b->as.number;
+        case VAL_INT:
+            return a->as.integer == b->as.integer;
         case VAL_STRING:
-            return strcmp(a->as.string, b->as.string) == 0;
+            {
+                String *sa = string_header(a->as.string);
+                String *sb = string_header(b->as.string);
+                if (sa->length != sb->length) return false;
+                if (sa->has_hash && sb->has_hash && sa->hash != sb->hash) return false;
+                return memcmp(sa->chars, sb->chars, sa->length) == 0;
+            }
         case VAL_BOOLEAN:
             return a->as.boolean == b->as.boolean;
+        case VAL_STRUCT_DEF:
+            return a->as.struct_def.def == b->as.struct_def.def;
+        case VAL_CLASS_DEF:
+            return a->as.class_def.def == b->as.class_def.def;
+        case VAL_INSTANCE:
+            return a->as.instance.instance == b->as.instance.instance;
+        case VAL_PROMISE:
+            return a->as.promise == b->as.promise;
+        case VAL_ITERATOR:
+            return a->as.iterator == b->as.iterator;
+        case VAL_PIPELINE:
+            return a->as.pipeline == b->as.pipeline;
+        case VAL_CHANNEL:
+            return a->as.channel == b->as.channel;
+        case VAL_RANGE:
+            {
+                // مديان متساويان إذا أعطيا العناصر نفسها: مدى(0، 3، 5) == مدى(0، 1)
+                int64_t length = range_length(a);
+                if (length != range_length(b)) return false;
+                if (length == 0) return true;
+                if (a->as.range.start != b->as.range.start) return false;
+                return length == 1 || a->as.range.step == b->as.range.step;
+            }
+        case VAL_ARRAY:
+            {
+                if (a->as.array.count != b->as.array.count) return false;
+                for (int i = 0; i < a->as.array.count; i++) {
+                    if (!value_equals(a->as.array.items[i], b->as.array.items[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        case VAL_OBJECT:
+            {
+                // ترتيب المفاتيح لا يهم: {أ: 1, ب: 2} يساوي {ب: 2, أ: 1}
+                if (a->as.object.count != b->as.object.count) return false;
+                bool same_shape = a->as.object.shape && a->as.object.shape == b->as.object.shape;
+                for (int i = 0; i < a->as.object.count; i++) {
+                    int j = same_shape ? i : object_find(b, a->as.object.keys[i]);
+                    if (j < 0 || !value_equals(a->as.object.values[i], b->as.object.values[j])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        case VAL_MAP:
+            {
+                Map *ma = a->as.map;
+                Map *mb = b->as.map;
+                if (ma->count != mb->count) return false;
+                for (int i = 0; i < ma->capacity; i++) {
+                    MapEntry *entry = &ma->entries[i];
+                    if (entry->distance < 0) continue;
+                    int j = map_find(mb, &entry->key, entry->hash);
+                    if (j < 0 || !value_equals(entry->value, mb->entries[j].value)) return false;
+                }
+                return true;
+            }
+        case VAL_VECTOR:
+            {
+                // النسخ التي لم تعدل تتشارك الجذر نفسه
+                if (a->as.vector.root == b->as.vector.root) return a->as.vector.count == b->as.vector.count;
+                if (a->as.vector.count != b->as.vector.count) return false;
+                for (int i = 0; i < a->as.vector.count; i++) {
+                    if (!value_equals(vector_get(a, i), vector_get(b, i))) return false;
+                }
+                return true;
+            }
+        case VAL_SET:
+            {
+                Set *sa = a->as.set;
+                if (sa->count != b->as.set->count) return false;
+                for (int i = 0; i < sa->count; i++) {
+                    if (set_find(b->as.set, &sa->items[i], sa->hashes[i]) < 0) return false;
+                }
+                return true;
+            }
+        case VAL_STRUCT:
+            {
+                if (a->as.structure->def != b->as.structure->def) return false;
+                for (int i = 0; i < a->as.structure->def->shape->count; i++) {
+                    if (!value_equals(&a->as.structure->fields[i], &b->as.structure->fields[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        default:
+            return false;
+    }
+}
+
+// تجزئة قيمة تتوافق مع value_equals (1 و 1.0 لهما التجزئة نفسها،
+// والمصفوفات والكائنات والهياكل تجزأ بمحتواها)
+unsigned int value_hash(Value *value) {
+    if (!value) return 0;
+    
+    switch (value->type) {
+        case VAL_FROZEN:
+            return value_hash(&value->as.frozen->value);
+        case VAL_STRING:
+            return string_hash(value->as.string);
+        case VAL_NUMBER:
+            if (value->as.number != (double)(int64_t)value->as.number) {
+                uint64_t bits;
+                memcpy(&bits, &value->as.number, sizeof(bits));
+                return (unsigned int)(bits ^ (bits >> 32)) * 2654435761u;
+            }
+            // الأعداد العشرية الصحيحة تجزأ كالأعداد الصحيحة
+            {
+                Value integer = value_create_int((int64_t)value->as.number);
+                return value_hash(&integer);
+            }
+        case VAL_INT:
+            {
+                uint64_t bits = (uint64_t)value->as.integer;
+                return (unsigned int)(bits ^ (bits >> 32)) * 2654435761u;
+            }
+        case VAL_BOOLEAN:
+            return value->as.boolean ? 1231u : 1237u;
+        case VAL_ARRAY:
+            {
+                // الترتيب جزء من التجزئة: [1, 2] و [2, 1] مختلفتان
+                unsigned int hash = 2166136261u ^ (unsigned int)value->as.array.count;
+                for (int i = 0; i < value->as.array.count; i++) {
+                    hash = (hash ^ value_hash(value->as.array.items[i])) * 16777619u;
+                }
+                return hash;
+            }
+        case VAL_OBJECT:
+            {
+                // جمع تجزئات الأزواج لا يتأثر بترتيب المفاتيح، كما في value_equals
+                unsigned int hash = 0x9E3779B9u ^ (unsigned int)value->as.object.count;
+                for (int i = 0; i < value->as.object.count; i++) {
+                    unsigned int pair = object_key_hash(value->as.object.keys[i]) * 31u +
+                                        value_hash(value->as.object.values[i]);
+                    hash += pair * 2654435761u;
+                }
+                return hash;
+            }
+        case VAL_STRUCT:
+            {
+                uint64_t def = (uintptr_t)value->as.structure->def;
+                unsigned int hash = (unsigned int)(def ^ (def >> 32)) * 2654435761u;
+                for (int i = 0; i < value->as.structure->def->shape->count; i++) {
+                    hash = (hash ^ value_hash(&value->as.structure->fields[i])) * 16777619u;
+                }
+                return hash;
+            }
+        case VAL_INSTANCE:
+            {
+                // الكائنات المرجعية تتساوى بهويتها فتجزأ بعنوانها
+                uint64_t address = (uintptr_t)value->as.instance.instance;
+                return (unsigned int)(address ^ (address >> 32)) * 2654435761u;
+            }
+        case VAL_MAP:
+            {
+                unsigned int hash = 0x85EBCA6Bu ^ (unsigned int)value->as.map->count;
+                for (int i = 0; i < value->as.map->capacity; i++) {
+                    MapEntry *entry = &value->as.map->entries[i];
+                    if (entry->distance < 0) continue;
+                    hash += (entry->hash * 31u + value_hash(entry->value)) * 2654435761u;
+                }
+                return hash;
+            }
+        case VAL_VECTOR:
+            {
+                unsigned int hash = 2166136261u ^ (unsigned int)value->as.vector.count;
+                for (int i = 0; i < value->as.vector.count; i++) {
+                    hash = (hash ^ value_hash(vector_get(value, i))) * 16777619u;
+                }
+                return hash;
+            }
+        case VAL_RANGE:
+            {
+                // تجزئة ما يحدد العناصر فقط، كما في المساواة
+                int64_t length = range_length(value);
+                uint64_t bits = (uint64_t)length * 2654435761u;
+                if (length > 0) bits ^= (uint64_t)value->as.range.start * 40503u;
+                if (length > 1) bits ^= (uint64_t)value->as.range.step * 2246822519u;
+                return (unsigned int)(bits ^ (bits >> 32));
+            }
+        case VAL_SET:
+            {
+                // جمع التجزئات المخزنة لا يتأثر بترتيب الإضافة
+                unsigned int hash = 0xC2B2AE35u ^ (unsigned int)value->as.set->count;
+                for (int i = 0; i < value->as.set->count; i++) {
+                    hash += value->as.set->hashes[i] * 2654435761u;
+                }
+                return hash;
+            }
+        default:
+            return (unsigned int)value->type;
+    }
+}
+
+// هل تصلح القيمة مفتاحاً: تقارن وتجزأ بمحتواها أو بهويتها
+bool value_is_hashable(Value *value) {
+    switch (value->type) {
+        case VAL_FROZEN:
+            return value_is_hashable(&value->as.frozen->value);
+        case VAL_NUMBER:
+        case VAL_INT:
+        case VAL_STRING:
+        case VAL_BOOLEAN:
+        case VAL_NULL:
+        case VAL_INSTANCE:
+        case VAL_SET:
+        case VAL_RANGE:
+            return true;
+        case VAL_ARRAY:
+            for (int i = 0; i < value->as.array.count; i++) {
+                if (!value_is_hashable(value->as.array.items[i])) return false;
+            }
+            return true;
+        case VAL_OBJECT:
+            for (int i = 0; i < value->as.object.count; i++) {
+                if (!value_is_hashable(value->as.object.values[i])) return false;
+            }
+            return true;
+        case VAL_STRUCT:
+            for (int i = 0; i < value->as.structure->def->shape->count; i++) {
+                if (!value_is_hashable(&value->as.structure->fields[i])) return false;
+            }
+            return true;
+        case VAL_MAP:
+            for (int i = 0; i < value->as.map->capacity; i++) {
+                MapEntry *entry = &value->as.map->entries[i];
+                if (entry->distance >= 0 && !value_is_hashable(entry->value)) return false;
+            }
+            return true;
+        case VAL_VECTOR:
+            for (int i = 0; i < value->as.vector.count; i++) {
+                if (!value_is_hashable(vector_get(value, i))) return false;
+            }
+            return true;
         default:
             return false;
     }
 }
 
+// هل تنتقل القيمة إلى خيط آخر: لا يبقى بعد نسخها أو نقلها شيء يتشاركه خيطان
+// إلا ما لا يتغير (الدوال والتعريفات والقيم المجمدة) أو ما عداده ذري (المتجهات والقنوات)؛
+// والنسخ والوعود والمولدات مراجع مشتركة بحالة قابلة للتغيير
+bool value_is_sendable(Value *value) {
+    switch (value->type) {
+        case VAL_INSTANCE:
+        case VAL_PROMISE:
+        case VAL_ITERATOR:
+        case VAL_PIPELINE:
+        case VAL_MIND:
+        case VAL_SYSTEM:
+        case VAL_NEURAL:
+        case VAL_MODULE:
+            return false;
+        case VAL_ARRAY:
+            for (int i = 0; i < value->as.array.count; i++) {
+                if (!value_is_sendable(value->as.array.items[i])) return false;
+            }
+            return true;
+        case VAL_OBJECT:
+            for (int i = 0; i < value->as.object.count; i++) {
+                if (!value_is_sendable(value->as.object.values[i])) return false;
+            }
+            return true;
+        case VAL_STRUCT:
+            for (int i = 0; i < value->as.structure->def->shape->count; i++) {
+                if (!value_is_sendable(&value->as.structure->fields[i])) return false;
+            }
+            return true;
+        case VAL_MAP:
+            for (int i = 0; i < value->as.map->capacity; i++) {
+                MapEntry *entry = &value->as.map->entries[i];
+                if (entry->distance < 0) continue;
+                if (!value_is_sendable(&entry->key) || !value_is_sendable(entry->value)) return false;
+            }
+            return true;
+        case VAL_SET:
+            for (int i = 0; i < value->as.set->count; i++) {
+                if (!value_is_sendable(&value->as.set->items[i])) return false;
+            }
+            return true;
+        case VAL_VECTOR:
+            for (int i = 0; i < value->as.vector.count; i++) {
+                if (!value_is_sendable(vector_get(value, i))) return false;
+            }
+            return true;
+        default:
+            return true;
+    }
+}
+
+// هل القيمة عددية (صحيحة أو عشرية)
+bool value_is_number(Value *value) {
+    return value && (value->type == VAL_NUMBER || value->type == VAL_INT);
+}
+
+// القيمة العددية كعدد عشري
+double value_as_number(Value *value) {
+    if (!value) return 0;
+    if (value->type == VAL_INT) return (double)value->as.integer;
+    if (value->type == VAL_NUMBER) return value->as.number;
+    return 0;
+}
+
 // نسخ قيمة
 Value value_copy(Value *value) {
     if (!value) return value_create_null();
@@ -203,8 +1543,10 @@ Value value_copy(Value *value) {
     switch (value->type) {
         case VAL_NUMBER:
             return value_create_number(value->as.number);
+        case VAL_INT:
+            return value_create_int(value->as.integer);
         case VAL_STRING:
-            return value_create_string(value->as.string);
+            return value_wrap_string(string_copy(value->as.string));
         case VAL_BOOLEAN:
             return value_create_boolean(value->as.boolean);
         case VAL_NULL:
@@ -212,6 +1554,11 @@ Value value_copy(Value *value) {
         case VAL_ARRAY:
             {
                 Value copy = value_create_array();
+                if (value->as.array.count > copy.as.array.capacity) {
+                    copy.as.array.capacity = value->as.array.count;
+                    copy.as.array.items = realloc(copy.as.array.items,
+                                                  sizeof(Value*) * copy.as.array.capacity);
+                }
                 for (int i = 0; i < value->as.array.count; i++) {
                     Value item = value_copy(value->as.array.items[i]);
                     copy.as.array.items[copy.as.array.count] = malloc(sizeof(Value));
@@ -222,63 +1569,524 @@ Value value_copy(Value *value) {
             }
         case VAL_OBJECT:
             {
+                // النسخة تشارك الشكل فلا تنسخ المفاتيح
                 Value copy = value_create_object();
-                for (int i = 0; i < value->as.object.count; i++) {
-                    copy.as.object.keys[copy.as.object.count] = strdup(value->as.object.keys[i]);
-                    copy.as.object.values[copy.as.object.count] = malloc(sizeof(Value));
-                    *copy.as.object.values[copy.as.object.count] = value_copy(value->as.object.values[i]);
-                    copy.as.object.count++;
+                int count = value->as.object.count;
+                if (count > copy.as.object.capacity) {
+                    copy.as.object.capacity = count;
+                    copy.as.object.values = realloc(copy.as.object.values, sizeof(Value*) * count);
+                }
+                copy.as.object.shape = value->as.object.shape;
+                if (copy.as.object.shape) {
+                    copy.as.object.keys = copy.as.object.shape->keys;
+                } else {
+                    copy.as.object.keys = malloc(sizeof(char*) * copy.as.object.capacity);
+                    for (int i = 0; i < count; i++) {
+                        copy.as.object.keys[i] = strdup(value->as.object.keys[i]);
+                    }
+                }
+                for (int i = 0; i < count; i++) {
+                    copy.as.object.values[i] = malloc(sizeof(Value));
+                    *copy.as.object.values[i] = value_copy(value->as.object.values[i]);
+                }
+                copy.as.object.count = count;
+                return copy;
+            }
+        case VAL_STRUCT:
+            {
+                // نسخة الهيكل تخصيص واحد بحجم معروف مسبقاً
+                StructDef *def = value->as.structure->def;
+                Value copy = value_create_struct(def);
+                for (int i = 0; i < def->shape->count; i++) {
+                    copy.as.structure->fields[i] = value_copy(&value->as.structure->fields[i]);
+                }
+                return copy;
+            }
+        case VAL_INSTANCE:
+            // النسخ مراجع مشتركة
+            REF_RETAIN(value->as.instance.instance->refcount);
+            return *value;
+        case VAL_PROMISE:
+            value->as.promise->refcount++;
+            return *value;
+        case VAL_ITERATOR:
+            // المولد حالة تنفيذ واحدة: النسخ تتشاركها
+            value->as.iterator->refcount++;
+            return *value;
+        case VAL_PIPELINE:
+            // السلسلة وصف ثابت للمراحل، والمرور عليها يبدأ من المصدر كل مرة
+            REF_RETAIN(value->as.pipeline->refcount);
+            return *value;
+        case VAL_CHANNEL:
+            channel_retain(value->as.channel);
+            return *value;
+        case VAL_FROZEN:
+            // المحتوى لا يتغير فتتشاركه النسخ في كل الخيوط
+            REF_RETAIN(value->as.frozen->refcount);
+            return *value;
+        case VAL_EXCEPTION:
+            {
+                // الوعد المرفوض يعيد استثناءه لكل من ينتظره
+                Value copy = value_create_exception(value->as.exception.message, value->as.exception.code);
+                if (value->as.exception.stack_trace) {
+                    copy.as.exception.stack_trace = strdup(value->as.exception.stack_trace);
+                }
+                return copy;
+            }
+        case VAL_MAP:
+            {
+                // المدخلات تنسخ في خاناتها نفسها فلا حاجة لإعادة التجزئة
+                Map *source = value->as.map;
+                Value copy = value_create_map();
+                Map *target = copy.as.map;
+                if (source->capacity == 0) return copy;
+                
+                target->capacity = source->capacity;
+                target->count = source->count;
+                target->entries = malloc(sizeof(MapEntry) * source->capacity);
+                for (int i = 0; i < source->capacity; i++) {
+                    target->entries[i] = source->entries[i];
+                    if (source->entries[i].distance < 0) continue;
+                    target->entries[i].key = value_copy(&source->entries[i].key);
+                    target->entries[i].value = malloc(sizeof(Value));
+                    *target->entries[i].value = value_copy(source->entries[i].value);
+                }
+                return copy;
+            }
+        case VAL_VECTOR:
+            // النسخة تشارك الشجرة كاملة، وأول تعديل ينسخ مساره فقط
+            REF_RETAIN(value->as.vector.root->refcount);
+            return *value;
+        case VAL_SET:
+            {
+                // التجزئات والفهرس ينسخان كما هما لأن المواضع لا تتغير
+                Set *source = value->as.set;
+                Value copy = value_create_set();
+                Set *target = copy.as.set;
+                if (source->capacity == 0) return copy;
+                
+                target->capacity = source->capacity;
+                target->count = source->count;
+                target->items = malloc(sizeof(Value) * source->capacity);
+                target->hashes = malloc(sizeof(unsigned int) * source->capacity);
+                for (int i = 0; i < source->count; i++) {
+                    target->items[i] = value_copy(&source->items[i]);
+                }
+                memcpy(target->hashes, source->hashes, sizeof(unsigned int) * source->count);
+                if (source->index) {
+                    target->index_capacity = source->index_capacity;
+                    target->index = malloc(sizeof(int) * source->index_capacity);
+                    memcpy(target->index, source->index, sizeof(int) * source->index_capacity);
                 }
                 return copy;
             }
+        case VAL_STRUCT_DEF:
+        case VAL_CLASS_DEF:
+        case VAL_FUNCTION:
+        case VAL_RANGE:
+            return *value;
         default:
             return value_create_null();
     }
 }
 
-// إنشاء بيئة
-Environment *environment_create(Environment *parent, const char *name) {
-    Environment *env = malloc(sizeof(Environment));
-    env->var_count = 0;
-    env->parent = parent;
-    env->name = name ? strdup(name) : NULL;
-    env->is_class_scope = false;
-    env->is_function_scope = false;
-    return env;
-}
+static void object_index_sync(Value *object);
 
-// تدمير بيئة
-void environment_destroy(Environment *env) {
-    if (!env) return;
-    
-    for (int i = 0; i < env->var_count; i++) {
-        free(env->variables[i].name);
-        value_free(&env->variables[i].value);
-        free(env->variables[i].type_hint);
+// تجميد قيمة يمتلكها المستدعي: كل حاوية فيها تجمد من الداخل إلى الخارج فتصبح
+// مرجعاً مشتركاً، وتحسب مسبقاً كل ذاكرة تملأ عند القراءة (أطوال النصوص وتجزئاتها
+// وفهارس الكائنات الكبيرة) فلا يكتب قارئ في أي خيط شيئاً فيها
+Value value_freeze(Value value) {
+    switch (value.type) {
+        case VAL_STRING:
+            string_char_count(value.as.string);
+            string_hash(value.as.string);
+            return value;
+        case VAL_ARRAY:
+            for (int i = 0; i < value.as.array.count; i++) {
+                *value.as.array.items[i] = value_freeze(*value.as.array.items[i]);
+            }
+            break;
+        case VAL_OBJECT:
+            for (int i = 0; i < value.as.object.count; i++) {
+                *value.as.object.values[i] = value_freeze(*value.as.object.values[i]);
+            }
+            if (!value.as.object.shape && value.as.object.count >= OBJECT_INDEX_THRESHOLD) {
+                object_index_sync(&value);
+            }
+            break;
+        case VAL_STRUCT:
+            for (int i = 0; i < value.as.structure->def->shape->count; i++) {
+                value.as.structure->fields[i] = value_freeze(value.as.structure->fields[i]);
+            }
+            break;
+        case VAL_MAP:
+            // تجميد المفتاح لا يغير تجزئته فتبقى المدخلات في خاناتها
+            for (int i = 0; i < value.as.map->capacity; i++) {
+                MapEntry *entry = &value.as.map->entries[i];
+                if (entry->distance < 0) continue;
+                entry->key = value_freeze(entry->key);
+                *entry->value = value_freeze(*entry->value);
+            }
+            break;
+        case VAL_SET:
+            for (int i = 0; i < value.as.set->count; i++) {
+                value.as.set->items[i] = value_freeze(value.as.set->items[i]);
+            }
+            break;
+        case VAL_VECTOR:
+            // العقد المشتركة مع نسخ أخرى تنسخ أولاً فلا تتأثر تلك النسخ
+            for (int i = 0; i < value.as.vector.count; i++) {
+                Value *slot = vector_slot(&value, i);
+                *slot = value_freeze(*slot);
+            }
+            break;
+        default:
+            return value;
     }
     
-    free(env->name);
-    free(env);
+    Frozen *frozen = malloc(sizeof(Frozen));
+    frozen->refcount = 1;
+    frozen->value = value;
+    
+    Value v;
+    v.type = VAL_FROZEN;
+    v.as.frozen = frozen;
+    return v;
 }
 
-// تعريف متغير
-void environment_define(Environment *env, const char *name, Value value, bool is_constant) {
-    if (!env || !name) return;
+// نسخة قابلة للتعديل من قيمة مجمدة يمتلكها المستدعي (غير المجمدة تعاد كما هي)
+Value value_thaw(Value value) {
+    if (value.type != VAL_FROZEN) return value;
     
-    // التحقق من عدم وجود المتغير مسبقاً
-    for (int i = 0; i < env->var_count; i++) {
-        if (strcmp(env->variables[i].name, name) == 0) {
-            // تحديث القيمة إذا لم يكن ثابتاً
-            if (!env->variables[i].is_constant) {
-                value_free(&env->variables[i].value);
-                env->variables[i].value = value;
+    // نسخ المستوى الأول يشارك الحاويات الداخلية، ثم تذاب كل منها في خانتها
+    Value copy = value_copy(&value.as.frozen->value);
+    value_free(&value);
+    switch (copy.type) {
+        case VAL_ARRAY:
+            for (int i = 0; i < copy.as.array.count; i++) {
+                *copy.as.array.items[i] = value_thaw(*copy.as.array.items[i]);
             }
-            return;
+            break;
+        case VAL_OBJECT:
+            for (int i = 0; i < copy.as.object.count; i++) {
+                *copy.as.object.values[i] = value_thaw(*copy.as.object.values[i]);
+            }
+            break;
+        case VAL_STRUCT:
+            for (int i = 0; i < copy.as.structure->def->shape->count; i++) {
+                copy.as.structure->fields[i] = value_thaw(copy.as.structure->fields[i]);
+            }
+            break;
+        case VAL_MAP:
+            for (int i = 0; i < copy.as.map->capacity; i++) {
+                MapEntry *entry = &copy.as.map->entries[i];
+                if (entry->distance < 0) continue;
+                entry->key = value_thaw(entry->key);
+                *entry->value = value_thaw(*entry->value);
+            }
+            break;
+        case VAL_SET:
+            for (int i = 0; i < copy.as.set->count; i++) {
+                copy.as.set->items[i] = value_thaw(copy.as.set->items[i]);
+            }
+            break;
+        case VAL_VECTOR:
+            for (int i = 0; i < copy.as.vector.count; i++) {
+                Value *slot = vector_slot(&copy, i);
+                *slot = value_thaw(*slot);
+            }
+            break;
+        default:
+            break;
+    }
+    return copy;
+}
+
+// إضافة مدخل إلى فهرس تجزئة المفاتيح (فتح العنونة مع السبر الخطي)
+static void key_index_insert(int *index, int capacity, char **keys, int entry) {
+    unsigned int mask = (unsigned int)capacity - 1;
+    unsigned int slot = object_key_hash(keys[entry]) & mask;
+    while (index[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    index[slot] = entry + 1;
+}
+
+// البحث عن موضع مفتاح في فهرس التجزئة
+static int key_index_find(int *index, int capacity, char **keys, const char *key) {
+    unsigned int mask = (unsigned int)capacity - 1;
+    unsigned int slot = object_key_hash(key) & mask;
+    while (index[slot] != 0) {
+        int entry = index[slot] - 1;
+        if (strcmp(keys[entry], key) == 0) {
+            return entry;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+// سعة فهرس تتسع لعدد من المفاتيح بمعامل تحميل لا يتجاوز النصف
+static int key_index_capacity(int count, int capacity) {
+    if (capacity == 0) capacity = 32;
+    while (capacity < count * 2) capacity *= 2;
+    return capacity;
+}
+
+// الشكل الجذر (بلا مفاتيح) الذي تبدأ منه كل الكائنات
+static Shape *root_shape = NULL;
+static pthread_mutex_t shape_lock = PTHREAD_MUTEX_INITIALIZER;
+
+Shape *shape_root(void) {
+    pthread_mutex_lock(&shape_lock);
+    if (!root_shape) {
+        root_shape = calloc(1, sizeof(Shape));
+    }
+    pthread_mutex_unlock(&shape_lock);
+    return root_shape;
+}
+
+// موضع انتقال بمفتاح في جدول انتقالات الشكل: خانته إن وجد، أو أول خانة فارغة
+static int shape_transition_slot(Shape *shape, const char *key) {
+    unsigned int mask = (unsigned int)shape->transition_capacity - 1;
+    unsigned int slot = object_key_hash(key) & mask;
+    while (shape->transitions[slot]) {
+        Shape *child = shape->transitions[slot];
+        if (strcmp(child->keys[child->count - 1], key) == 0) break;
+        slot = (slot + 1) & mask;
+    }
+    return (int)slot;
+}
+
+// الشكل الناتج عن إضافة مفتاح (ينشأ مرة واحدة ثم يعاد استخدامه)
+// limited: لا ينشأ انتقال جديد من شكل بلغ SHAPE_MAX_TRANSITIONS فيعاد NULL،
+// فالكائنات بمفاتيح متفرقة كثيرة تتحول إلى وضع القاموس ولا تنمو الشجرة بلا حد
+static Shape *shape_transition_from(Shape *shape, const char *key, bool limited) {
+    // شجرة الأشكال مشتركة بين الخيوط: العمال المتوازيون قد ينشئون كائنات معاً
+    pthread_mutex_lock(&shape_lock);
+    if (shape->transition_capacity > 0) {
+        Shape *child = shape->transitions[shape_transition_slot(shape, key)];
+        if (child) {
+            pthread_mutex_unlock(&shape_lock);
+            return child;
+        }
+    }
+    if (limited && shape->transition_count >= SHAPE_MAX_TRANSITIONS) {
+        pthread_mutex_unlock(&shape_lock);
+        return NULL;
+    }
+    
+    Shape *child = calloc(1, sizeof(Shape));
+    child->parent = shape;
+    child->count = shape->count + 1;
+    child->keys = malloc(sizeof(char*) * child->count);
+    // نصوص المفاتيح السابقة مشتركة مع الشكل الأب
+    if (shape->count > 0) {
+        memcpy(child->keys, shape->keys, sizeof(char*) * shape->count);
+    }
+    child->keys[shape->count] = strdup(key);
+    
+    if (child->count >= OBJECT_INDEX_THRESHOLD) {
+        child->index_capacity = key_index_capacity(child->count, 0);
+        child->index = calloc(child->index_capacity, sizeof(int));
+        for (int i = 0; i < child->count; i++) {
+            key_index_insert(child->index, child->index_capacity, child->keys, i);
+        }
+    }
+    
+    // الجدول لا يمتلئ فوق النصف
+    if ((shape->transition_count + 1) * 2 > shape->transition_capacity) {
+        Shape **old = shape->transitions;
+        int old_capacity = shape->transition_capacity;
+        shape->transition_capacity = old_capacity ? old_capacity * 2 : 4;
+        shape->transitions = calloc(shape->transition_capacity, sizeof(Shape*));
+        for (int i = 0; i < old_capacity; i++) {
+            if (!old[i]) continue;
+            Shape *moved = old[i];
+            shape->transitions[shape_transition_slot(shape, moved->keys[moved->count - 1])] = moved;
+        }
+        free(old);
+    }
+    shape->transitions[shape_transition_slot(shape, key)] = child;
+    shape->transition_count++;
+    pthread_mutex_unlock(&shape_lock);
+    return child;
+}
+
+Shape *shape_transition(Shape *shape, const char *key) {
+    return shape_transition_from(shape, key, false);
+}
+
+// تحويل كائن إلى وضع القاموس: مفاتيح مملوكة وفهرس خاص به
+static void object_to_dictionary(Value *object) {
+    Shape *shape = object->as.object.shape;
+    char **keys = malloc(sizeof(char*) * object->as.object.capacity);
+    for (int i = 0; i < object->as.object.count; i++) {
+        keys[i] = strdup(shape->keys[i]);
+    }
+    object->as.object.keys = keys;
+    object->as.object.shape = NULL;
+    object->as.object.index = NULL;
+    object->as.object.index_capacity = 0;
+    object->as.object.indexed_count = 0;
+}
+
+// تحديث فهرس القاموس: ينشأ عند تجاوز العتبة ويتسع مع النمو
+// ثم تضاف إليه المفاتيح الجديدة (ترتيب الإدراج يبقى في keys/values)
+static void object_index_sync(Value *object) {
+    int count = object->as.object.count;
+    
+    if (count * 2 > object->as.object.index_capacity) {
+        free(object->as.object.index);
+        object->as.object.index_capacity = key_index_capacity(count, object->as.object.index_capacity);
+        object->as.object.index = calloc(object->as.object.index_capacity, sizeof(int));
+        object->as.object.indexed_count = 0;
+    }
+    
+    while (object->as.object.indexed_count < count) {
+        key_index_insert(object->as.object.index, object->as.object.index_capacity,
+                         object->as.object.keys, object->as.object.indexed_count++);
+    }
+}
+
+// موضع مفتاح في شكل، أو -1 إن لم يوجد
+int shape_find(Shape *shape, const char *key) {
+    if (shape->index) {
+        return key_index_find(shape->index, shape->index_capacity, shape->keys, key);
+    }
+    for (int i = 0; i < shape->count; i++) {
+        if (strcmp(shape->keys[i], key) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// موضع مفتاح في كائن، أو -1 إن لم يوجد
+int object_find(Value *object, const char *key) {
+    Shape *shape = object->as.object.shape;
+    
+    if (shape) {
+        return shape_find(shape, key);
+    }
+    if (object->as.object.count >= OBJECT_INDEX_THRESHOLD) {
+        object_index_sync(object);
+        return key_index_find(object->as.object.index, object->as.object.index_capacity,
+                              object->as.object.keys, key);
+    }
+    
+    // الكائنات الصغيرة: البحث الخطي أسرع من التجزئة
+    for (int i = 0; i < object->as.object.count; i++) {
+        if (strcmp(object->as.object.keys[i], key) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// البحث عن قيمة مفتاح في كائن
+Value *object_get(Value *object, const char *key) {
+    int i = object_find(object, key);
+    return i >= 0 ? object->as.object.values[i] : NULL;
+}
+
+// تعيين قيمة مفتاح في كائن (يضاف المفتاح إن لم يوجد، ويمتلك الكائن القيمة)
+Value *object_set(Value *object, const char *key, Value value) {
+    int i = object_find(object, key);
+    if (i >= 0) {
+        Value *slot = object->as.object.values[i];
+        value_free(slot);
+        *slot = value;
+        return slot;
+    }
+    
+    Shape *shape = object->as.object.shape;
+    Shape *next = NULL;
+    if (shape && shape->count < SHAPE_MAX_KEYS) {
+        next = shape_transition_from(shape, key, true);
+    }
+    if (shape && !next) {
+        // الكائنات الكبيرة والمفاتيح المتفرقة (شكل بلغ حد انتقالاته) لا تستفيد من مشاركة الشكل
+        object_to_dictionary(object);
+        shape = NULL;
+    }
+    
+    if (object->as.object.count >= object->as.object.capacity) {
+        object->as.object.capacity *= 2;
+        object->as.object.values = realloc(object->as.object.values,
+                                           sizeof(Value*) * object->as.object.capacity);
+        if (!shape) {
+            object->as.object.keys = realloc(object->as.object.keys,
+                                             sizeof(char*) * object->as.object.capacity);
+        }
+    }
+    
+    if (shape) {
+        object->as.object.shape = next;
+        object->as.object.keys = next->keys;
+    } else {
+        object->as.object.keys[object->as.object.count] = strdup(key);
+    }
+    
+    Value *slot = malloc(sizeof(Value));
+    *slot = value;
+    object->as.object.values[object->as.object.count++] = slot;
+    return slot;
+}
+
+// إنشاء بيئة
+Environment *environment_create(Environment *parent, const char *name) {
+    Environment *env = malloc(sizeof(Environment));
+    env->var_count = 0;
+    env->parent = parent;
+    env->name = name ? strdup(name) : NULL;
+    env->is_class_scope = false;
+    env->is_function_scope = false;
+    env->version = 0;
+    return env;
+}
+
+// تدمير بيئة
+void environment_destroy(Environment *env) {
+    if (!env) return;
+    
+    for (int i = 0; i < env->var_count; i++) {
+        free(env->variables[i].name);
+        value_free(&env->variables[i].value);
+        free(env->variables[i].type_hint);
+    }
+    
+    free(env->name);
+    free(env);
+}
+
+// تعريف دالة أو استبدالها يغير إصدار البيئة، فيعاد تحليل نقاء من قد يستدعيها
+static void environment_touch(Environment *env, Value *old, Value *value) {
+    if ((old && old->type == VAL_FUNCTION) || value->type == VAL_FUNCTION) {
+        env->version++;
+    }
+}
+
+// تعريف متغير
+void environment_define(Environment *env, const char *name, Value value, bool is_constant) {
+    if (!env || !name) return;
+    
+    // التحقق من عدم وجود المتغير مسبقاً
+    for (int i = 0; i < env->var_count; i++) {
+        if (strcmp(env->variables[i].name, name) == 0) {
+            // تحديث القيمة إذا لم يكن ثابتاً
+            if (!env->variables[i].is_constant) {
+                environment_touch(env, &env->variables[i].value, &value);
+                value_free(&env->variables[i].value);
+                env->variables[i].value = value;
+            }
+            return;
         }
     }
     
     // إضافة متغير جديد
     if (env->var_count < MAX_VARIABLES) {
+        environment_touch(env, NULL, &value);
         env->variables[env->var_count].name = strdup(name);
         env->variables[env->var_count].value = value;
         env->variables[env->var_count].is_constant = is_constant;
@@ -314,6 +2122,7 @@ void environment_set(Environment *env, const char *name, Value value) {
     for (int i = 0; i < env->var_count; i++) {
         if (strcmp(env->variables[i].name, name) == 0) {
             if (!env->variables[i].is_constant) {
+                environment_touch(env, &env->variables[i].value, &value);
                 value_free(&env->variables[i].value);
                 env->variables[i].value = value;
             }
@@ -375,58 +2184,2087 @@ char *environment_get_type_hint(Environment *env, const char *name) {
     if (env->parent) {
         return environment_get_type_hint(env->parent, name);
     }
-    
-    return NULL;
+    
+    return NULL;
+}
+
+// المفسر الجاري في هذا الخيط: به تستدعي المكتبات الأصلية والسلاسل الكسولة دوال وسام
+// عبر value_call، ومنه تأخذ حالتها، فتعمل مفسرات مستقلة في خيوط مختلفة معاً
+static __thread Interpreter *native_caller = NULL;
+
+// إنشاء المفسر
+Interpreter *interpreter_create(void) {
+    Interpreter *interp = malloc(sizeof(Interpreter));
+    interp->global_env = environment_create(NULL, "عالمي");
+    interp->current_env = interp->global_env;
+    interp->return_value = NULL;
+    interp->is_returning = false;
+    interp->is_breaking = false;
+    interp->is_continuing = false;
+    interp->exception = NULL;
+    interp->is_try_block = false;
+    interp->is_worker = false;
+    interp->is_isolated = false;
+    memset(&interp->libs, 0, sizeof(LibraryContext));
+    interp->memo_list = NULL;
+    
+    // تعريف الثوابت الأساسية
+    environment_define(interp->global_env, "صحيح", value_create_boolean(true), true);
+    environment_define(interp->global_env, "خطأ", value_create_boolean(false), true);
+    environment_define(interp->global_env, "فارغ", value_create_null(), true);
+    environment_define(interp->global_env, "PI", value_create_number(3.14159265359), true);
+    environment_define(interp->global_env, "E", value_create_number(2.71828182846), true);
+    
+    // الدوال الأصلية: تعرف كمتغيرات عادية فيمكن للبرنامج إعادة تعريفها
+    environment_define(interp->global_env, "مجموعة", value_create_native("مجموعة", lib_set_create), false);
+    environment_define(interp->global_env, "متجه", value_create_native("متجه", lib_vector_create), false);
+    environment_define(interp->global_env, "مدى", value_create_native("مدى", lib_list_range), false);
+    environment_define(interp->global_env, "طبق", value_create_native("طبق", lib_list_map), false);
+    environment_define(interp->global_env, "رشح", value_create_native("رشح", lib_list_filter), false);
+    environment_define(interp->global_env, "خذ", value_create_native("خذ", lib_list_take), false);
+    environment_define(interp->global_env, "تخطى", value_create_native("تخطى", lib_list_skip), false);
+    environment_define(interp->global_env, "كسول", value_create_native("كسول", lib_list_lazy), false);
+    environment_define(interp->global_env, "اجمع", value_create_native("اجمع", lib_list_collect), false);
+    environment_define(interp->global_env, "اختزل", value_create_native("اختزل", lib_list_reduce), false);
+    environment_define(interp->global_env, "طبق_متوازي", value_create_native("طبق_متوازي", lib_parallel_map), false);
+    environment_define(interp->global_env, "رشح_متوازي", value_create_native("رشح_متوازي", lib_parallel_filter), false);
+    environment_define(interp->global_env, "اختزل_متوازي", value_create_native("اختزل_متوازي", lib_parallel_reduce), false);
+    environment_define(interp->global_env, "شغّل", value_create_native("شغّل", lib_parallel_spawn), false);
+    environment_define(interp->global_env, "شغل", value_create_native("شغل", lib_parallel_spawn), false);
+    environment_define(interp->global_env, "انضم", value_create_native("انضم", lib_parallel_join), false);
+    environment_define(interp->global_env, "حدد_العمال", value_create_native("حدد_العمال", lib_parallel_set_workers), false);
+    environment_define(interp->global_env, "خيط", native_sharing_frozen("خيط", lib_parallel_thread), false);
+    environment_define(interp->global_env, "قناة", value_create_native("قناة", lib_channel_create), false);
+    environment_define(interp->global_env, "اختر", native_sharing_frozen("اختر", lib_channel_select), false);
+    environment_define(interp->global_env, "جمد", native_sharing_frozen("جمد", lib_parallel_freeze), false);
+    environment_define(interp->global_env, "مجمد", native_sharing_frozen("مجمد", lib_parallel_is_frozen), false);
+    environment_define(interp->global_env, "عدد_المعالجات", value_create_native("عدد_المعالجات", lib_system_cpu_count), false);
+    
+    // العمليات غير المتزامنة: تعيد وعوداً تنتظر بـ 'انتظر'
+    environment_define(interp->global_env, "نم", value_create_native("نم", lib_async_sleep), false);
+    environment_define(interp->global_env, "اقرأ_ملف", value_create_native("اقرأ_ملف", lib_async_read_file), false);
+    environment_define(interp->global_env, "استمع", value_create_native("استمع", lib_async_listen), false);
+    environment_define(interp->global_env, "اقبل", value_create_native("اقبل", lib_async_accept), false);
+    environment_define(interp->global_env, "اتصل", value_create_native("اتصل", lib_async_connect), false);
+    environment_define(interp->global_env, "استقبل", value_create_native("استقبل", lib_async_receive), false);
+    environment_define(interp->global_env, "أرسل", native_sharing_frozen("أرسل", lib_async_send), false);
+    environment_define(interp->global_env, "أغلق", value_create_native("أغلق", lib_async_close), false);
+    
+    return interp;
+}
+
+// تدمير المفسر
+// مفسر عامل لخيط متواز: يشارك المفسر الأصل بيئته العامة، وحالة التنفيذ خاصة به
+Interpreter *interpreter_create_worker(Interpreter *parent) {
+    Interpreter *interp = malloc(sizeof(Interpreter));
+    interp->global_env = parent->global_env;
+    interp->current_env = parent->global_env;
+    interp->return_value = NULL;
+    interp->is_returning = false;
+    interp->is_breaking = false;
+    interp->is_continuing = false;
+    interp->exception = NULL;
+    interp->is_try_block = false;
+    interp->is_worker = true;
+    interp->is_isolated = false;
+    memset(&interp->libs, 0, sizeof(LibraryContext));
+    interp->memo_list = NULL;
+    return interp;
+}
+
+// مفسر عامل لمهمة شغّل: بيئته العامة نسخة من الدوال والثوابت العامة وقت إنشائه، وهي كل
+// ما تقرؤه الدالة النقية، فلا يسابق البرنامج الرئيسي وهو يعرف متغيرات أو يستبدل دوالاً بعدها
+Interpreter *interpreter_create_snapshot(Interpreter *parent) {
+    Interpreter *interp = interpreter_create_worker(parent);
+    interp->is_isolated = true;
+    interp->global_env = environment_create(NULL, "عالمي");
+    interp->current_env = interp->global_env;
+    
+    // الأسماء فريدة في الأصل فتنسخ الخانات مباشرة دون بحث environment_define
+    Environment *globals = parent->global_env;
+    Environment *snapshot = interp->global_env;
+    for (int i = 0; i < globals->var_count; i++) {
+        Variable *variable = &globals->variables[i];
+        if (variable->value.type != VAL_FUNCTION && !variable->is_constant) continue;
+        Variable *copy = &snapshot->variables[snapshot->var_count++];
+        copy->name = strdup(variable->name);
+        copy->value = value_copy(&variable->value);
+        copy->is_constant = variable->is_constant;
+        copy->type_hint = NULL;
+    }
+    return interp;
+}
+
+// مفسر معزول لخيط مستقل: بيئة عامة جديدة فيها نسخ ما يمكن نقله من متغيرات الأصل العامة
+// (الدوال تشارك أجسامها الثابتة)، فلا يرى أحدهما ما يكتبه الآخر ولا يتواصلان إلا بالقنوات.
+// يعامل كعامل لأنه يشارك الأصل شجرة البرنامج وذواكرها المؤقتة
+Interpreter *interpreter_create_isolated(Interpreter *parent) {
+    Interpreter *interp = interpreter_create();
+    interp->is_worker = true;
+    interp->is_isolated = true;
+    
+    Environment *globals = parent->global_env;
+    for (int i = 0; i < globals->var_count; i++) {
+        Variable *variable = &globals->variables[i];
+        if (!value_is_sendable(&variable->value)) continue;
+        environment_define(interp->global_env, variable->name, value_copy(&variable->value),
+                           variable->is_constant);
+    }
+    return interp;
+}
+
+void interpreter_destroy(Interpreter *interp) {
+    if (!interp) return;
+    
+    if (!interp->is_worker || interp->is_isolated) {
+        environment_destroy(interp->global_env);
+    }
+    if (interp->return_value) {
+        value_free(interp->return_value);
+        free(interp->return_value);
+    }
+    if (interp->exception) {
+        value_free(interp->exception);
+        free(interp->exception);
+    }
+    if (native_caller == interp) native_caller = NULL;
+    lib_ai_state_free(interp->libs.ai);
+    lib_store_state_free(interp->libs.store);
+    lib_gui_state_free(interp->libs.gui);
+    lib_time_state_free(interp->libs.time);
+    event_loop_free(interp->libs.loop);
+    free(interp);
+}
+
+// تعيين متغير
+void interpreter_set_variable(Interpreter *interp, const char *name, Value value) {
+    if (!interp || !name) return;
+    environment_define(interp->global_env, name, value, false);
+}
+
+// الحصول على متغير
+Value *interpreter_get_variable(Interpreter *interp, const char *name) {
+    if (!interp || !name) return NULL;
+    return environment_get(interp->current_env, name);
+}
+
+// تحويل قيمة عددية إلى عدد صحيح دون فقد (العشري يقبل إن كان بلا كسر)
+static bool value_to_int(Value *value, int64_t *out) {
+    if (value->type == VAL_INT) {
+        *out = value->as.integer;
+        return true;
+    }
+    if (value->type == VAL_NUMBER && value->as.number == floor(value->as.number) &&
+        value->as.number >= -9223372036854775808.0 && value->as.number < 9223372036854775808.0) {
+        *out = (int64_t)value->as.number;
+        return true;
+    }
+    return false;
+}
+
+// عملية ثنائية على عددين صحيحين، مع الترقية إلى عدد عشري عند الفيض
+// تعيد قيمة فارغة إن لم تكن العملية حسابية أو ثنائية أو مقارنة
+static Value int_binary_op(TokenType op, int64_t a, int64_t b) {
+    int64_t r;
+    
+    switch (op) {
+        case TOKEN_PLUS:
+            if (__builtin_add_overflow(a, b, &r)) return value_create_number((double)a + (double)b);
+            return value_create_int(r);
+        case TOKEN_MINUS:
+            if (__builtin_sub_overflow(a, b, &r)) return value_create_number((double)a - (double)b);
+            return value_create_int(r);
+        case TOKEN_MULTIPLY:
+            if (__builtin_mul_overflow(a, b, &r)) return value_create_number((double)a * (double)b);
+            return value_create_int(r);
+        case TOKEN_DIVIDE:
+            if (b == 0) return value_create_exception("قسمة على صفر", 2);
+            if (a == INT64_MIN && b == -1) return value_create_number(-(double)a);
+            // القسمة الصحيحة تبقى صحيحة، وإلا فالناتج عشري
+            if (a % b == 0) return value_create_int(a / b);
+            return value_create_number((double)a / (double)b);
+        case TOKEN_MODULO:
+            if (b == 0) return value_create_exception("قسمة على صفر", 2);
+            if (b == -1) return value_create_int(0);
+            return value_create_int(a % b);
+        case TOKEN_POWER:
+            if (b < 0) return value_create_number(pow((double)a, (double)b));
+            {
+                int64_t base = a, exp = b;
+                r = 1;
+                while (exp > 0) {
+                    if ((exp & 1) && __builtin_mul_overflow(r, base, &r)) {
+                        return value_create_number(pow((double)a, (double)b));
+                    }
+                    exp >>= 1;
+                    if (exp > 0 && __builtin_mul_overflow(base, base, &base)) {
+                        return value_create_number(pow((double)a, (double)b));
+                    }
+                }
+                return value_create_int(r);
+            }
+        case TOKEN_EQUAL:
+            return value_create_boolean(a == b);
+        case TOKEN_NOT_EQUAL:
+            return value_create_boolean(a != b);
+        case TOKEN_GREATER:
+            return value_create_boolean(a > b);
+        case TOKEN_LESS:
+            return value_create_boolean(a < b);
+        case TOKEN_GREATER_EQ:
+            return value_create_boolean(a >= b);
+        case TOKEN_LESS_EQ:
+            return value_create_boolean(a <= b);
+        case TOKEN_BIT_AND:
+            return value_create_int(a & b);
+        case TOKEN_BIT_OR:
+            return value_create_int(a | b);
+        case TOKEN_SHIFT_LEFT:
+            if (b < 0 || b > 63) return value_create_exception("مقدار الإزاحة خارج النطاق", 7);
+            return value_create_int((int64_t)((uint64_t)a << b));
+        case TOKEN_SHIFT_RIGHT:
+            if (b < 0 || b > 63) return value_create_exception("مقدار الإزاحة خارج النطاق", 7);
+            return value_create_int(a >> b);
+        default:
+            return value_create_null();
+    }
+}
+
+// تطبيق عملية ثنائية على قيمتين (تستهلك القيمتين)
+static Value binary_operation(TokenType op, Value left, Value right) {
+    Value result = value_create_null();
+    
+    // المسار السريع: عددان صحيحان
+    if (left.type == VAL_INT && right.type == VAL_INT) {
+        result = int_binary_op(op, left.as.integer, right.as.integer);
+        if (result.type != VAL_NULL) return result;
+    }
+    
+    // عمليات المجموعات: | اتحاد، & تقاطع، - فرق (المجمدة تقرأ في مكانها)
+    Value *left_set = left.type == VAL_FROZEN ? &left.as.frozen->value : &left;
+    Value *right_set = right.type == VAL_FROZEN ? &right.as.frozen->value : &right;
+    if (left_set->type == VAL_SET && right_set->type == VAL_SET &&
+        (op == TOKEN_BIT_OR || op == TOKEN_BIT_AND || op == TOKEN_MINUS)) {
+        result = op == TOKEN_BIT_OR ? set_union(left_set, right_set) :
+                 op == TOKEN_BIT_AND ? set_intersection(left_set, right_set) :
+                 set_difference(left_set, right_set);
+        value_free(&left);
+        value_free(&right);
+        return result;
+    }
+    
+    bool numeric = value_is_number(&left) && value_is_number(&right);
+    double a = numeric ? value_as_number(&left) : 0;
+    double b = numeric ? value_as_number(&right) : 0;
+    
+    switch (op) {
+        case TOKEN_PLUS:
+            if (numeric) {
+                result = value_create_number(a + b);
+            } else if (left.type == VAL_STRING || right.type == VAL_STRING) {
+                // النصوص تعرف أطوالها فلا حاجة لنسخها أو قياسها
+                char *ls = left.type == VAL_STRING ? left.as.string : value_to_string(&left);
+                char *rs = right.type == VAL_STRING ? right.as.string : value_to_string(&right);
+                size_t llen = left.type == VAL_STRING ? string_length(ls) : strlen(ls);
+                size_t rlen = right.type == VAL_STRING ? string_length(rs) : strlen(rs);
+                char *combined = string_new(NULL, llen + rlen);
+                memcpy(combined, ls, llen);
+                memcpy(combined + llen, rs, rlen);
+                result = value_wrap_string(combined);
+                if (left.type != VAL_STRING) free(ls);
+                if (right.type != VAL_STRING) free(rs);
+            }
+            break;
+        case TOKEN_MINUS:
+            if (numeric) {
+                result = value_create_number(a - b);
+            }
+            break;
+        case TOKEN_MULTIPLY:
+            if (numeric) {
+                result = value_create_number(a * b);
+            }
+            break;
+        case TOKEN_DIVIDE:
+            if (numeric) {
+                if (b != 0) {
+                    result = value_create_number(a / b);
+                } else {
+                    result = value_create_exception("قسمة على صفر", 2);
+                }
+            }
+            break;
+        case TOKEN_MODULO:
+            if (numeric) {
+                result = value_create_number(fmod(a, b));
+            }
+            break;
+        case TOKEN_POWER:
+            if (numeric) {
+                result = value_create_number(pow(a, b));
+            }
+            break;
+        case TOKEN_EQUAL:
+            result = value_create_boolean(value_equals(&left, &right));
+            break;
+        case TOKEN_NOT_EQUAL:
+            result = value_create_boolean(!value_equals(&left, &right));
+            break;
+        case TOKEN_GREATER:
+            if (numeric) {
+                result = value_create_boolean(a > b);
+            }
+            break;
+        case TOKEN_LESS:
+            if (numeric) {
+                result = value_create_boolean(a < b);
+            }
+            break;
+        case TOKEN_GREATER_EQ:
+            if (numeric) {
+                result = value_create_boolean(a >= b);
+            }
+            break;
+        case TOKEN_LESS_EQ:
+            if (numeric) {
+                result = value_create_boolean(a <= b);
+            }
+            break;
+        case TOKEN_AND:
+            result = value_create_boolean(value_is_truthy(&left) && value_is_truthy(&right));
+            break;
+        case TOKEN_OR:
+            result = value_create_boolean(value_is_truthy(&left) || value_is_truthy(&right));
+            break;
+        case TOKEN_BIT_AND:
+        case TOKEN_BIT_OR:
+        case TOKEN_SHIFT_LEFT:
+        case TOKEN_SHIFT_RIGHT:
+            {
+                int64_t x, y;
+                if (value_to_int(&left, &x) && value_to_int(&right, &y)) {
+                    result = int_binary_op(op, x, y);
+                } else {
+                    result = value_create_exception("العمليات على البتات تتطلب أعداداً صحيحة", 6);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    
+    value_free(&left);
+    value_free(&right);
+    return result;
+}
+
+// تقييم معاملات سلسلة الجمع من اليسار (عدا النص الأول) في operands
+static bool append_collect(Interpreter *interp, ASTNode *expr, Value *operands, int *count, Value *error) {
+    if (expr->type != AST_BINARY_OP) return true;
+    if (!append_collect(interp, expr->as.binary_op.left, operands, count, error)) return false;
+    
+    Value rhs = interpreter_evaluate(interp, expr->as.binary_op.right);
+    if (rhs.type == VAL_EXCEPTION) {
+        *error = rhs;
+        return false;
+    }
+    operands[(*count)++] = rhs;
+    return true;
+}
+
+// إلحاق معاملات سلسلة الجمع س + أ + ب ... بخانة النص بالترتيب
+// المعاملات تقيم كلها قبل الإلحاق: قد تقرأ النص نفسه (س + "ي" + س)،
+// والاستثناء في أحدها لا يترك إلحاقاً ناقصاً
+static Value append_operands(Interpreter *interp, Value *slot, ASTNode *expr) {
+    int total = 0;
+    for (ASTNode *node = expr; node->type == AST_BINARY_OP; node = node->as.binary_op.left) {
+        total++;
+    }
+    
+    Value *operands = malloc(sizeof(Value) * (total ? total : 1));
+    Value result = value_create_null();
+    int count = 0;
+    if (append_collect(interp, expr, operands, &count, &result)) {
+        for (int i = 0; i < count; i++) {
+            if (operands[i].type == VAL_STRING) {
+                slot->as.string = string_append(slot->as.string, operands[i].as.string,
+                                                string_length(operands[i].as.string));
+            } else {
+                char *str = value_to_string(&operands[i]);
+                slot->as.string = string_append(slot->as.string, str, strlen(str));
+                free(str);
+            }
+        }
+    }
+    
+    for (int i = 0; i < count; i++) {
+        value_free(&operands[i]);
+    }
+    free(operands);
+    return result;
+}
+
+// استدعاء دالة معرفة في البرنامج: تمتلك الدالة المعاملات، و self (إن وجد)
+// يربط باسم 'هذا' في بيئة الاستدعاء
+static Value call_function(Interpreter *interp, Value *func, Value *args, int arg_count, Value *self) {
+    Environment *func_env = environment_create(
+        func->as.function.closure ? func->as.function.closure : interp->global_env,
+        func->as.function.name
+    );
+    func_env->is_function_scope = true;
+    
+    if (self) {
+        environment_define(func_env, "هذا", value_copy(self), true);
+    }
+    for (int i = 0; i < func->as.function.param_count; i++) {
+        environment_define(func_env, func->as.function.params[i],
+                           i < arg_count ? args[i] : value_create_null(), false);
+    }
+    for (int i = func->as.function.param_count; i < arg_count; i++) {
+        value_free(&args[i]);
+    }
+    
+    Environment *prev_env = interp->current_env;
+    interp->current_env = func_env;
+    
+    Value result = interpreter_evaluate(interp, func->as.function.body);
+    
+    interp->current_env = prev_env;
+    environment_destroy(func_env);
+    
+    if (interp->is_returning) {
+        interp->is_returning = false;
+        value_free(&result);
+        result = value_create_null();
+        if (interp->return_value) {
+            result = *interp->return_value;
+            free(interp->return_value);
+            interp->return_value = NULL;
+        }
+    }
+    
+    return result;
+}
+
+// حجم مكدس المهمة: يحجز عنواناً فقط، ولا تلتزم الذاكرة إلا بالصفحات المستخدمة
+#define TASK_STACK_SIZE (4 * 1024 * 1024)
+#define TASK_STACK_POOL 64
+
+// المهمة المنفذة الآن في هذا الخيط (NULL في البرنامج الرئيسي)
+static __thread Task *current_task = NULL;
+
+// مكدسات المهام المنتهية تعاد للاستخدام بدل إعادة حجزها (لكل خيط مخزونه)
+static __thread char *task_stack_pool[TASK_STACK_POOL];
+static __thread int task_stack_pool_count = 0;
+
+static char *task_stack_alloc(void) {
+    if (task_stack_pool_count > 0) {
+        return task_stack_pool[--task_stack_pool_count];
+    }
+    char *stack = mmap(NULL, TASK_STACK_SIZE, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (stack == MAP_FAILED) return NULL;
+    // صفحة حماية في القاع: تجاوز المكدس يوقف البرنامج بدل إفساد ذاكرة أخرى
+    mprotect(stack, 4096, PROT_NONE);
+    return stack;
+}
+
+static void task_stack_release(char *stack) {
+    if (task_stack_pool_count < TASK_STACK_POOL) {
+        task_stack_pool[task_stack_pool_count++] = stack;
+        return;
+    }
+    munmap(stack, TASK_STACK_SIZE);
+}
+
+// بداية المهمة على مكدسها: تنفيذ الدالة ثم تحقيق وعدها بالنتيجة أو رفضه بالاستثناء
+// (عند العودة ينتقل التنفيذ إلى caller عبر uc_link)
+static void task_entry(void) {
+    Task *task = current_task;
+    Value result = call_function(task->interp, &task->func, task->args, task->arg_count, NULL);
+    free(task->args);
+    task->args = NULL;
+    if (!task->is_generator) {
+        promise_settle(&task->promise, result);
+    } else if (result.type == VAL_EXCEPTION && !task->closing) {
+        // خطأ المولد يسلم لمن يكرر عليه مكان العنصر التالي
+        task->yielded = result;
+        task->has_yielded = true;
+    } else {
+        value_free(&result);
+    }
+    task->done = true;
+}
+
+// استئناف مهمة حتى تعلق أو تنتهي، مع حفظ حالة المستأنف واستعادتها
+void task_resume(Task *task) {
+    Interpreter *interp = task->interp;
+    Task *previous = current_task;
+    Environment *env = interp->current_env;
+    bool is_try_block = interp->is_try_block;
+    // أعلام التحكم ملك المستأنف: 'أعد' داخل حلقة على مولد لا تضيع عند استئنافه
+    Value *return_value = interp->return_value;
+    bool is_returning = interp->is_returning;
+    bool is_breaking = interp->is_breaking;
+    bool is_continuing = interp->is_continuing;
+    
+    current_task = task;
+    interp->current_env = task->env;
+    interp->is_try_block = task->is_try_block;
+    interp->return_value = NULL;
+    interp->is_returning = false;
+    interp->is_breaking = false;
+    interp->is_continuing = false;
+    task->started = true;
+    swapcontext(&task->caller, &task->context);
+    
+    current_task = previous;
+    interp->current_env = env;
+    interp->is_try_block = is_try_block;
+    interp->return_value = return_value;
+    interp->is_returning = is_returning;
+    interp->is_breaking = is_breaking;
+    interp->is_continuing = is_continuing;
+    
+    // المولد المنتهي يبقى حتى تحرر آخر نسخة منه
+    if (task->done && task->stack) {
+        task_stack_release(task->stack);
+        task->stack = NULL;
+        if (!task->is_generator) {
+            value_free(&task->func);
+            value_free(&task->promise);
+            free(task);
+        }
+    }
+}
+
+// تعليق المهمة الحالية والعودة إلى من استأنفها
+static void task_suspend(Interpreter *interp) {
+    Task *task = current_task;
+    task->env = interp->current_env;
+    task->is_try_block = interp->is_try_block;
+    // وأعلام المهمة تحفظ في إطارها حتى تستأنف
+    Value *return_value = interp->return_value;
+    bool is_returning = interp->is_returning;
+    bool is_breaking = interp->is_breaking;
+    bool is_continuing = interp->is_continuing;
+    swapcontext(&task->context, &task->caller);
+    interp->return_value = return_value;
+    interp->is_returning = is_returning;
+    interp->is_breaking = is_breaking;
+    interp->is_continuing = is_continuing;
+}
+
+// تجهيز مهمة لاستدعاء دالة على مكدس خاص دون بدئها (NULL إن تعذر حجز المكدس)
+static Task *task_create(Interpreter *interp, Value *func, Value *args, int arg_count) {
+    char *stack = task_stack_alloc();
+    if (!stack) {
+        for (int i = 0; i < arg_count; i++) {
+            value_free(&args[i]);
+        }
+        free(args);
+        return NULL;
+    }
+    
+    Task *task = malloc(sizeof(Task));
+    task->stack = stack;
+    task->interp = interp;
+    task->func = value_copy(func);
+    task->args = args;
+    task->arg_count = arg_count;
+    task->promise = value_create_null();
+    task->env = interp->current_env;
+    task->is_try_block = false;
+    task->started = false;
+    task->done = false;
+    task->is_generator = false;
+    task->refcount = 1;
+    task->yielded = value_create_null();
+    task->has_yielded = false;
+    task->closing = false;
+    
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = stack;
+    task->context.uc_stack.ss_size = TASK_STACK_SIZE;
+    task->context.uc_link = &task->caller;
+    makecontext(&task->context, task_entry, 0);
+    return task;
+}
+
+// استدعاء دالة غير متزامنة: تنفذ فوراً حتى أول تعليق، ويعاد وعد نتيجتها
+static Value task_start(Interpreter *interp, Value *func, Value *args, int arg_count) {
+    Task *task = task_create(interp, func, args, arg_count);
+    if (!task) return value_create_exception("تعذر حجز مكدس للمهمة", 15);
+    
+    task->promise = value_create_promise();
+    Value promise = value_copy(&task->promise);
+    task_resume(task);
+    return promise;
+}
+
+// استدعاء دالة مولدة: لا ينفذ شيء حتى يطلب أول عنصر
+static Value generator_start(Interpreter *interp, Value *func, Value *args, int arg_count) {
+    Task *task = task_create(interp, func, args, arg_count);
+    if (!task) return value_create_exception("تعذر حجز مكدس للمولد", 15);
+    
+    task->is_generator = true;
+    Value v;
+    v.type = VAL_ITERATOR;
+    v.as.iterator = task;
+    return v;
+}
+
+// العنصر التالي من المولد: يستأنفه حتى 'أنتج' التالية، وfalse عند انتهائه
+static bool generator_next(Task *task, Value *out) {
+    if (task->done && !task->has_yielded) return false;
+    if (!task->done) task_resume(task);
+    if (!task->has_yielded) return false;
+    
+    *out = task->yielded;
+    task->yielded = value_create_null();
+    task->has_yielded = false;
+    return true;
+}
+
+// تحرير نسخة من المولد؛ الأخيرة تغلقه: يستأنف و'أنتج' تعيد استثناء حتى يتفكك إطاره
+static void generator_release(Task *task) {
+    if (--task->refcount > 0) return;
+    
+    if (task->started) {
+        task->closing = true;
+        while (!task->done) {
+            task_resume(task);
+            value_free(&task->yielded);
+            task->has_yielded = false;
+        }
+    } else {
+        for (int i = 0; i < task->arg_count; i++) {
+            value_free(&task->args[i]);
+        }
+        free(task->args);
+        task_stack_release(task->stack);
+    }
+    value_free(&task->yielded);
+    value_free(&task->func);
+    free(task);
+}
+
+// هل يمكن المرور على عناصر القيمة بـ value_iterate
+bool value_is_iterable(Value *value) {
+    switch (value->type) {
+        case VAL_ARRAY:
+        case VAL_VECTOR:
+        case VAL_SET:
+        case VAL_MAP:
+        case VAL_OBJECT:
+        case VAL_STRING:
+        case VAL_RANGE:
+        case VAL_ITERATOR:
+        case VAL_PIPELINE:
+        case VAL_CHANNEL:
+            return true;
+        case VAL_FROZEN:
+            return value_is_iterable(&value->as.frozen->value);
+        default:
+            return false;
+    }
+}
+
+// حالة مرور واحد على سلسلة كسولة: موضع المصدر وعداد لكل مرحلة خذ/تخطى
+typedef struct {
+    Pipeline **stages;              // من المصدر إلى آخر مرحلة
+    int64_t *counters;
+    int stage_count;
+    int64_t position;
+    bool done;
+} PipelineCursor;
+
+static PipelineCursor *pipeline_cursor_create(Pipeline *pipeline) {
+    PipelineCursor *cursor = malloc(sizeof(PipelineCursor));
+    cursor->stage_count = pipeline->depth + 1;
+    cursor->stages = malloc(sizeof(Pipeline*) * cursor->stage_count);
+    cursor->counters = calloc(cursor->stage_count, sizeof(int64_t));
+    cursor->position = 0;
+    cursor->done = false;
+    for (int i = cursor->stage_count - 1; i >= 0; i--) {
+        cursor->stages[i] = pipeline;
+        pipeline = pipeline->parent;
+    }
+    return cursor;
+}
+
+static void pipeline_cursor_free(PipelineCursor *cursor) {
+    free(cursor->stages);
+    free(cursor->counters);
+    free(cursor);
+}
+
+// العنصر التالي من السلسلة: كل عنصر يمر بالمراحل كلها قبل سحب التالي، فلا مصفوفات وسيطة
+// خذ توقف السحب من المصدر فور اكتمالها، واستثناء أي دالة يعاد مكان العنصر
+static bool pipeline_next(PipelineCursor *cursor, Value *out) {
+    Value *source = &cursor->stages[0]->value;
+    while (!cursor->done) {
+        Value item;
+        if (!value_iterate(source, &cursor->position, &item)) {
+            cursor->done = true;
+            return false;
+        }
+        
+        bool keep = item.type != VAL_EXCEPTION;
+        for (int i = 1; keep && i < cursor->stage_count; i++) {
+            Pipeline *stage = cursor->stages[i];
+            switch (stage->stage) {
+                case STAGE_MAP:
+                    {
+                        Value mapped = value_call(&stage->value, &item, 1);
+                        value_free(&item);
+                        item = mapped;
+                        keep = item.type != VAL_EXCEPTION;
+                    }
+                    break;
+                case STAGE_FILTER:
+                    {
+                        Value test = value_call(&stage->value, &item, 1);
+                        if (test.type == VAL_EXCEPTION) {
+                            value_free(&item);
+                            item = test;
+                            keep = false;
+                            break;
+                        }
+                        keep = value_is_truthy(&test);
+                        value_free(&test);
+                        if (!keep) value_free(&item);
+                    }
+                    break;
+                case STAGE_TAKE:
+                    if (cursor->counters[i] >= stage->count) {
+                        cursor->done = true;
+                        value_free(&item);
+                        return false;
+                    }
+                    if (++cursor->counters[i] >= stage->count) {
+                        cursor->done = true;
+                    }
+                    break;
+                case STAGE_SKIP:
+                    if (cursor->counters[i] < stage->count) {
+                        cursor->counters[i]++;
+                        keep = false;
+                        value_free(&item);
+                    }
+                    break;
+                default:
+                    break;
+            }
+        }
+        
+        if (item.type == VAL_EXCEPTION) {
+            cursor->done = true;
+            *out = item;
+            return true;
+        }
+        if (keep) {
+            *out = item;
+            return true;
+        }
+    }
+    return false;
+}
+
+// حد أعلى لعدد عناصر السلسلة إن عرف طول مصدرها، وإلا -1 (لحجز مصفوفة الناتج مرة واحدة)
+static int64_t pipeline_bound(Pipeline *pipeline) {
+    switch (pipeline->stage) {
+        case STAGE_SOURCE:
+            switch (pipeline->value.type) {
+                case VAL_ARRAY: return pipeline->value.as.array.count;
+                case VAL_VECTOR: return pipeline->value.as.vector.count;
+                case VAL_SET: return pipeline->value.as.set->count;
+                case VAL_RANGE: return range_length(&pipeline->value);
+                default: return -1;
+            }
+        case STAGE_TAKE:
+            {
+                int64_t bound = pipeline_bound(pipeline->parent);
+                return bound >= 0 && bound < pipeline->count ? bound : pipeline->count;
+            }
+        case STAGE_SKIP:
+            {
+                int64_t bound = pipeline_bound(pipeline->parent);
+                if (bound < 0) return -1;
+                return bound > pipeline->count ? bound - pipeline->count : 0;
+            }
+        default:
+            return pipeline_bound(pipeline->parent);
+    }
+}
+
+// تنفيذ السلسلة في مرور واحد إلى مصفوفة الناتج الوحيدة
+Value pipeline_collect(Value *pipeline) {
+    Value result = value_create_array();
+    int64_t bound = pipeline_bound(pipeline->as.pipeline);
+    if (bound > 0 && bound <= INT32_MAX) {
+        array_reserve(&result, (int)bound);
+    }
+    
+    PipelineCursor *cursor = pipeline_cursor_create(pipeline->as.pipeline);
+    Value item;
+    while (pipeline_next(cursor, &item)) {
+        if (item.type == VAL_EXCEPTION) {
+            value_free(&result);
+            result = item;
+            break;
+        }
+        Value *slot = malloc(sizeof(Value));
+        *slot = item;
+        array_append(&result, slot);
+    }
+    pipeline_cursor_free(cursor);
+    return result;
+}
+
+// المرور الكسول على العناصر: يضع العنصر التالي (قيمة جديدة) في out ويعيد false عند النهاية
+// position حالة المرور ويبدأ من الصفر؛ الخرائط والكائنات تعطي مفاتيحها، والنصوص محارفها
+// (المولد قد يعطي استثناء مكان العنصر إن فشل)
+bool value_iterate(Value *collection, int64_t *position, Value *out) {
+    switch (collection->type) {
+        case VAL_ARRAY:
+            if (*position >= collection->as.array.count) return false;
+            *out = value_copy(collection->as.array.items[(*position)++]);
+            return true;
+        case VAL_VECTOR:
+            if (*position >= collection->as.vector.count) return false;
+            *out = value_copy(vector_get(collection, (int)(*position)++));
+            return true;
+        case VAL_RANGE:
+            if (*position >= range_length(collection)) return false;
+            *out = value_create_int(collection->as.range.start + (*position)++ * collection->as.range.step);
+            return true;
+        case VAL_SET:
+            if (*position >= collection->as.set->count) return false;
+            *out = value_copy(&collection->as.set->items[(*position)++]);
+            return true;
+        case VAL_MAP:
+            {
+                Map *map = collection->as.map;
+                while (*position < map->capacity && map->entries[*position].distance < 0) {
+                    (*position)++;
+                }
+                if (*position >= map->capacity) return false;
+                *out = value_copy(&map->entries[(*position)++].key);
+                return true;
+            }
+        case VAL_OBJECT:
+            if (*position >= collection->as.object.count) return false;
+            *out = value_create_string(collection->as.object.keys[(*position)++]);
+            return true;
+        case VAL_STRING:
+            {
+                size_t length = string_length(collection->as.string);
+                if ((size_t)*position >= length) return false;
+                // محرف UTF-8 كامل: البايت الأول وما يليه من بايتات التتمة
+                const char *chars = collection->as.string;
+                size_t start = *position, end = start + 1;
+                while (end < length && ((unsigned char)chars[end] & 0xC0) == 0x80) end++;
+                *position = end;
+                *out = value_create_string_len(chars + start, end - start);
+                return true;
+            }
+        case VAL_ITERATOR:
+            return generator_next(collection->as.iterator, out);
+        case VAL_PIPELINE:
+            {
+                // حالة المرور على السلسلة أكبر من عدد، فيحفظ مؤشرها في position
+                if (*position < 0) return false;
+                if (*position == 0) {
+                    *position = (int64_t)(intptr_t)pipeline_cursor_create(collection->as.pipeline);
+                }
+                PipelineCursor *cursor = (PipelineCursor*)(intptr_t)*position;
+                if (pipeline_next(cursor, out)) return true;
+                pipeline_cursor_free(cursor);
+                *position = -1;
+                return false;
+            }
+        case VAL_CHANNEL:
+            return channel_next(collection->as.channel, out);
+        case VAL_FROZEN:
+            return value_iterate(&collection->as.frozen->value, position, out);
+        default:
+            return false;
+    }
+}
+
+// إنهاء مرور توقف قبل آخر عنصر (توقف أو استثناء) وتحرير حالته
+void value_iterate_end(Value *collection, int64_t *position) {
+    if (collection->type == VAL_PIPELINE && *position > 0) {
+        pipeline_cursor_free((PipelineCursor*)(intptr_t)*position);
+    }
+    *position = -1;
+}
+
+// انتظار وعد: المهمة تعلق حتى يتحقق، والبرنامج الرئيسي يدير حلقة الأحداث إلى أن يتحقق
+// (انتظار قيمة ليست وعداً يعيدها كما هي)
+static Value await_promise(Interpreter *interp, Value promise) {
+    if (promise.type != VAL_PROMISE) return promise;
+    
+    Promise *p = promise.as.promise;
+    while (!p->resolved) {
+        // المولد يكرر عليه من يستأنفه، فلا يعلق نفسه في انتظار وعد
+        if (current_task && !current_task->is_generator) {
+            if (p->waiter_count >= p->waiter_capacity) {
+                p->waiter_capacity = p->waiter_capacity ? p->waiter_capacity * 2 : 4;
+                p->waiters = realloc(p->waiters, sizeof(Task*) * p->waiter_capacity);
+            }
+            p->waiters[p->waiter_count++] = current_task;
+            task_suspend(interp);
+        } else if (!event_loop_run_once()) {
+            value_free(&promise);
+            return value_create_exception("الوعد لن يتحقق: لا مهام ولا عمليات معلقة", 15);
+        }
+    }
+    
+    Value result = value_copy(&p->value);
+    value_free(&promise);
+    return result;
+}
+
+// سجل ذواكر الدوال النقية للمفسر الجاري
+FunctionMemo *memo_registry(void) {
+    return native_caller ? native_caller->memo_list : NULL;
+}
+
+// إنشاء ذاكرة نتائج فارغة لدالة (لا تحجز خانات قبل ثبوت نقائها)
+static FunctionMemo *memo_create(const char *name) {
+    FunctionMemo *memo = calloc(1, sizeof(FunctionMemo));
+    memo->name = strdup(name);
+    memo->purity = -1;
+    return memo;
+}
+
+// تحرير مدخل وإفراغ خانته
+static void memo_entry_clear(MemoEntry *entry) {
+    if (entry->arg_count < 0) return;
+    for (int i = 0; i < entry->arg_count; i++) {
+        value_free(&entry->args[i]);
+    }
+    free(entry->args);
+    value_free(&entry->result);
+    entry->arg_count = -1;
+}
+
+// إفراغ الذاكرة وإلغاء نتيجة التحليل (تبقى الخانات المحجوزة والإحصاءات)
+static void memo_reset(FunctionMemo *memo) {
+    for (int i = 0; memo->entries && i < memo->capacity; i++) {
+        memo_entry_clear(&memo->entries[i]);
+    }
+    memo->count = 0;
+    memo->purity = -1;
+}
+
+// القيم التي تصلح مفتاحاً: ما يقارن ويجزأ بمحتواه، ومنها المصفوفات
+// والكائنات والهياكل المبنية من قيم بسيطة
+static bool memo_value_cacheable(Value *value) {
+    switch (value->type) {
+        case VAL_NUMBER:
+        case VAL_INT:
+        case VAL_STRING:
+        case VAL_BOOLEAN:
+        case VAL_NULL:
+            return true;
+        case VAL_ARRAY:
+            for (int i = 0; i < value->as.array.count; i++) {
+                if (!memo_value_cacheable(value->as.array.items[i])) return false;
+            }
+            return true;
+        case VAL_OBJECT:
+            for (int i = 0; i < value->as.object.count; i++) {
+                if (!memo_value_cacheable(value->as.object.values[i])) return false;
+            }
+            return true;
+        case VAL_STRUCT:
+            for (int i = 0; i < value->as.structure->def->shape->count; i++) {
+                if (!memo_value_cacheable(&value->as.structure->fields[i])) return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool memo_args_cacheable(Value *args, int arg_count) {
+    for (int i = 0; i < arg_count; i++) {
+        if (!memo_value_cacheable(&args[i])) return false;
+    }
+    return true;
+}
+
+// تطابق تام: value_equals مع اشتراط تطابق الأنواع في كل المستويات،
+// فـ 1 و 1.0 متساويان لكن قد تختلف النتيجة
+static bool memo_same_value(Value *a, Value *b) {
+    if (a->type != b->type) return false;
+    
+    switch (a->type) {
+        case VAL_ARRAY:
+            if (a->as.array.count != b->as.array.count) return false;
+            for (int i = 0; i < a->as.array.count; i++) {
+                if (!memo_same_value(a->as.array.items[i], b->as.array.items[i])) return false;
+            }
+            return true;
+        case VAL_OBJECT:
+            if (a->as.object.count != b->as.object.count) return false;
+            for (int i = 0; i < a->as.object.count; i++) {
+                int j = object_find(b, a->as.object.keys[i]);
+                if (j < 0 || !memo_same_value(a->as.object.values[i], b->as.object.values[j])) {
+                    return false;
+                }
+            }
+            return true;
+        case VAL_STRUCT:
+            if (a->as.structure->def != b->as.structure->def) return false;
+            for (int i = 0; i < a->as.structure->def->shape->count; i++) {
+                if (!memo_same_value(&a->as.structure->fields[i], &b->as.structure->fields[i])) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return value_equals(a, b);
+    }
+}
+
+// تجزئة قائمة المعاملات
+static unsigned int memo_hash(Value *args, int arg_count) {
+    unsigned int hash = 2166136261u;
+    for (int i = 0; i < arg_count; i++) {
+        hash = (hash ^ value_hash(&args[i])) * 16777619u;
+    }
+    return hash;
+}
+
+// البحث عن نتيجة مخزنة ضمن نافذة السبر
+static MemoEntry *memo_lookup(FunctionMemo *memo, Value *args, int arg_count, unsigned int hash) {
+    if (!memo->entries) return NULL;
+    unsigned int mask = (unsigned int)memo->capacity - 1;
+    for (int probe = 0; probe < MEMO_PROBE_LIMIT; probe++) {
+        MemoEntry *entry = &memo->entries[(hash + probe) & mask];
+        if (entry->arg_count < 0) return NULL;
+        if (entry->hash != hash || entry->arg_count != arg_count) continue;
+        
+        bool same = true;
+        for (int i = 0; i < arg_count && same; i++) {
+            same = memo_same_value(&entry->args[i], &args[i]);
+        }
+        if (same) return entry;
+    }
+    return NULL;
+}
+
+// تخزين نتيجة: يتسع الجدول حتى MEMO_MAX_ENTRIES، ثم يحل المدخل الجديد
+// محل القديم في خانته الأصلية إن امتلأت نافذة السبر فيبقى الحجم محدوداً
+static void memo_store(FunctionMemo *memo, Value *args, int arg_count, unsigned int hash, Value result) {
+    if (!memo->entries || (memo->count * 2 >= memo->capacity && memo->capacity < MEMO_MAX_ENTRIES)) {
+        MemoEntry *old = memo->entries;
+        int old_capacity = memo->capacity;
+        memo->capacity = old ? old_capacity * 2 : 64;
+        memo->entries = malloc(sizeof(MemoEntry) * memo->capacity);
+        for (int i = 0; i < memo->capacity; i++) {
+            memo->entries[i].arg_count = -1;
+        }
+        memo->count = 0;
+        for (int i = 0; i < old_capacity; i++) {
+            if (old[i].arg_count < 0) continue;
+            unsigned int mask = (unsigned int)memo->capacity - 1;
+            for (int probe = 0; probe < MEMO_PROBE_LIMIT; probe++) {
+                MemoEntry *slot = &memo->entries[(old[i].hash + probe) & mask];
+                if (slot->arg_count < 0) {
+                    *slot = old[i];
+                    memo->count++;
+                    old[i].arg_count = -1;
+                    break;
+                }
+            }
+            memo_entry_clear(&old[i]);
+        }
+        free(old);
+    }
+    
+    unsigned int mask = (unsigned int)memo->capacity - 1;
+    MemoEntry *target = &memo->entries[hash & mask];
+    for (int probe = 0; probe < MEMO_PROBE_LIMIT; probe++) {
+        MemoEntry *slot = &memo->entries[(hash + probe) & mask];
+        if (slot->arg_count < 0) {
+            target = slot;
+            break;
+        }
+    }
+    
+    if (target->arg_count < 0) {
+        memo->count++;
+    } else {
+        memo_entry_clear(target);
+    }
+    target->hash = hash;
+    target->arg_count = arg_count;
+    target->args = malloc(sizeof(Value) * (arg_count ? arg_count : 1));
+    for (int i = 0; i < arg_count; i++) {
+        target->args[i] = value_copy(&args[i]);
+    }
+    target->result = result;
+}
+
+// قائمة أسماء لتحليل النقاء
+typedef struct {
+    char **names;
+    int count;
+    int capacity;
+} NameList;
+
+static void name_list_add(NameList *list, char *name) {
+    if (list->count >= list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 16;
+        list->names = realloc(list->names, sizeof(char*) * list->capacity);
+    }
+    list->names[list->count++] = name;
+}
+
+static bool name_list_has(NameList *list, const char *name) {
+    for (int i = 0; i < list->count; i++) {
+        if (strcmp(list->names[i], name) == 0) return true;
+    }
+    return false;
+}
+
+// جمع المتغيرات المحلية: تعريفات ليكن وثابت ومتغيرات الحلقات
+static void collect_locals(ASTNode *node, NameList *locals) {
+    if (!node) return;
+    
+    switch (node->type) {
+        case AST_PROGRAM:
+            for (int i = 0; i < node->as.program.count; i++) {
+                collect_locals(node->as.program.statements[i], locals);
+            }
+            break;
+        case AST_LET:
+        case AST_CONST:
+            name_list_add(locals, node->as.let.name);
+            break;
+        case AST_IF:
+            collect_locals(node->as.if_stmt.then_branch, locals);
+            collect_locals(node->as.if_stmt.else_branch, locals);
+            break;
+        case AST_FOR:
+            name_list_add(locals, node->as.for_loop.var_name);
+            collect_locals(node->as.for_loop.body, locals);
+            break;
+        case AST_WHILE:
+            collect_locals(node->as.while_loop.body, locals);
+            break;
+        case AST_SWITCH:
+            for (int i = 0; i < node->as.switch_stmt.case_count; i++) {
+                ASTNode *case_node = node->as.switch_stmt.cases[i];
+                for (int j = 0; j < case_node->as.case_stmt.statement_count; j++) {
+                    collect_locals(case_node->as.case_stmt.statements[j], locals);
+                }
+            }
+            if (node->as.switch_stmt.default_case) {
+                ASTNode *default_node = node->as.switch_stmt.default_case;
+                for (int j = 0; j < default_node->as.default_stmt.statement_count; j++) {
+                    collect_locals(default_node->as.default_stmt.statements[j], locals);
+                }
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+static bool function_is_pure(Interpreter *interp, Value *func);
+
+// سياق التحليل: الدالة المحللة (لتمييز الاستدعاء الذاتي)، أو جسم حلقة متوازية
+// جسم الحلقة يقرأ متغيرات البيئة المحيطة، ولا يكتب خارجه إلا في خارجي[متغير_الحلقة]
+typedef struct {
+    FunctionMemo *self;
+    Environment *outer;             // البيئة المحيطة بالحلقة المتوازية (NULL للدوال)
+    const char *loop_var;
+    NameList *outputs;              // المصفوفات الخارجية التي تكتب كل دورة خانتها منها
+    NameList *reads;                // المتغيرات الخارجية التي يقرؤها الجسم
+} PurityScope;
+
+// هل العقدة نقية: قائمة بيضاء من العقد، والكتابة على المتغيرات المحلية فقط،
+// والقراءة من المحلية أو من ثوابت ودوال البيئة العامة، والاستدعاء لدوال نقية
+static bool node_is_pure(Interpreter *interp, ASTNode *node, NameList *locals, PurityScope *scope) {
+    if (!node) return true;
+    
+    switch (node->type) {
+        case AST_LITERAL:
+        case AST_CONTINUE:
+            return true;
+        
+        case AST_BREAK:
+            // توقف الحلقة المتوازية يعتمد على ترتيب الدورات
+            return !scope->loop_var;
+        
+        case AST_IDENTIFIER:
+            {
+                if (name_list_has(locals, node->as.identifier.name)) return true;
+                if (scope->outer && environment_get(scope->outer, node->as.identifier.name)) {
+                    name_list_add(scope->reads, node->as.identifier.name);
+                    return true;
+                }
+                Value *global = environment_get(interp->global_env, node->as.identifier.name);
+                return global && (global->type == VAL_FUNCTION ||
+                                  environment_is_constant(interp->global_env, node->as.identifier.name));
+            }
+        
+        case AST_PROGRAM:
+            for (int i = 0; i < node->as.program.count; i++) {
+                if (!node_is_pure(interp, node->as.program.statements[i], locals, scope)) return false;
+            }
+            return true;
+        
+        case AST_LET:
+        case AST_CONST:
+            if (scope->loop_var && strcmp(node->as.let.name, scope->loop_var) == 0) return false;
+            return node_is_pure(interp, node->as.let.value, locals, scope);
+        
+        case AST_ASSIGN:
+            if (scope->loop_var && strcmp(node->as.assign.name, scope->loop_var) == 0) return false;
+            return name_list_has(locals, node->as.assign.name) &&
+                   node_is_pure(interp, node->as.assign.value, locals, scope);
+        
+        case AST_INDEX_ASSIGN:
+        case AST_PROPERTY_ASSIGN:
+            {
+                // خارجي[متغير_الحلقة] = ...: كل دورة تكتب خانة لا تكتبها غيرها
+                ASTNode *target = node->as.place_assign.target;
+                if (scope->loop_var && node->type == AST_INDEX_ASSIGN &&
+                    target->type == AST_ARRAY_ACCESS &&
+                    target->as.array_access.array->type == AST_IDENTIFIER &&
+                    target->as.array_access.index->type == AST_IDENTIFIER &&
+                    strcmp(target->as.array_access.index->as.identifier.name, scope->loop_var) == 0 &&
+                    !name_list_has(locals, target->as.array_access.array->as.identifier.name)) {
+                    name_list_add(scope->outputs, target->as.array_access.array->as.identifier.name);
+                    return node_is_pure(interp, node->as.place_assign.value, locals, scope);
+                }
+                
+                // جذر الهدف يجب أن يكون متغيراً محلياً (القيم تنسخ فلا يتأثر المستدعي)
+                ASTNode *root = node->as.place_assign.target;
+                while (root->type == AST_ARRAY_ACCESS || root->type == AST_PROPERTY_ACCESS) {
+                    if (root->type == AST_ARRAY_ACCESS) {
+                        if (!node_is_pure(interp, root->as.array_access.index, locals, scope)) return false;
+                        root = root->as.array_access.array;
+                    } else {
+                        root = root->as.property_access.object;
+                    }
+                }
+                return root->type == AST_IDENTIFIER && name_list_has(locals, root->as.identifier.name) &&
+                       node_is_pure(interp, node->as.place_assign.value, locals, scope);
+            }
+        
+        case AST_IF:
+            return node_is_pure(interp, node->as.if_stmt.condition, locals, scope) &&
+                   node_is_pure(interp, node->as.if_stmt.then_branch, locals, scope) &&
+                   node_is_pure(interp, node->as.if_stmt.else_branch, locals, scope);
+        
+        case AST_FOR:
+            return node_is_pure(interp, node->as.for_loop.start, locals, scope) &&
+                   node_is_pure(interp, node->as.for_loop.end, locals, scope) &&
+                   node_is_pure(interp, node->as.for_loop.body, locals, scope);
+        
+        case AST_WHILE:
+            return node_is_pure(interp, node->as.while_loop.condition, locals, scope) &&
+                   node_is_pure(interp, node->as.while_loop.body, locals, scope);
+        
+        case AST_RETURN:
+            if (scope->loop_var) return false;
+            return node_is_pure(interp, node->as.return_stmt.value, locals, scope);
+        
+        case AST_BINARY_OP:
+            return node_is_pure(interp, node->as.binary_op.left, locals, scope) &&
+                   node_is_pure(interp, node->as.binary_op.right, locals, scope);
+        
+        case AST_UNARY_OP:
+            return node_is_pure(interp, node->as.unary_op.operand, locals, scope);
+        
+        case AST_ARRAY:
+            for (int i = 0; i < node->as.array.count; i++) {
+                if (!node_is_pure(interp, node->as.array.elements[i], locals, scope)) return false;
+            }
+            return true;
+        
+        case AST_ARRAY_ACCESS:
+            return node_is_pure(interp, node->as.array_access.array, locals, scope) &&
+                   node_is_pure(interp, node->as.array_access.index, locals, scope);
+        
+        case AST_PROPERTY_ACCESS:
+            return node_is_pure(interp, node->as.property_access.object, locals, scope);
+        
+        case AST_OBJECT:
+            for (int i = 0; i < node->as.object.count; i++) {
+                if (!node_is_pure(interp, node->as.object.values[i], locals, scope)) return false;
+            }
+            return true;
+        
+        case AST_MAP:
+            for (int i = 0; i < node->as.map.count; i++) {
+                if (!node_is_pure(interp, node->as.map.keys[i], locals, scope) ||
+                    !node_is_pure(interp, node->as.map.values[i], locals, scope)) {
+                    return false;
+                }
+            }
+            return true;
+        
+        case AST_STRUCT_CREATE:
+            for (int i = 0; i < node->as.struct_create.layout->shape->count; i++) {
+                if (!node_is_pure(interp, node->as.struct_create.values[i], locals, scope)) return false;
+            }
+            return true;
+        
+        case AST_SWITCH:
+            {
+                if (!node_is_pure(interp, node->as.switch_stmt.expression, locals, scope)) return false;
+                for (int i = 0; i < node->as.switch_stmt.case_count; i++) {
+                    ASTNode *case_node = node->as.switch_stmt.cases[i];
+                    if (!node_is_pure(interp, case_node->as.case_stmt.value, locals, scope)) return false;
+                    for (int j = 0; j < case_node->as.case_stmt.statement_count; j++) {
+                        if (!node_is_pure(interp, case_node->as.case_stmt.statements[j], locals, scope)) return false;
+                    }
+                }
+                ASTNode *default_node = node->as.switch_stmt.default_case;
+                for (int j = 0; default_node && j < default_node->as.default_stmt.statement_count; j++) {
+                    if (!node_is_pure(interp, default_node->as.default_stmt.statements[j], locals, scope)) return false;
+                }
+                return true;
+            }
+        
+        case AST_FUNCTION_CALL:
+            {
+                for (int i = 0; i < node->as.function_call.arg_count; i++) {
+                    if (!node_is_pure(interp, node->as.function_call.args[i], locals, scope)) return false;
+                }
+                if (name_list_has(locals, node->as.function_call.name)) return false;
+                
+                Value *callee = environment_get(interp->global_env, node->as.function_call.name);
+                if (!callee || callee->type != VAL_FUNCTION || !callee->as.function.memo) return false;
+                // الاستدعاء الذاتي نقي إن كان باقي الجسم نقياً، والتعاودي المتبادل يعامل كغير نقي
+                if (callee->as.function.memo == scope->self) return true;
+                return function_is_pure(interp, callee);
+            }
+        
+        default:
+            // الطباعة والإدخال ودوال الأصناف وغيرها لها آثار جانبية محتملة
+            return false;
+    }
+}
+
+// تحليل نقاء دالة مرة واحدة، وتسجيل ذاكرتها إن كانت نقية
+static bool function_is_pure(Interpreter *interp, Value *func) {
+    FunctionMemo *memo = func->as.function.memo;
+    if (!memo) return false;
+    // نتيجة التحليل مشتركة بين الخيوط فيكتبها المفسر الرئيسي وحده
+    if (interp->is_worker) return false;
+    if (memo->purity == 2) return false;
+    // دالة عامة عرفت أو استبدلت بعد التحليل: قد تكون مما تستدعيه الدالة،
+    // فتمسح نتائجها ويعاد تحليلها
+    if (memo->epoch != interp->global_env->version) {
+        memo->epoch = interp->global_env->version;
+        memo_reset(memo);
+    }
+    if (memo->purity >= 0) return memo->purity == 1;
+    
+    memo->purity = 2;
+    NameList locals = {NULL, 0, 0};
+    for (int i = 0; i < func->as.function.param_count; i++) {
+        name_list_add(&locals, func->as.function.params[i]);
+    }
+    collect_locals(func->as.function.body, &locals);
+    PurityScope scope = {memo, NULL, NULL, NULL, NULL};
+    bool pure = node_is_pure(interp, func->as.function.body, &locals, &scope);
+    free(locals.names);
+    
+    memo->purity = pure ? 1 : 0;
+    if (pure && !memo->registered) {
+        memo->registered = true;
+        memo->next = interp->memo_list;
+        interp->memo_list = memo;
+    }
+    return pure;
+}
+
+// حلقة لكل_متوازي: الدورات مستقلة، لكل منها بيئة خاصة، وتقسم على قطع متصلة
+typedef struct {
+    ASTNode *node;
+    Environment *outer;
+    Value start;
+    int64_t count;
+    int chunk_count;
+    Value *errors;                  // أول استثناء في كل قطعة
+} ParallelLoop;
+
+static void parallel_loop_chunk(Interpreter *worker, void *context, int chunk) {
+    ParallelLoop *loop = context;
+    int64_t from = loop->count * chunk / loop->chunk_count;
+    int64_t to = loop->count * (chunk + 1) / loop->chunk_count;
+    
+    for (int64_t i = from; i < to; i++) {
+        Environment *iteration_env = environment_create(loop->outer, "حلقة");
+        Value counter = loop->start.type == VAL_INT ?
+                        value_create_int(loop->start.as.integer + i) :
+                        value_create_number(loop->start.as.number + (double)i);
+        environment_define(iteration_env, loop->node->as.for_loop.var_name, counter, false);
+        
+        worker->current_env = iteration_env;
+        Value result = interpreter_evaluate(worker, loop->node->as.for_loop.body);
+        worker->current_env = worker->global_env;
+        worker->is_continuing = false;
+        environment_destroy(iteration_env);
+        
+        if (result.type == VAL_EXCEPTION) {
+            loop->errors[chunk] = result;
+            return;
+        }
+        value_free(&result);
+    }
+}
+
+// تنفيذ الحلقة على المجمع المتوازي إن أمكن. تعيد false دون تقييم شيء إن كان الجسم غير آمن
+// (يكتب متغيرات خارجية، أو يتوقف أو يعيد، أو يقرأ مصفوفة يكتبها)، فتنفذ الحلقة تسلسلياً
+static bool parallel_for(Interpreter *interp, ASTNode *node, Value *result) {
+    NameList locals = {NULL, 0, 0};
+    NameList outputs = {NULL, 0, 0};
+    NameList reads = {NULL, 0, 0};
+    name_list_add(&locals, node->as.for_loop.var_name);
+    collect_locals(node->as.for_loop.body, &locals);
+    PurityScope scope = {NULL, interp->current_env, node->as.for_loop.var_name, &outputs, &reads};
+    
+    bool safe = node_is_pure(interp, node->as.for_loop.body, &locals, &scope);
+    for (int i = 0; safe && i < outputs.count; i++) {
+        Value *output = environment_get(interp->current_env, outputs.names[i]);
+        safe = !name_list_has(&reads, outputs.names[i]) && output &&
+               (output->type == VAL_ARRAY || output->type == VAL_RANGE) &&
+               !environment_is_constant(interp->current_env, outputs.names[i]);
+    }
+    free(locals.names);
+    free(reads.names);
+    if (!safe) {
+        free(outputs.names);
+        return false;
+    }
+    
+    Value start = interpreter_evaluate(interp, node->as.for_loop.start);
+    Value end_val = interpreter_evaluate(interp, node->as.for_loop.end);
+    if (start.type == VAL_EXCEPTION || end_val.type == VAL_EXCEPTION) {
+        *result = start.type == VAL_EXCEPTION ? start : end_val;
+        value_free(start.type == VAL_EXCEPTION ? &end_val : &start);
+        free(outputs.names);
+        return true;
+    }
+    if (!value_is_number(&start) || !value_is_number(&end_val)) {
+        value_free(&start);
+        value_free(&end_val);
+        free(outputs.names);
+        *result = value_create_exception("حدود لكل_متوازي يجب أن تكون أرقاماً", 4);
+        return true;
+    }
+    
+    double first = value_as_number(&start);
+    double last = value_as_number(&end_val);
+    int64_t count = last >= first ? (int64_t)floor(last - first) + 1 : 0;
+    value_free(&end_val);
+    
+    // المصفوفات الناتجة تحجز قبل البدء بطول يسع كل الدورات، فلا تعيد الخيوط تخصيصها
+    for (int i = 0; i < outputs.count; i++) {
+        Value *output = environment_get(interp->current_env, outputs.names[i]);
+        range_materialize(output);
+        int64_t needed = count > 0 ? (int64_t)floor(last) + 1 : 0;
+        array_reserve(output, (int)needed);
+        while (output->as.array.count < needed) {
+            output->as.array.items[output->as.array.count] = malloc(sizeof(Value));
+            *output->as.array.items[output->as.array.count] = value_create_null();
+            output->as.array.count++;
+        }
+    }
+    free(outputs.names);
+    
+    *result = value_create_null();
+    if (count == 0) return true;
+    
+    ParallelLoop loop = {node, interp->current_env, start, count, parallel_chunk_count(count), NULL};
+    loop.errors = malloc(sizeof(Value) * loop.chunk_count);
+    for (int i = 0; i < loop.chunk_count; i++) {
+        loop.errors[i] = value_create_null();
+    }
+    
+    parallel_run(interp, loop.chunk_count, parallel_loop_chunk, &loop);
+    
+    // أول استثناء بترتيب الدورات، كما في الحلقة التسلسلية
+    for (int i = 0; i < loop.chunk_count; i++) {
+        if (loop.errors[i].type == VAL_EXCEPTION && result->type != VAL_EXCEPTION) {
+            *result = loop.errors[i];
+        } else {
+            value_free(&loop.errors[i]);
+        }
+    }
+    free(loop.errors);
+    return true;
+}
+
+
+// استدعاء قيمة دالة بمعاملات مقيمة (تملك المصفوفة وما فيها)
+static Value call_value(Interpreter *interp, Value *func_val, Value *args, int arg_count) {
+    // استدعاء الدالة الأصلية
+    if (func_val->as.function.is_native) {
+        // المكتبات الأصلية تتعامل مع الأعداد العشرية، ومع نسخ قابلة للتعديل
+        // من القيم المجمدة إلا ما ينقلها بين الخيوط
+        for (int i = 0; i < arg_count; i++) {
+            if (args[i].type == VAL_INT) {
+                args[i] = value_create_number((double)args[i].as.integer);
+            } else if (args[i].type == VAL_FROZEN && !func_val->as.function.shares_frozen) {
+                args[i] = value_thaw(args[i]);
+            }
+        }
+        Interpreter *prev_caller = native_caller;
+        native_caller = interp;
+        Value result = func_val->as.function.native_fn(args, arg_count);
+        native_caller = prev_caller;
+        for (int i = 0; i < arg_count; i++) {
+            value_free(&args[i]);
+        }
+        free(args);
+        return result;
+    }
+    
+    if (func_val->as.function.is_async) {
+        return task_start(interp, func_val, args, arg_count);
+    }
+    if (func_val->as.function.is_generator) {
+        return generator_start(interp, func_val, args, arg_count);
+    }
+    
+    // الدوال النقية: البحث في ذاكرة النتائج بالمعاملات أولاً
+    // (العامل المتوازي لا يستخدمها: جدولها مشترك بين الخيوط)
+    FunctionMemo *memo = interp->is_worker ? NULL : func_val->as.function.memo;
+    if (memo && memo_args_cacheable(args, arg_count) && function_is_pure(interp, func_val)) {
+        unsigned int hash = memo_hash(args, arg_count);
+        MemoEntry *entry = memo_lookup(memo, args, arg_count, hash);
+        if (entry) {
+            memo->hits++;
+            for (int i = 0; i < arg_count; i++) {
+                value_free(&args[i]);
+            }
+            free(args);
+            return value_copy(&entry->result);
+        }
+        
+        memo->misses++;
+        Value *key = malloc(sizeof(Value) * (arg_count ? arg_count : 1));
+        for (int i = 0; i < arg_count; i++) {
+            key[i] = value_copy(&args[i]);
+        }
+        Value result = call_function(interp, func_val, args, arg_count, NULL);
+        free(args);
+        if (result.type != VAL_EXCEPTION) {
+            memo_store(memo, key, arg_count, hash, value_copy(&result));
+        }
+        for (int i = 0; i < arg_count; i++) {
+            value_free(&key[i]);
+        }
+        free(key);
+        return result;
+    }
+    
+    Value result = call_function(interp, func_val, args, arg_count, NULL);
+    free(args);
+    return result;
+}
+
+// استدعاء دالة وسام بمفسر محدد (العامل المتوازي يستدعي بمفسره)؛ المعاملات تنسخ ولا تمس
+Value interpreter_call(Interpreter *interp, Value *func, Value *args, int arg_count) {
+    if (!func || func->type != VAL_FUNCTION) {
+        return value_create_exception("القيمة ليست دالة", 4);
+    }
+    if (!interp) {
+        return value_create_exception("لا يوجد مفسر لاستدعاء الدالة", 4);
+    }
+    
+    Value *copies = malloc(sizeof(Value) * (arg_count ? arg_count : 1));
+    for (int i = 0; i < arg_count; i++) {
+        copies[i] = value_copy(&args[i]);
+    }
+    return call_value(interp, func, copies, arg_count);
+}
+
+// استدعاء دالة وسام من مكتبة أصلية (طبق، رشح) بالمفسر الجاري
+Value value_call(Value *func, Value *args, int arg_count) {
+    return interpreter_call(native_caller, func, args, arg_count);
+}
+
+// انتظار وعد من مكتبة أصلية (انضم): يعلق المهمة غير المتزامنة، أو يدير الحلقة حتى يتحقق
+Value interpreter_await(Interpreter *interp, Value promise) {
+    return await_promise(interp, promise);
+}
+
+// تنفيذ دالة في مفسر معزول على الخيط الجاري (تملك المعاملات) حتى تكتمل مهامه، ثم تدميره
+// الناتج يسلم لخيط آخر، فما لا ينتقل منه يستبدل باستثناء
+Value interpreter_run_isolated(Interpreter *interp, Value *func, Value *args, int arg_count) {
+    native_caller = interp;
+    Value result = await_promise(interp, call_value(interp, func, args, arg_count));
+    if (result.type != VAL_EXCEPTION) {
+        event_loop_run();
+    }
+    if (!value_is_sendable(&result)) {
+        value_free(&result);
+        result = value_create_exception("ناتج الخيط قيمة مشتركة بالمرجع لا تنتقل بين الخيوط", 4);
+    }
+    interpreter_destroy(interp);
+    return result;
+}
+
+// حالة المكتبات للمفسر الجاري؛ والاستدعاء المباشر من C خارج أي مفسر يستخدم حالة منفصلة
+LibraryContext *library_context(void) {
+    static __thread LibraryContext detached;
+    return native_caller ? &native_caller->libs : &detached;
+}
+
+// المفسر الجاري، لمكتبات تحتاجه كالمجمع المتوازي
+Interpreter *interpreter_current(void) {
+    return native_caller;
+}
+
+// هل الدالة نقية فيمكن تنفيذها في عمال متوازين؟ (دالة وسام بلا آثار جانبية)
+bool value_is_pure_function(Interpreter *interp, Value *func) {
+    return func->type == VAL_FUNCTION && !func->as.function.is_native &&
+           function_is_pure(interp, func);
+}
+
+// تقييم قائمة معاملات، وعند الاستثناء تحرر المقيمة ويعاد الاستثناء في error
+static Value *evaluate_args(Interpreter *interp, ASTNode **nodes, int count, Value *error) {
+    Value *args = malloc(sizeof(Value) * (count ? count : 1));
+    for (int i = 0; i < count; i++) {
+        args[i] = interpreter_evaluate(interp, nodes[i]);
+        if (args[i].type == VAL_EXCEPTION) {
+            *error = args[i];
+            for (int j = 0; j < i; j++) {
+                value_free(&args[j]);
+            }
+            free(args);
+            return NULL;
+        }
+    }
+    return args;
+}
+
+// قراءة خاصية عبر الذاكرة المؤقتة المضمنة في عقدة الوصول: إذا طابق شكل
+// الكائن آخر شكل رؤي في هذا الموضع كان الوصول تحميلاً مباشراً من الموضع المحفوظ
+// (العامل لا يستخدم الذاكرة المؤقتة: العقدة مشتركة مع خيوط قد تكتبها في الوقت نفسه)
+static Value *property_lookup(Interpreter *interp, Value *object, ASTNode *node) {
+    if (object->type == VAL_INSTANCE) {
+        object = &object->as.instance.instance->fields;
+    }
+    if (object->type == VAL_STRUCT) {
+        // حقول الهيكل ثابتة المواضع: يحسب الموضع مرة واحدة لكل عقدة
+        StructInstance *instance = object->as.structure;
+        Shape *shape = instance->def->shape;
+        if (interp->is_worker || shape != node->as.property_access.cache_shape) {
+            int i = shape_find(shape, node->as.property_access.property);
+            if (i < 0) return NULL;
+            if (interp->is_worker) return &instance->fields[i];
+            node->as.property_access.cache_shape = shape;
+            node->as.property_access.cache_index = i;
+        }
+        return &instance->fields[node->as.property_access.cache_index];
+    }
+    
+    Shape *shape = object->as.object.shape;
+    if (shape && !interp->is_worker && shape == node->as.property_access.cache_shape) {
+        return object->as.object.values[node->as.property_access.cache_index];
+    }
+    
+    int i = object_find(object, node->as.property_access.property);
+    if (i < 0) return NULL;
+    
+    if (shape && !interp->is_worker) {
+        node->as.property_access.cache_shape = shape;
+        node->as.property_access.cache_index = i;
+    }
+    return object->as.object.values[i];
+}
+
+// محتوى الحاوية المجمدة للقراءة، أو استثناء عند محاولة الكتابة فيها
+static Value *frozen_place(Value *container, bool for_write, Value *error) {
+    if (container->type != VAL_FROZEN) return container;
+    if (for_write) {
+        *error = value_create_exception("لا يمكن تعديل قيمة مجمدة", 9);
+        return NULL;
+    }
+    return &container->as.frozen->value;
+}
+
+// فهارس سلسلة خانة محسوبة بترتيبها في النص قبل تتبع الحاويات: تقييم فهرس قد يستدعي
+// دالة تعيد تعيين المتغير فتحرر حاوية لو كان مؤشرها محفوظاً
+#define PLACE_INLINE_KEYS 4
+
+typedef struct {
+    Value *items;
+    int count;
+    int capacity;
+    int next;                       // أول فهرس لم يستهلكه التتبع
+    Value inline_items[PLACE_INLINE_KEYS];
+    Value value;                    // قيمة السلسلة بعد حاوية عناصرها ليست خانات (نص أو مدى)
+    bool has_value;
+} PlaceKeys;
+
+static void place_keys_init(PlaceKeys *keys) {
+    keys->items = keys->inline_items;
+    keys->count = 0;
+    keys->capacity = PLACE_INLINE_KEYS;
+    keys->next = 0;
+    keys->value = value_create_null();
+    keys->has_value = false;
+}
+
+static void place_keys_free(PlaceKeys *keys) {
+    for (int i = 0; i < keys->count; i++) {
+        value_free(&keys->items[i]);
+    }
+    if (keys->items != keys->inline_items) free(keys->items);
+    value_free(&keys->value);
+}
+
+// قراءة عنصر من حاوية بفهرس مقيم (نسخة منه، أو استثناء)
+static Value index_read(Value *arr, Value *idx) {
+    if (arr->type == VAL_FROZEN) arr = &arr->as.frozen->value;
+    
+    if (arr->type == VAL_ARRAY && value_is_number(idx)) {
+        int index = (int)value_as_number(idx);
+        if (index >= 0 && index < arr->as.array.count) {
+            return value_copy(arr->as.array.items[index]);
+        }
+        return value_create_exception("فهرس خارج النطاق", 3);
+    }
+    if (arr->type == VAL_STRING && value_is_number(idx)) {
+        int index = (int)value_as_number(idx);
+        if (index >= 0 && index < string_char_count(arr->as.string)) {
+            size_t start = string_char_offset(arr->as.string, index);
+            size_t end = string_char_offset(arr->as.string, index + 1);
+            return value_create_string_len(arr->as.string + start, end - start);
+        }
+        return value_create_exception("فهرس خارج النطاق", 3);
+    }
+    if (arr->type == VAL_OBJECT && idx->type == VAL_STRING) {
+        Value *field = object_get(arr, idx->as.string);
+        if (field) return value_copy(field);
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg), "الخاصية '%s' غير موجودة", idx->as.string);
+        return value_create_exception(error_msg, 8);
+    }
+    if (arr->type == VAL_VECTOR && value_is_number(idx)) {
+        Value *item = vector_get(arr, (int)value_as_number(idx));
+        return item ? value_copy(item) : value_create_exception("فهرس خارج النطاق", 3);
+    }
+    if (arr->type == VAL_RANGE && value_is_number(idx)) {
+        int64_t index = (int64_t)value_as_number(idx);
+        return index >= 0 && index < range_length(arr) ?
+               value_create_int(arr->as.range.start + index * arr->as.range.step) :
+               value_create_exception("فهرس خارج النطاق", 3);
+    }
+    if (arr->type == VAL_MAP) {
+        if (!value_is_hashable(idx)) {
+            return value_create_exception("المفتاح غير قابل للتجزئة", 14);
+        }
+        Value *entry = map_get(arr, idx);
+        if (entry) return value_copy(entry);
+        char *key = value_to_string(idx);
+        char error_msg[256];
+        snprintf(error_msg, sizeof(error_msg), "المفتاح '%s' غير موجود", key);
+        free(key);
+        return value_create_exception(error_msg, 8);
+    }
+    return value_create_exception("نوع غير صالح للوصول بالفهرس", 4);
+}
+
+// هل تنتهي السلسلة إلى متغير أو 'هذا'، فهي خانة لا قيمة مؤقتة
+static bool place_is_rooted(ASTNode *node) {
+    while (node->type == AST_ARRAY_ACCESS || node->type == AST_PROPERTY_ACCESS) {
+        node = node->type == AST_ARRAY_ACCESS ? node->as.array_access.array :
+                                                node->as.property_access.object;
+    }
+    return node->type == AST_IDENTIFIER || node->type == AST_THIS;
+}
+
+// تقييم فهارس السلسلة من الجذر إلى node (ومنها فهرس node نفسه)
+static bool place_keys_evaluate(Interpreter *interp, ASTNode *node, PlaceKeys *keys, Value *error) {
+    if (node->type == AST_PROPERTY_ACCESS) {
+        return place_keys_evaluate(interp, node->as.property_access.object, keys, error);
+    }
+    if (node->type != AST_ARRAY_ACCESS) return true;
+    if (!place_keys_evaluate(interp, node->as.array_access.array, keys, error)) return false;
+    
+    Value key = interpreter_evaluate(interp, node->as.array_access.index);
+    if (key.type == VAL_EXCEPTION) {
+        *error = key;
+        return false;
+    }
+    if (keys->count >= keys->capacity) {
+        Value *items = malloc(sizeof(Value) * keys->capacity * 2);
+        memcpy(items, keys->items, sizeof(Value) * keys->count);
+        if (keys->items != keys->inline_items) free(keys->items);
+        keys->items = items;
+        keys->capacity *= 2;
+    }
+    keys->items[keys->count++] = key;
+    return true;
+}
+
+// تتبع الحاويات بفهارس محسوبة مسبقاً (لا يقيم شيئاً فلا يتغير ما يمر به)
+// تعيد NULL إن لم يكن التعبير خانة، أو عند الخطأ مع وضع الاستثناء في error
+// for_write: يمنع تعديل الثوابت ويضيف الخاصية الناقصة إلى الكائن
+// وفي القراءة تكمل السلسلة بعد نص أو مدى بالقيم في keys->value، فتعيد NULL دون خطأ
+static Value *place_walk(Interpreter *interp, ASTNode *node, bool for_write, PlaceKeys *keys, Value *error) {
+    char error_msg[256];
+    
+    switch (node->type) {
+        case AST_IDENTIFIER:
+            {
+                Value *slot = environment_get(interp->current_env, node->as.identifier.name);
+                if (!slot) {
+                    snprintf(error_msg, sizeof(error_msg),
+                             "المتغير '%s' غير معرف", node->as.identifier.name);
+                    *error = value_create_exception(error_msg, 1);
+                } else if (for_write && environment_is_constant(interp->current_env, node->as.identifier.name)) {
+                    snprintf(error_msg, sizeof(error_msg),
+                             "لا يمكن تعديل الثابت '%s'", node->as.identifier.name);
+                    *error = value_create_exception(error_msg, 9);
+                    return NULL;
+                }
+                return slot;
+            }
+        
+        case AST_ARRAY_ACCESS:
+            {
+                Value *container = place_walk(interp, node->as.array_access.array, for_write, keys, error);
+                if (!container && !keys->has_value) return NULL;
+                if (!container) container = &keys->value;
+                container = frozen_place(container, for_write, error);
+                if (!container) return NULL;
+                
+                Value *key = &keys->items[keys->next++];
+                
+                // الكتابة في مدى تحوله إلى مصفوفة أولاً
+                if (for_write && container->type == VAL_RANGE) {
+                    range_materialize(container);
+                }
+                
+                Value *slot = NULL;
+                if (container->type == VAL_ARRAY && value_is_number(key)) {
+                    int index = (int)value_as_number(key);
+                    if (index >= 0 && index < container->as.array.count) {
+                        slot = container->as.array.items[index];
+                    } else {
+                        *error = value_create_exception("فهرس خارج النطاق", 3);
+                    }
+                } else if (container->type == VAL_OBJECT && key->type == VAL_STRING) {
+                    slot = object_get(container, key->as.string);
+                    if (!slot && for_write) {
+                        slot = object_set(container, key->as.string, value_create_null());
+                    }
+                } else if (container->type == VAL_VECTOR && value_is_number(key)) {
+                    int index = (int)value_as_number(key);
+                    slot = for_write && index < container->as.vector.count ?
+                           vector_slot(container, index) : vector_get(container, index);
+                    if (!slot) {
+                        *error = value_create_exception("فهرس خارج النطاق", 3);
+                    }
+                } else if (container->type == VAL_MAP) {
+                    if (!value_is_hashable(key)) {
+                        *error = value_create_exception("المفتاح غير قابل للتجزئة", 14);
+                    } else {
+                        slot = map_get(container, key);
+                        if (!slot && for_write) {
+                            // الخريطة تمتلك المفتاح
+                            slot = map_set(container, *key, value_create_null());
+                            *key = value_create_null();
+                        }
+                    }
+                } else if (container->type != VAL_STRING && container->type != VAL_RANGE) {
+                    *error = value_create_exception("نوع غير صالح للوصول بالفهرس", 4);
+                }
+                
+                if (!slot && !for_write && error->type != VAL_EXCEPTION) {
+                    // محارف النص وعناصر المدى ليست خانات مستقلة: تقرأ قيمتها بالفهرس المقيم
+                    // (ومنها خطأ المفتاح الناقص في كائن أو خريطة)
+                    Value element = index_read(container, key);
+                    if (element.type == VAL_EXCEPTION) {
+                        *error = element;
+                    } else {
+                        value_free(&keys->value);
+                        keys->value = element;
+                        keys->has_value = true;
+                    }
+                }
+                
+                return slot;
+            }
+        
+        case AST_THIS:
+            {
+                Value *slot = environment_get(interp->current_env, "هذا");
+                if (!slot) {
+                    *error = value_create_exception("'هذا' متاحة داخل دوال الصنف فقط", 12);
+                }
+                return slot;
+            }
+        
+        case AST_PROPERTY_ACCESS:
+            {
+                Value *container = place_walk(interp, node->as.property_access.object, for_write, keys, error);
+                if (!container && !keys->has_value) return NULL;
+                if (!container) container = &keys->value;
+                container = frozen_place(container, for_write, error);
+                if (!container) return NULL;
+                
+                if (container->type == VAL_INSTANCE) {
+                    container = &container->as.instance.instance->fields;
+                }
+                if (container->type != VAL_OBJECT && container->type != VAL_STRUCT) {
+                    *error = value_create_exception("نوع غير صالح للوصول للخاصية", 4);
+                    return NULL;
+                }
+                
+                Value *slot = property_lookup(interp, container, node);
+                if (!slot && for_write) {
+                    if (container->type == VAL_STRUCT) {
+                        // لا تضاف حقول إلى هيكل بعد تعريفه
+                        snprintf(error_msg, sizeof(error_msg), "الهيكل '%s' لا يحتوي الحقل '%s'",
+                                 container->as.structure->def->name, node->as.property_access.property);
+                        *error = value_create_exception(error_msg, 11);
+                        return NULL;
+                    }
+                    slot = object_set(container, node->as.property_access.property, value_create_null());
+                } else if (!slot) {
+                    snprintf(error_msg, sizeof(error_msg),
+                             "الخاصية '%s' غير موجودة", node->as.property_access.property);
+                    *error = value_create_exception(error_msg, 8);
+                }
+                return slot;
+            }
+        
+        default:
+            return NULL;
+    }
 }
 
-// إنشاء المفسر
-Interpreter *interpreter_create(void) {
-    Interpreter *interp = malloc(sizeof(Interpreter));
-    interp->global_env = environment_create(NULL, "عالمي");
-    interp->current_env = interp->global_env;
-    interp->return_value = NULL;
-    interp->is_returning = false;
-    interp->is_breaking = false;
-    interp->is_continuing = false;
-    interp->exception = NULL;
-    interp->is_try_block = false;
-    
-    // تعريف الثوابت الأساسية
-    environment_define(interp->global_env, "صحيح", value_create_boolean(true), true);
-    environment_define(interp->global_env, "خطأ", value_create_boolean(false), true);
-    environment_define(interp->global_env, "فارغ", value_create_null(), true);
-    environment_define(interp->global_env, "PI", value_create_number(3.14159265359), true);
-    environment_define(interp->global_env, "E", value_create_number(2.71828182846), true);
+// تحديد الخانة التي يشير إليها تعبير: متغير، عنصر مصفوفة، أو خاصية كائن
+// (تقيم الفهارس كلها ثم تتبع الحاويات من الجذر)
+static Value *resolve_place(Interpreter *interp, ASTNode *node, bool for_write, Value *error) {
+    if (!place_is_rooted(node)) return NULL;
     
-    return interp;
+    PlaceKeys keys;
+    place_keys_init(&keys);
+    Value *slot = NULL;
+    if (place_keys_evaluate(interp, node, &keys, error)) {
+        slot = place_walk(interp, node, for_write, &keys, error);
+    }
+    place_keys_free(&keys);
+    return slot;
 }
 
-// تدمير المفسر
-void interpreter_destroy(Interpreter *interp) {
-    if (!interp) return;
-    
-    environment_destroy(interp->global_env);
-    if (interp->return_value) {
-        value_free(interp->return_value);
-        free(interp->return_value);
+// قراءة تعبير مرة واحدة: خانته إن كان خانة، وإلا قيمته في temp (قيمة مؤقتة، أو عنصر
+// نص أو مدى في السلسلة). تعيد NULL عند الخطأ مع وضع الاستثناء في error
+static Value *read_place(Interpreter *interp, ASTNode *node, Value *temp, Value *error) {
+    if (!place_is_rooted(node)) {
+        *temp = interpreter_evaluate(interp, node);
+        if (temp->type == VAL_EXCEPTION) {
+            *error = *temp;
+            *temp = value_create_null();
+            return NULL;
+        }
+        return temp;
     }
-    if (interp->exception) {
-        value_free(interp->exception);
-        free(interp->exception);
+    
+    PlaceKeys keys;
+    place_keys_init(&keys);
+    Value *slot = NULL;
+    if (place_keys_evaluate(interp, node, &keys, error)) {
+        slot = place_walk(interp, node, false, &keys, error);
+        if (!slot && keys.has_value) {
+            *temp = keys.value;
+            keys.value = value_create_null();
+            slot = temp;
+        }
     }
-    free(interp);
-}
-
-// تعيين متغير
-void interpreter_set_variable(Interpreter *interp, const char *name, Value value) {
-    if (!interp || !name) return;
-    environment_define(interp->global_env, name, value, false);
+    place_keys_free(&keys);
+    return slot;
 }
 
-// الحصول على متغير
-Value *interpreter_get_variable(Interpreter *interp, const char *name) {
-    if (!interp || !name) return NULL;
-    return environment_get(interp->current_env, name);
+// عنصر في حاوية: مفتاح في خريطة أو كائن، عنصر في مصفوفة، أو نص داخل نص
+// الحاوية تقرأ من خانتها دون نسخ فيبقى البحث في الخريطة O(1)
+static Value evaluate_membership(Interpreter *interp, ASTNode *node) {
+    Value item = interpreter_evaluate(interp, node->as.binary_op.left);
+    if (item.type == VAL_EXCEPTION) return item;
+    
+    Value error = value_create_null();
+    Value temp = value_create_null();
+    Value *container = read_place(interp, node->as.binary_op.right, &temp, &error);
+    if (!container) {
+        value_free(&item);
+        return error;
+    }
+    if (container->type == VAL_FROZEN) container = &container->as.frozen->value;
+    
+    Value result;
+    switch (container->type) {
+        case VAL_MAP:
+            result = value_create_boolean(value_is_hashable(&item) && map_get(container, &item) != NULL);
+            break;
+        case VAL_SET:
+            result = value_create_boolean(value_is_hashable(&item) && set_has(container, &item));
+            break;
+        case VAL_VECTOR:
+            {
+                bool found = false;
+                for (int i = 0; i < container->as.vector.count && !found; i++) {
+                    found = value_equals(vector_get(container, i), &item);
+                }
+                result = value_create_boolean(found);
+            }
+            break;
+        case VAL_OBJECT:
+            result = value_create_boolean(item.type == VAL_STRING &&
+                                          object_find(container, item.as.string) >= 0);
+            break;
+        case VAL_RANGE:
+            result = value_create_boolean(range_index_of(container, &item) >= 0);
+            break;
+        case VAL_ARRAY:
+            {
+                bool found = false;
+                for (int i = 0; i < container->as.array.count && !found; i++) {
+                    found = value_equals(container->as.array.items[i], &item);
+                }
+                result = value_create_boolean(found);
+            }
+            break;
+        case VAL_STRING:
+            if (item.type == VAL_STRING) {
+                String *haystack = string_header(container->as.string);
+                String *needle = string_header(item.as.string);
+                bool found = needle->length == 0;
+                for (size_t i = 0; !found && i + needle->length <= haystack->length; i++) {
+                    found = memcmp(haystack->chars + i, needle->chars, needle->length) == 0;
+                }
+                result = value_create_boolean(found);
+            } else {
+                result = value_create_exception("البحث في نص يتطلب نصاً", 4);
+            }
+            break;
+        default:
+            result = value_create_exception("نوع غير صالح للبحث فيه", 4);
+            break;
+    }
+    
+    value_free(&item);
+    value_free(&temp);
+    return result;
 }
 
 // تقييم العقدة
@@ -436,7 +4274,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
     switch (node->type) {
         case AST_LITERAL:
             return value_copy(&node->as.literal.value);
-            
+        
         case AST_IDENTIFIER:
             {
                 Value *val = environment_get(interp->current_env, node->as.identifier.name);
@@ -449,12 +4287,14 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                     return value_create_exception(error_msg, 1);
                 }
             }
-            
+        
         case AST_BINARY_OP:
+            if (node->as.binary_op.op == TOKEN_IN) {
+                return evaluate_membership(interp, node);
+            }
             {
                 Value left = interpreter_evaluate(interp, node->as.binary_op.left);
                 Value right = interpreter_evaluate(interp, node->as.binary_op.right);
-                Value result = value_create_null();
                 
                 if (left.type == VAL_EXCEPTION) {
                     value_free(&right);
@@ -465,92 +4305,9 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                     return right;
                 }
                 
-                switch (node->as.binary_op.op) {
-                    case TOKEN_PLUS:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_number(left.as.number + right.as.number);
-                        } else if (left.type == VAL_STRING || right.type == VAL_STRING) {
-                            char *ls = value_to_string(&left);
-                            char *rs = value_to_string(&right);
-                            char *combined = malloc(strlen(ls) + strlen(rs) + 1);
-                            strcpy(combined, ls);
-                            strcat(combined, rs);
-                            result = value_create_string(combined);
-                            free(ls);
-                            free(rs);
-                            free(combined);
-                        }
-                        break;
-                    case TOKEN_MINUS:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_number(left.as.number - right.as.number);
-                        }
-                        break;
-                    case TOKEN_MULTIPLY:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_number(left.as.number * right.as.number);
-                        }
-                        break;
-                    case TOKEN_DIVIDE:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            if (right.as.number != 0) {
-                                result = value_create_number(left.as.number / right.as.number);
-                            } else {
-                                result = value_create_exception("قسمة على صفر", 2);
-                            }
-                        }
-                        break;
-                    case TOKEN_MODULO:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_number(fmod(left.as.number, right.as.number));
-                        }
-                        break;
-                    case TOKEN_POWER:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_number(pow(left.as.number, right.as.number));
-                        }
-                        break;
-                    case TOKEN_EQUAL:
-                        result = value_create_boolean(value_equals(&left, &right));
-                        break;
-                    case TOKEN_NOT_EQUAL:
-                        result = value_create_boolean(!value_equals(&left, &right));
-                        break;
-                    case TOKEN_GREATER:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_boolean(left.as.number > right.as.number);
-                        }
-                        break;
-                    case TOKEN_LESS:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_boolean(left.as.number < right.as.number);
-                        }
-                        break;
-                    case TOKEN_GREATER_EQ:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_boolean(left.as.number >= right.as.number);
-                        }
-                        break;
-                    case TOKEN_LESS_EQ:
-                        if (left.type == VAL_NUMBER && right.type == VAL_NUMBER) {
-                            result = value_create_boolean(left.as.number <= right.as.number);
-                        }
-                        break;
-                    case TOKEN_AND:
-                        result = value_create_boolean(value_is_truthy(&left) && value_is_truthy(&right));
-                        break;
-                    case TOKEN_OR:
-                        result = value_create_boolean(value_is_truthy(&left) || value_is_truthy(&right));
-                        break;
-                    default:
-                        break;
-                }
-                
-                value_free(&left);
-                value_free(&right);
-                return result;
+                return binary_operation(node->as.binary_op.op, left, right);
             }
-            
+        
         case AST_UNARY_OP:
             {
                 Value operand = interpreter_evaluate(interp, node->as.unary_op.operand);
@@ -562,10 +4319,26 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 
                 switch (node->as.unary_op.op) {
                     case TOKEN_MINUS:
-                        if (operand.type == VAL_NUMBER) {
+                        if (operand.type == VAL_INT) {
+                            if (operand.as.integer == INT64_MIN) {
+                                result = value_create_number(-(double)operand.as.integer);
+                            } else {
+                                result = value_create_int(-operand.as.integer);
+                            }
+                        } else if (operand.type == VAL_NUMBER) {
                             result = value_create_number(-operand.as.number);
                         }
                         break;
+                    case TOKEN_BIT_NOT:
+                        {
+                            int64_t x;
+                            if (value_to_int(&operand, &x)) {
+                                result = value_create_int(~x);
+                            } else {
+                                result = value_create_exception("العمليات على البتات تتطلب أعداداً صحيحة", 6);
+                            }
+                        }
+                        break;
                     case TOKEN_NOT:
                         result = value_create_boolean(!value_is_truthy(&operand));
                         break;
@@ -576,7 +4349,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 value_free(&operand);
                 return result;
             }
-            
+        
         case AST_PRINT:
             {
                 Value val = interpreter_evaluate(interp, node->as.print.expression);
@@ -589,7 +4362,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 value_free(&val);
                 return value_create_null();
             }
-            
+        
         case AST_INPUT:
             {
                 if (node->as.input.prompt) {
@@ -603,7 +4376,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 }
                 return value_create_null();
             }
-            
+        
         case AST_LET:
         case AST_CONST:
             {
@@ -615,8 +4388,16 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 environment_define(interp->current_env, node->as.let.name, val, is_const);
                 return value_create_null();
             }
-            
+        
         case AST_ASSIGN:
+            if (node->as.assign.is_append) {
+                // س = س + تعبير: إلحاق مباشر في خانة المتغير دون نسخ النص
+                Value *slot = environment_get(interp->current_env, node->as.assign.name);
+                if (slot && slot->type == VAL_STRING &&
+                    !environment_is_constant(interp->current_env, node->as.assign.name)) {
+                    return append_operands(interp, slot, node->as.assign.value);
+                }
+            }
             {
                 Value val = interpreter_evaluate(interp, node->as.assign.value);
                 if (val.type == VAL_EXCEPTION) {
@@ -625,7 +4406,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 environment_set(interp->current_env, node->as.assign.name, val);
                 return value_create_null();
             }
-            
+        
         case AST_IF:
             {
                 Value cond = interpreter_evaluate(interp, node->as.if_stmt.condition);
@@ -644,7 +4425,81 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 
                 return value_create_null();
             }
-            
+        
+        case AST_SWITCH:
+            {
+                Value subject = interpreter_evaluate(interp, node->as.switch_stmt.expression);
+                if (subject.type == VAL_EXCEPTION) return subject;
+                
+                // البحث في الجداول المبنية عند التحليل، ثم الحالات غير الثابتة التي تسبقها
+                int found = -1;
+                if (node->as.switch_stmt.jump_table && subject.type == VAL_INT) {
+                    uint64_t offset = (uint64_t)subject.as.integer - (uint64_t)node->as.switch_stmt.jump_min;
+                    if (offset < (uint64_t)node->as.switch_stmt.jump_size) {
+                        found = node->as.switch_stmt.jump_table[offset] - 1;
+                    }
+                } else if (node->as.switch_stmt.jump_table && subject.type == VAL_NUMBER) {
+                    // المدى يفحص قبل التحويل إلى عدد صحيح (ويرفض NaN واللانهاية)
+                    double number = subject.as.number;
+                    double offset = number - (double)node->as.switch_stmt.jump_min;
+                    if (offset >= 0 && offset < node->as.switch_stmt.jump_size && number == floor(number)) {
+                        found = node->as.switch_stmt.jump_table[(int)offset] - 1;
+                    }
+                }
+                if (found < 0 && node->as.switch_stmt.label_table) {
+                    unsigned int mask = (unsigned int)node->as.switch_stmt.label_capacity - 1;
+                    unsigned int slot = value_hash(&subject) & mask;
+                    while (node->as.switch_stmt.label_table[slot] != 0) {
+                        int index = node->as.switch_stmt.label_table[slot] - 1;
+                        ASTNode *label = node->as.switch_stmt.cases[index]->as.case_stmt.value;
+                        if (value_equals(&label->as.literal.value, &subject)) {
+                            found = index;
+                            break;
+                        }
+                        slot = (slot + 1) & mask;
+                    }
+                }
+                for (int i = 0; i < node->as.switch_stmt.dynamic_count; i++) {
+                    int index = node->as.switch_stmt.dynamic_cases[i];
+                    if (found >= 0 && index > found) break;
+                    Value label = interpreter_evaluate(interp, node->as.switch_stmt.cases[index]->as.case_stmt.value);
+                    if (label.type == VAL_EXCEPTION) {
+                        value_free(&subject);
+                        return label;
+                    }
+                    bool match = value_equals(&label, &subject);
+                    value_free(&label);
+                    if (match) {
+                        found = index;
+                        break;
+                    }
+                }
+                value_free(&subject);
+                
+                ASTNode **statements = NULL;
+                int statement_count = 0;
+                if (found >= 0) {
+                    statements = node->as.switch_stmt.cases[found]->as.case_stmt.statements;
+                    statement_count = node->as.switch_stmt.cases[found]->as.case_stmt.statement_count;
+                } else if (node->as.switch_stmt.default_case) {
+                    statements = node->as.switch_stmt.default_case->as.default_stmt.statements;
+                    statement_count = node->as.switch_stmt.default_case->as.default_stmt.statement_count;
+                }
+                
+                Value result = value_create_null();
+                for (int i = 0; i < statement_count; i++) {
+                    value_free(&result);
+                    result = interpreter_evaluate(interp, statements[i]);
+                    if (result.type == VAL_EXCEPTION || interp->is_returning ||
+                        interp->is_breaking || interp->is_continuing) {
+                        break;
+                    }
+                }
+                // 'توقف' داخل الحالة تخرج من الاختيار فقط
+                interp->is_breaking = false;
+                return result;
+            }
+        
         case AST_WHILE:
             {
                 Value result = value_create_null();
@@ -686,11 +4541,17 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 
                 return result;
             }
-            
+        
         case AST_FOR:
             {
                 Value result = value_create_null();
                 
+                // العمال ينفذون الحلقات المتداخلة تسلسلياً
+                if (node->as.for_loop.is_parallel && !interp->is_worker &&
+                    parallel_for(interp, node, &result)) {
+                    return result;
+                }
+                
                 // إنشاء بيئة جديدة للحلقة
                 Environment *loop_env = environment_create(interp->current_env, "حلقة");
                 interp->current_env = loop_env;
@@ -700,11 +4561,11 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 environment_define(loop_env, node->as.for_loop.var_name, start_val, false);
                 
                 Value end_val = interpreter_evaluate(interp, node->as.for_loop.end);
-                double end = end_val.as.number;
+                double end = value_as_number(&end_val);
                 
                 while (true) {
                     Value *current = environment_get(loop_env, node->as.for_loop.var_name);
-                    if (!current || current->as.number > end) break;
+                    if (!current || value_as_number(current) > end) break;
                     
                     value_free(&result);
                     result = interpreter_evaluate(interp, node->as.for_loop.body);
@@ -731,7 +4592,8 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                     }
                     
                     // زيادة العداد
-                    current->as.number++;
+                    if (current->type == VAL_INT) current->as.integer++;
+                    else current->as.number++;
                 }
                 
                 interp->current_env = loop_env->parent;
@@ -740,7 +4602,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 value_free(&end_val);
                 return result;
             }
-            
+        
         case AST_ARRAY:
             {
                 Value arr = value_create_array();
@@ -763,44 +4625,176 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 }
                 return arr;
             }
-            
+        
         case AST_ARRAY_ACCESS:
             {
-                Value arr = interpreter_evaluate(interp, node->as.array_access.array);
-                if (arr.type == VAL_EXCEPTION) return arr;
-                
-                Value idx = interpreter_evaluate(interp, node->as.array_access.index);
-                if (idx.type == VAL_EXCEPTION) {
-                    value_free(&arr);
-                    return idx;
+                // القراءة من خانة المتغير مباشرة دون نسخ الحاوية كاملة، بعد تقييم
+                // كل الفهارس (ومنها فهرس هذا الوصول) فلا يغير تقييمها الحاوية أثناء قراءتها
+                Value error = value_create_null();
+                Value temp = value_create_null();
+                Value idx = value_create_null();
+                Value *arr = NULL;
+                if (place_is_rooted(node->as.array_access.array)) {
+                    PlaceKeys keys;
+                    place_keys_init(&keys);
+                    if (place_keys_evaluate(interp, node, &keys, &error)) {
+                        idx = keys.items[--keys.count];
+                        arr = place_walk(interp, node->as.array_access.array, false, &keys, &error);
+                        // بعد نص أو مدى في السلسلة تقرأ قيمتها دون إعادة تقييم شيء
+                        if (!arr && keys.has_value) {
+                            temp = keys.value;
+                            keys.value = value_create_null();
+                            arr = &temp;
+                        }
+                    }
+                    place_keys_free(&keys);
+                    if (!arr) {
+                        value_free(&idx);
+                        return error;
+                    }
+                } else {
+                    temp = interpreter_evaluate(interp, node->as.array_access.array);
+                    if (temp.type == VAL_EXCEPTION) return temp;
+                    arr = &temp;
+                    idx = interpreter_evaluate(interp, node->as.array_access.index);
+                    if (idx.type == VAL_EXCEPTION) {
+                        value_free(&temp);
+                        return idx;
+                    }
                 }
                 
-                Value result = value_create_null();
+                Value result = index_read(arr, &idx);
                 
-                if (arr.type == VAL_ARRAY && idx.type == VAL_NUMBER) {
-                    int index = (int)idx.as.number;
-                    if (index >= 0 && index < arr.as.array.count) {
-                        result = value_copy(arr.as.array.items[index]);
-                    } else {
-                        result = value_create_exception("فهرس خارج النطاق", 3);
-                    }
-                } else if (arr.type == VAL_STRING && idx.type == VAL_NUMBER) {
-                    int index = (int)idx.as.number;
-                    if (index >= 0 && index < (int)strlen(arr.as.string)) {
-                        char ch[2] = {arr.as.string[index], '\0'};
-                        result = value_create_string(ch);
+                value_free(&temp);
+                value_free(&idx);
+                return result;
+            }
+        
+        case AST_PROPERTY_ACCESS:
+            {
+                Value error = value_create_null();
+                Value temp = value_create_null();
+                Value *obj = read_place(interp, node->as.property_access.object, &temp, &error);
+                if (!obj) return error;
+                if (obj->type == VAL_FROZEN) obj = &obj->as.frozen->value;
+                
+                Value result;
+                if (obj->type != VAL_OBJECT && obj->type != VAL_STRUCT && obj->type != VAL_INSTANCE) {
+                    result = value_create_exception("نوع غير صالح للوصول للخاصية", 4);
+                } else {
+                    Value *field = property_lookup(interp, obj, node);
+                    if (field) {
+                        result = value_copy(field);
                     } else {
-                        result = value_create_exception("فهرس خارج النطاق", 3);
+                        char error_msg[256];
+                        snprintf(error_msg, sizeof(error_msg),
+                                 "الخاصية '%s' غير موجودة", node->as.property_access.property);
+                        result = value_create_exception(error_msg, 8);
                     }
-                } else {
-                    result = value_create_exception("نوع غير صالح للوصول بالفهرس", 4);
                 }
                 
-                value_free(&arr);
-                value_free(&idx);
+                value_free(&temp);
                 return result;
             }
-            
+        
+        case AST_OBJECT:
+            {
+                Value obj = value_create_object();
+                for (int i = 0; i < node->as.object.count; i++) {
+                    Value val = interpreter_evaluate(interp, node->as.object.values[i]);
+                    if (val.type == VAL_EXCEPTION) {
+                        value_free(&obj);
+                        return val;
+                    }
+                    object_set(&obj, node->as.object.keys[i], val);
+                }
+                return obj;
+            }
+        
+        case AST_MAP:
+            {
+                Value map = value_create_map();
+                for (int i = 0; i < node->as.map.count; i++) {
+                    Value key = interpreter_evaluate(interp, node->as.map.keys[i]);
+                    if (key.type == VAL_EXCEPTION) {
+                        value_free(&map);
+                        return key;
+                    }
+                    if (!value_is_hashable(&key)) {
+                        value_free(&key);
+                        value_free(&map);
+                        return value_create_exception("المفتاح غير قابل للتجزئة", 14);
+                    }
+                    Value val = interpreter_evaluate(interp, node->as.map.values[i]);
+                    if (val.type == VAL_EXCEPTION) {
+                        value_free(&key);
+                        value_free(&map);
+                        return val;
+                    }
+                    map_set(&map, key, val);
+                }
+                return map;
+            }
+        
+        case AST_STRUCT_DEF:
+            {
+                Value def;
+                def.type = VAL_STRUCT_DEF;
+                def.as.struct_def.def = node->as.struct_def.layout;
+                environment_define(interp->current_env, node->as.struct_def.name, def, true);
+                return value_create_null();
+            }
+        
+        case AST_STRUCT_CREATE:
+            {
+                // مواضع الحقول محسوبة عند التحليل فتملأ الخانات مباشرة
+                StructDef *def = node->as.struct_create.layout;
+                Value instance = value_create_struct(def);
+                for (int i = 0; i < def->shape->count; i++) {
+                    if (!node->as.struct_create.values[i]) continue;
+                    Value val = interpreter_evaluate(interp, node->as.struct_create.values[i]);
+                    if (val.type == VAL_EXCEPTION) {
+                        value_free(&instance);
+                        return val;
+                    }
+                    instance.as.structure->fields[i] = val;
+                }
+                return instance;
+            }
+        
+        case AST_INDEX_ASSIGN:
+        case AST_PROPERTY_ASSIGN:
+            {
+                // التعديل في مكان العنصر داخل الحاوية دون إعادة بنائها
+                Value val = interpreter_evaluate(interp, node->as.place_assign.value);
+                if (val.type == VAL_EXCEPTION) return val;
+                
+                Value error = value_create_null();
+                Value *slot = resolve_place(interp, node->as.place_assign.target, true, &error);
+                if (!slot) {
+                    value_free(&val);
+                    if (error.type == VAL_EXCEPTION) return error;
+                    return value_create_exception("الهدف غير قابل للتعيين", 10);
+                }
+                
+                if (node->as.place_assign.op == TOKEN_ASSIGN) {
+                    value_free(slot);
+                    *slot = val;
+                } else if (node->as.place_assign.op == TOKEN_PLUS && slot->type == VAL_STRING) {
+                    char *str = val.type == VAL_STRING ? val.as.string : value_to_string(&val);
+                    size_t length = val.type == VAL_STRING ? string_length(str) : strlen(str);
+                    slot->as.string = string_append(slot->as.string, str, length);
+                    if (val.type != VAL_STRING) free(str);
+                    value_free(&val);
+                } else {
+                    Value result = binary_operation(node->as.place_assign.op, value_copy(slot), val);
+                    if (result.type == VAL_EXCEPTION) return result;
+                    value_free(slot);
+                    *slot = result;
+                }
+                return value_create_null();
+            }
+        
         case AST_FUNCTION_CALL:
             {
                 // البحث عن الدالة
@@ -813,83 +4807,280 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 }
                 
                 // تقييم المعاملات
-                Value *args = malloc(sizeof(Value) * node->as.function_call.arg_count);
-                for (int i = 0; i < node->as.function_call.arg_count; i++) {
-                    args[i] = interpreter_evaluate(interp, node->as.function_call.args[i]);
-                    if (args[i].type == VAL_EXCEPTION) {
-                        for (int j = 0; j < i; j++) {
-                            value_free(&args[j]);
-                        }
-                        free(args);
-                        return args[i];
+                Value error;
+                Value *args = evaluate_args(interp, node->as.function_call.args,
+                                            node->as.function_call.arg_count, &error);
+                if (!args) return error;
+                
+                return call_value(interp, func_val, args, node->as.function_call.arg_count);
+            }
+        
+        case AST_FUNCTION_DEF:
+            {
+                Value func = value_create_function(node->as.function_def.name,
+                                                   node->as.function_def.params,
+                                                   node->as.function_def.param_count,
+                                                   node->as.function_def.body);
+                // الدوال غير المتزامنة والمولدة لا تحفظ نتائجها: كل استدعاء يعيد وعداً أو مولداً جديداً
+                func.as.function.is_async = node->as.function_def.is_async;
+                func.as.function.is_generator = node->as.function_def.is_generator;
+                if (!func.as.function.is_async && !func.as.function.is_generator) {
+                    func.as.function.memo = memo_create(node->as.function_def.name);
+                }
+                environment_define(interp->current_env, node->as.function_def.name, func, false);
+                return value_create_null();
+            }
+        
+        case AST_CLASS_DEF:
+            {
+                Class *parent = NULL;
+                if (node->as.class_def.parent_name) {
+                    Value *parent_val = environment_get(interp->current_env, node->as.class_def.parent_name);
+                    if (!parent_val || parent_val->type != VAL_CLASS_DEF) {
+                        char error_msg[256];
+                        snprintf(error_msg, sizeof(error_msg),
+                                 "الصنف الأب '%s' غير معرف", node->as.class_def.parent_name);
+                        return value_create_exception(error_msg, 13);
                     }
+                    parent = parent_val->as.class_def.def;
                 }
                 
-                // استدعاء الدالة الأصلية
-                if (func_val->as.function.is_native) {
-                    Value result = func_val->as.function.native_fn(args, node->as.function_call.arg_count);
-                    for (int i = 0; i < node->as.function_call.arg_count; i++) {
-                        value_free(&args[i]);
+                // الحقول: حقول الأب أولاً ثم الجديدة
+                int parent_fields = parent ? parent->field_count : 0;
+                char **fields = malloc(sizeof(char*) * (parent_fields + node->as.class_def.field_count + 1));
+                int field_count = 0;
+                for (int i = 0; i < parent_fields; i++) {
+                    fields[field_count++] = parent->fields[i];
+                }
+                for (int i = 0; i < node->as.class_def.field_count; i++) {
+                    bool inherited = false;
+                    for (int j = 0; j < parent_fields; j++) {
+                        if (strcmp(parent->fields[j], node->as.class_def.fields[i]) == 0) inherited = true;
                     }
-                    free(args);
-                    return result;
+                    if (!inherited) fields[field_count++] = node->as.class_def.fields[i];
+                }
+                Value class_val = value_create_class(node->as.class_def.name, fields, field_count);
+                free(fields);
+                
+                // بناء جدول الدوال المسطح: نسخة من جدول الأب بالمواضع نفسها
+                Class *cls = class_val.as.class_def.def;
+                cls->parent = parent;
+                int parent_methods = parent ? parent->method_count : 0;
+                cls->vtable = malloc(sizeof(Value) * (parent_methods + node->as.class_def.method_count + 1));
+                if (parent) {
+                    cls->method_shape = parent->method_shape;
+                    memcpy(cls->vtable, parent->vtable, sizeof(Value) * parent_methods);
+                    cls->method_count = parent_methods;
                 }
                 
-                // إنشاء بيئة جديدة للدالة
-                Environment *func_env = environment_create(
-                    func_val->as.function.closure ? func_val->as.function.closure : interp->global_env, 
-                    node->as.function_call.name
-                );
-                func_env->is_function_scope = true;
+                for (int i = 0; i < node->as.class_def.method_count; i++) {
+                    ASTNode *def = node->as.class_def.methods[i];
+                    Value method = value_create_function(def->as.function_def.name,
+                                                         def->as.function_def.params,
+                                                         def->as.function_def.param_count,
+                                                         def->as.function_def.body);
+                    int slot = shape_find(cls->method_shape, def->as.function_def.name);
+                    if (slot < 0) {
+                        cls->method_shape = shape_transition(cls->method_shape, def->as.function_def.name);
+                        slot = cls->method_count++;
+                    }
+                    cls->vtable[slot] = method;
+                }
                 
-                // تعريف المعاملات
-                for (int i = 0; i < func_val->as.function.param_count && i < node->as.function_call.arg_count; i++) {
-                    environment_define(func_env, func_val->as.function.params[i], args[i], false);
+                environment_define(interp->current_env, node->as.class_def.name, class_val, true);
+                return value_create_null();
+            }
+        
+        case AST_NEW:
+            {
+                Value *class_val = environment_get(interp->current_env, node->as.new_stmt.class_name);
+                if (!class_val || class_val->type != VAL_CLASS_DEF) {
+                    char error_msg[256];
+                    snprintf(error_msg, sizeof(error_msg),
+                             "الصنف '%s' غير معرف", node->as.new_stmt.class_name);
+                    return value_create_exception(error_msg, 13);
                 }
+                Class *cls = class_val->as.class_def.def;
                 
+                Value error;
+                Value *args = evaluate_args(interp, node->as.new_stmt.args, node->as.new_stmt.arg_count, &error);
+                if (!args) return error;
+                
+                Value instance = value_create_instance(cls);
+                int slot = shape_find(cls->method_shape, "تهيئة");
+                if (slot >= 0) {
+                    Value result = call_function(interp, &cls->vtable[slot], args,
+                                                 node->as.new_stmt.arg_count, &instance);
+                    if (result.type == VAL_EXCEPTION) {
+                        value_free(&instance);
+                        free(args);
+                        return result;
+                    }
+                    value_free(&result);
+                } else {
+                    for (int i = 0; i < node->as.new_stmt.arg_count; i++) {
+                        value_free(&args[i]);
+                    }
+                }
                 free(args);
+                return instance;
+            }
+        
+        case AST_THIS:
+            {
+                Value *self = environment_get(interp->current_env, "هذا");
+                if (!self) {
+                    return value_create_exception("'هذا' متاحة داخل دوال الصنف فقط", 12);
+                }
+                return value_copy(self);
+            }
+        
+        case AST_METHOD_CALL:
+            {
+                Value error = value_create_null();
+                Value receiver = value_create_null();
+                Value *self = read_place(interp, node->as.method_call.object, &receiver, &error);
+                if (!self) return error;
+                
+                if (self->type != VAL_INSTANCE) {
+                    value_free(&receiver);
+                    return value_create_exception("نوع غير صالح لاستدعاء دالة", 4);
+                }
+                
+                // الذاكرة المؤقتة المضمنة: إن طابق الصنف آخر صنف رؤي هنا فالموضع معروف
+                // (والعامل يبحث كل مرة: العقدة مشتركة مع خيوط قد تكتبها)
+                Class *cls = self->as.instance.class_def;
+                int slot = -1;
+                if (!interp->is_worker && cls == node->as.method_call.cache_class) {
+                    slot = node->as.method_call.cache_index;
+                }
+                if (slot < 0) {
+                    slot = shape_find(cls->method_shape, node->as.method_call.method_name);
+                    if (slot < 0) {
+                        char error_msg[256];
+                        snprintf(error_msg, sizeof(error_msg), "الدالة '%s' غير معرفة في الصنف '%s'",
+                                 node->as.method_call.method_name, cls->name);
+                        value_free(&receiver);
+                        return value_create_exception(error_msg, 5);
+                    }
+                    if (!interp->is_worker) {
+                        node->as.method_call.cache_class = cls;
+                        node->as.method_call.cache_index = slot;
+                    }
+                }
                 
-                // تنفيذ جسم الدالة
-                Environment *prev_env = interp->current_env;
-                interp->current_env = func_env;
+                // نسخة مرجعية تبقي النسخة حية أثناء الاستدعاء ولو أعيد تعيين متغيرها
+                Value this_ref = value_copy(self);
+                value_free(&receiver);
                 
-                Value result = interpreter_evaluate(interp, func_val->as.function.body);
+                Value *args = evaluate_args(interp, node->as.method_call.args,
+                                            node->as.method_call.arg_count, &error);
+                if (!args) {
+                    value_free(&this_ref);
+                    return error;
+                }
+                
+                Value result = call_function(interp, &cls->vtable[slot],
+                                             args, node->as.method_call.arg_count, &this_ref);
+                free(args);
+                value_free(&this_ref);
+                return result;
+            }
+        
+        case AST_YIELD:
+            {
+                if (!current_task || !current_task->is_generator) {
+                    return value_create_exception("'أنتج' خارج دالة مولدة", 16);
+                }
+                Value value = node->as.yield_stmt.value ?
+                    interpreter_evaluate(interp, node->as.yield_stmt.value) : value_create_null();
+                if (value.type == VAL_EXCEPTION) return value;
+                
+                Task *task = current_task;
+                task->yielded = value;
+                task->has_yielded = true;
+                task_suspend(interp);
+                if (task->closing) {
+                    return value_create_exception("أغلق المولد", 16);
+                }
+                return value_create_null();
+            }
+        
+        case AST_FOREACH:
+            {
+                Value collection = interpreter_evaluate(interp, node->as.for_each.collection);
+                if (collection.type == VAL_EXCEPTION) return collection;
+                if (!value_is_iterable(&collection)) {
+                    value_free(&collection);
+                    return value_create_exception("نوع غير صالح للمرور على عناصره", 4);
+                }
                 
-                interp->current_env = prev_env;
-                environment_destroy(func_env);
+                Value result = value_create_null();
+                Environment *loop_env = environment_create(interp->current_env, "حلقة");
+                interp->current_env = loop_env;
+                environment_define(loop_env, node->as.for_each.var_name, value_create_null(), false);
                 
-                if (interp->is_returning) {
-                    interp->is_returning = false;
-                    Value return_val = value_copy(interp->return_value);
-                    if (interp->return_value) {
-                        value_free(interp->return_value);
-                        free(interp->return_value);
-                        interp->return_value = NULL;
+                // العناصر تسحب واحداً واحداً، فالمولد لا ينتج إلا ما تطلبه الحلقة
+                int64_t position = 0;
+                Value item;
+                while (value_iterate(&collection, &position, &item)) {
+                    if (item.type == VAL_EXCEPTION) {
+                        value_free(&result);
+                        result = item;
+                        break;
+                    }
+                    Value *slot = environment_get(loop_env, node->as.for_each.var_name);
+                    value_free(slot);
+                    *slot = item;
+                    
+                    value_free(&result);
+                    result = interpreter_evaluate(interp, node->as.for_each.body);
+                    if (result.type == VAL_EXCEPTION || interp->is_returning) break;
+                    
+                    if (interp->is_breaking) {
+                        interp->is_breaking = false;
+                        break;
+                    }
+                    if (interp->is_continuing) {
+                        interp->is_continuing = false;
                     }
-                    return return_val;
                 }
                 
+                value_iterate_end(&collection, &position);
+                interp->current_env = loop_env->parent;
+                environment_destroy(loop_env);
+                value_free(&collection);
                 return result;
             }
-            
+        
+        case AST_AWAIT:
+            {
+                Value promise = interpreter_evaluate(interp, node->as.await_stmt.promise);
+                if (promise.type == VAL_EXCEPTION) return promise;
+                return await_promise(interp, promise);
+            }
+        
         case AST_RETURN:
             {
                 if (node->as.return_stmt.value) {
+                    // التقييم أولاً: قد يستدعي التعبير دوال تستخدم return_value
+                    Value val = interpreter_evaluate(interp, node->as.return_stmt.value);
+                    if (val.type == VAL_EXCEPTION) return val;
                     interp->return_value = malloc(sizeof(Value));
-                    *interp->return_value = interpreter_evaluate(interp, node->as.return_stmt.value);
+                    *interp->return_value = val;
                 }
                 interp->is_returning = true;
                 return value_create_null();
             }
-            
+        
         case AST_BREAK:
             interp->is_breaking = true;
             return value_create_null();
-            
+        
         case AST_CONTINUE:
             interp->is_continuing = true;
             return value_create_null();
-            
+        
         case AST_PROGRAM:
             {
                 Value result = value_create_null();
@@ -907,7 +5098,7 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
                 }
                 return result;
             }
-            
+        
         default:
             return value_create_exception("نوع عقدة غير مدعوم", 99);
     }
@@ -917,12 +5108,17 @@ Value interpreter_evaluate(Interpreter *interp, ASTNode *node) {
 void interpreter_run(Interpreter *interp, ASTNode *program) {
     if (!interp || !program) return;
     
+    // يبقى المفسر الجاري لخيطه بعد التنفيذ، فيستدعي المضيف المكتبات بحالة برنامجه
+    native_caller = interp;
     Value result = interpreter_evaluate(interp, program);
     
     if (result.type == VAL_EXCEPTION) {
         char *str = value_to_string(&result);
         fprintf(stderr, "خطأ: %s\n", str);
         free(str);
+    } else {
+        // إكمال المهام والمؤقتات المعلقة قبل الخروج
+        event_loop_run();
     }
     
     value_free(&result);
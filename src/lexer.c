@@ -53,6 +53,7 @@ static struct {
     {"نفذ", TOKEN_DO},
     {"حتى", TOKEN_UNTIL},
     {"لكل_عنصر", TOKEN_FOREACH},
+    {"لكل_متوازي", TOKEN_PARALLEL_FOR},
     {"أنتج", TOKEN_YIELD},
     {"انتج", TOKEN_YIELD},
     {"غير_متزامن", TOKEN_ASYNC},
@@ -216,6 +217,13 @@ static bool is_arabic_char(unsigned char c) {
     return (c >= 0x80);
 }
 
+// الفاصلة العربية (،) والفاصلة المنقوطة العربية (؛) محرفان من بايتين في UTF-8
+// يبدآن ببايت الحروف العربية نفسه، فيميزان قبل قراءة المعرفات
+static bool is_arabic_punctuation(Lexer *lexer) {
+    unsigned char next = (unsigned char)lexer_peek_next(lexer);
+    return (unsigned char)lexer_peek(lexer) == 0xD8 && (next == 0x8C || next == 0x9B);
+}
+
 // التحقق من بداية حرف UTF-8
 static bool is_utf8_start(unsigned char c) {
     return (c & 0xC0) != 0x80;
@@ -265,6 +273,30 @@ static Token read_number(Lexer *lexer) {
     bool has_dot = false;
     bool has_exp = false;
     
+    // رقم ست عشري: 0x متبوعة بمرتبة واحدة على الأقل، ولا تزيد على 16 مرتبة (64 بت)
+    if (lexer_peek(lexer) == '0' && (lexer_peek_next(lexer) == 'x' || lexer_peek_next(lexer) == 'X')) {
+        buffer[i++] = lexer_advance(lexer);
+        buffer[i++] = lexer_advance(lexer);
+        int digits = 0;
+        while (isxdigit((unsigned char)lexer_peek(lexer))) {
+            char c = lexer_advance(lexer);
+            if (i < MAX_TOKEN_LENGTH - 1) buffer[i++] = c;
+            digits++;
+        }
+        buffer[i] = '\0';
+        
+        if (digits == 0 || digits > 16) {
+            char error_msg[256];
+            snprintf(error_msg, sizeof(error_msg),
+                     digits == 0 ? "رقم ست عشري بلا مراتب بعد 0x (السطر %d، العمود %d)" :
+                                   "رقم ست عشري أطول من 64 بت (السطر %d، العمود %d)",
+                     start_line, start_col);
+            free(lexer->error_message);
+            lexer->error_message = strdup(error_msg);
+        }
+        return create_token(TOKEN_NUMBER, buffer, start_line, start_col, lexer->filename);
+    }
+    
     while ((isdigit(lexer_peek(lexer)) || lexer_peek(lexer) == '.' || 
             lexer_peek(lexer) == 'e' || lexer_peek(lexer) == 'E' ||
             lexer_peek(lexer) == '+' || lexer_peek(lexer) == '-') && i < MAX_TOKEN_LENGTH - 1) {
@@ -299,7 +331,7 @@ static Token read_identifier(Lexer *lexer) {
     // قراءة الحروف العربية والإنجليزية والأرقام والشرطة السفلية
     while ((is_arabic_char((unsigned char)lexer_peek(lexer)) || 
             isalnum((unsigned char)lexer_peek(lexer)) || 
-            lexer_peek(lexer) == '_') && i < MAX_TOKEN_LENGTH - 1) {
+            lexer_peek(lexer) == '_') && !is_arabic_punctuation(lexer) && i < MAX_TOKEN_LENGTH - 1) {
         buffer[i++] = lexer_advance(lexer);
     }
     
@@ -367,6 +399,16 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
             continue;
         }
         
+        // الفواصل العربية
+        if (is_arabic_punctuation(lexer)) {
+            bool comma = (unsigned char)lexer_peek_next(lexer) == 0x8C;
+            tokens[count++] = create_token(comma ? TOKEN_COMMA : TOKEN_SEMICOLON,
+                                           comma ? "," : ";", line, col, lexer->filename);
+            lexer_advance(lexer);
+            lexer_advance(lexer);
+            continue;
+        }
+        
         // المعرفات والكلمات المفتاحية
         if (is_arabic_char((unsigned char)c) || isalpha((unsigned char)c) || c == '_') {
             tokens[count++] = read_identifier(lexer);
@@ -385,7 +427,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '!':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -396,7 +438,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '<':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -411,7 +453,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '>':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -426,7 +468,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '+':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -441,7 +483,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '-':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -456,7 +498,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '*':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -467,7 +509,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '/':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -478,7 +520,7 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '%':
                 if (lexer_peek_next(lexer) == '=') {
                     lexer_advance(lexer);
@@ -489,79 +531,77 @@ Token *lexer_tokenize(Lexer *lexer, int *token_count) {
                     lexer_advance(lexer);
                 }
                 break;
-                
+            
             case '^':
                 tokens[count++] = create_token(TOKEN_POWER, "^", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '(':
                 tokens[count++] = create_token(TOKEN_LPAREN, "(", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case ')':
                 tokens[count++] = create_token(TOKEN_RPAREN, ")", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '{':
                 tokens[count++] = create_token(TOKEN_LBRACE, "{", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '}':
                 tokens[count++] = create_token(TOKEN_RBRACE, "}", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '[':
                 tokens[count++] = create_token(TOKEN_LBRACKET, "[", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case ']':
                 tokens[count++] = create_token(TOKEN_RBRACKET, "]", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case ',':
-            case '،':
                 tokens[count++] = create_token(TOKEN_COMMA, ",", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '.':
                 tokens[count++] = create_token(TOKEN_DOT, ".", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case ':':
                 tokens[count++] = create_token(TOKEN_COLON, ":", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case ';':
-            case '؛':
                 tokens[count++] = create_token(TOKEN_SEMICOLON, ";", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '&':
                 tokens[count++] = create_token(TOKEN_BIT_AND, "&", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '|':
                 tokens[count++] = create_token(TOKEN_BIT_OR, "|", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             case '~':
                 tokens[count++] = create_token(TOKEN_BIT_NOT, "~", line, col, lexer->filename);
                 lexer_advance(lexer);
                 break;
-                
+            
             default:
                 // حرف غير معروف
                 {
@@ -40,14 +40,41 @@ typedef struct {
     bool trained;
 } NeuralNetwork;
 
-static Mind minds[MAX_MINDS];
-static int mind_count = 0;
+// حالة المكتبة لكل مفسر: العقول والأنظمة والشبكات التي أنشأها برنامجه
+struct AIState {
+    Mind minds[MAX_MINDS];
+    int mind_count;
+    AISystem systems[MAX_SYSTEMS];
+    int system_count;
+    NeuralNetwork neural_nets[MAX_NEURAL];
+    int neural_count;
+};
 
-static AISystem systems[MAX_SYSTEMS];
-static int system_count = 0;
+static AIState *ai_state(void) {
+    LibraryContext *libs = library_context();
+    if (!libs->ai) libs->ai = calloc(1, sizeof(AIState));
+    return libs->ai;
+}
 
-static NeuralNetwork neural_nets[MAX_NEURAL];
-static int neural_count = 0;
+void lib_ai_state_free(AIState *ai) {
+    if (!ai) return;
+    
+    for (int i = 0; i < ai->mind_count; i++) {
+        free(ai->minds[i].name);
+        for (int j = 0; j < ai->minds[i].memory_count; j++) {
+            free(ai->minds[i].memories[j].pattern);
+            free(ai->minds[i].memories[j].response);
+        }
+    }
+    for (int i = 0; i < ai->system_count; i++) {
+        free(ai->systems[i].name);
+    }
+    for (int i = 0; i < ai->neural_count; i++) {
+        free(ai->neural_nets[i].name);
+        free(ai->neural_nets[i].layer_sizes);
+    }
+    free(ai);
+}
 
 void lib_ai_init(void) {
     // تهيئة أنظمة الذكاء الاصطناعي
@@ -55,6 +82,7 @@ void lib_ai_init(void) {
 
 // إنشاء عقل جديد
 Value lib_mind_create(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: إنشاء عقل يتطلب اسماً\n");
         return value_create_null();
@@ -62,14 +90,14 @@ Value lib_mind_create(Value *args, int arg_count) {
     
     char *name = args[0].as.string;
     
-    if (mind_count >= MAX_MINDS) {
+    if (ai->mind_count >= MAX_MINDS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعقول\n");
         return value_create_null();
     }
     
-    minds[mind_count].name = strdup(name);
-    minds[mind_count].memory_count = 0;
-    minds[mind_count].learning_enabled = true;
+    ai->minds[ai->mind_count].name = strdup(name);
+    ai->minds[ai->mind_count].memory_count = 0;
+    ai->minds[ai->mind_count].learning_enabled = true;
     
     Value result;
     result.type = VAL_MIND;
@@ -77,13 +105,14 @@ Value lib_mind_create(Value *args, int arg_count) {
     result.as.mind.memories = NULL;
     result.as.mind.memory_count = 0;
     
-    mind_count++;
+    ai->mind_count++;
     
     return result;
 }
 
 // تعلم العقل
 Value lib_mind_learn(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 3 || args[0].type != VAL_STRING || 
         args[1].type != VAL_STRING || args[2].type != VAL_STRING) {
         fprintf(stderr, "خطأ: تعلم يتطلب اسم العقل والنمط والاستجابة\n");
@@ -96,8 +125,8 @@ Value lib_mind_learn(Value *args, int arg_count) {
     
     // البحث عن العقل
     int idx = -1;
-    for (int i = 0; i < mind_count; i++) {
-        if (strcmp(minds[i].name, mind_name) == 0) {
+    for (int i = 0; i < ai->mind_count; i++) {
+        if (strcmp(ai->minds[i].name, mind_name) == 0) {
             idx = i;
             break;
         }
@@ -108,22 +137,23 @@ Value lib_mind_learn(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    if (minds[idx].memory_count >= MAX_MEMORIES) {
+    if (ai->minds[idx].memory_count >= MAX_MEMORIES) {
         fprintf(stderr, "خطأ: ذاكرة العقل ممتلئة\n");
         return value_create_null();
     }
     
     // إضافة الذاكرة
-    int m = minds[idx].memory_count;
-    minds[idx].memories[m].pattern = strdup(pattern);
-    minds[idx].memories[m].response = strdup(response);
-    minds[idx].memory_count++;
+    int m = ai->minds[idx].memory_count;
+    ai->minds[idx].memories[m].pattern = strdup(pattern);
+    ai->minds[idx].memories[m].response = strdup(response);
+    ai->minds[idx].memory_count++;
     
     return value_create_boolean(true);
 }
 
 // سؤال العقل
 Value lib_mind_ask(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: اسأل يتطلب اسم العقل والسؤال\n");
         return value_create_null();
@@ -134,8 +164,8 @@ Value lib_mind_ask(Value *args, int arg_count) {
     
     // البحث عن العقل
     int idx = -1;
-    for (int i = 0; i < mind_count; i++) {
-        if (strcmp(minds[i].name, mind_name) == 0) {
+    for (int i = 0; i < ai->mind_count; i++) {
+        if (strcmp(ai->minds[i].name, mind_name) == 0) {
             idx = i;
             break;
         }
@@ -150,10 +180,10 @@ Value lib_mind_ask(Value *args, int arg_count) {
     int best_match = -1;
     int best_score = 0;
     
-    for (int i = 0; i < minds[idx].memory_count; i++) {
+    for (int i = 0; i < ai->minds[idx].memory_count; i++) {
         // حساب التشابه البسيط
         int score = 0;
-        char *pattern = minds[idx].memories[i].pattern;
+        char *pattern = ai->minds[idx].memories[i].pattern;
         
         // التحقق من وجود كلمات السؤال في النمط
         if (strstr(pattern, question) != NULL || strstr(question, pattern) != NULL) {
@@ -164,12 +194,13 @@ Value lib_mind_ask(Value *args, int arg_count) {
             strcpy(q_copy, question);
             strcpy(p_copy, pattern);
             
-            char *q_word = strtok(q_copy, " ");
+            char *saveptr;
+            char *q_word = strtok_r(q_copy, " ", &saveptr);
             while (q_word != NULL) {
                 if (strstr(p_copy, q_word) != NULL) {
                     score += 20;
                 }
-                q_word = strtok(NULL, " ");
+                q_word = strtok_r(NULL, " ", &saveptr);
             }
         }
         
@@ -180,7 +211,7 @@ Value lib_mind_ask(Value *args, int arg_count) {
     }
     
     if (best_match >= 0 && best_score >= 20) {
-        return value_create_string(minds[idx].memories[best_match].response);
+        return value_create_string(ai->minds[idx].memories[best_match].response);
     }
     
     return value_create_string("لا أفهم سؤالك. هل يمكنك توضيحه أكثر؟");
@@ -188,6 +219,7 @@ Value lib_mind_ask(Value *args, int arg_count) {
 
 // إنشاء منظومة ذكاء
 Value lib_system_create(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: إنشاء منظومة يتطلب اسماً\n");
         return value_create_null();
@@ -195,15 +227,15 @@ Value lib_system_create(Value *args, int arg_count) {
     
     char *name = args[0].as.string;
     
-    if (system_count >= MAX_SYSTEMS) {
+    if (ai->system_count >= MAX_SYSTEMS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للمنظومات\n");
         return value_create_null();
     }
     
-    systems[system_count].name = strdup(name);
-    systems[system_count].mind_count = 0;
-    systems[system_count].self_learning = false;
-    systems[system_count].confidence_threshold = 0.7;
+    ai->systems[ai->system_count].name = strdup(name);
+    ai->systems[ai->system_count].mind_count = 0;
+    ai->systems[ai->system_count].self_learning = false;
+    ai->systems[ai->system_count].confidence_threshold = 0.7;
     
     Value result;
     result.type = VAL_SYSTEM;
@@ -211,13 +243,14 @@ Value lib_system_create(Value *args, int arg_count) {
     result.as.system.components = NULL;
     result.as.system.component_count = 0;
     
-    system_count++;
+    ai->system_count++;
     
     return result;
 }
 
 // إضافة عقل للمنظومة
 Value lib_system_add(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: أضف يتطلب اسم المنظومة ونوع المكون\n");
         return value_create_null();
@@ -228,8 +261,8 @@ Value lib_system_add(Value *args, int arg_count) {
     
     // البحث عن المنظومة
     int idx = -1;
-    for (int i = 0; i < system_count; i++) {
-        if (strcmp(systems[i].name, system_name) == 0) {
+    for (int i = 0; i < ai->system_count; i++) {
+        if (strcmp(ai->systems[i].name, system_name) == 0) {
             idx = i;
             break;
         }
@@ -249,17 +282,17 @@ Value lib_system_add(Value *args, int arg_count) {
         
         char *mind_name = args[2].as.string;
         
-        if (mind_count >= MAX_MINDS) {
+        if (ai->mind_count >= MAX_MINDS) {
             fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعقول\n");
             return value_create_null();
         }
         
-        minds[mind_count].name = strdup(mind_name);
-        minds[mind_count].memory_count = 0;
-        minds[mind_count].learning_enabled = true;
+        ai->minds[ai->mind_count].name = strdup(mind_name);
+        ai->minds[ai->mind_count].memory_count = 0;
+        ai->minds[ai->mind_count].learning_enabled = true;
         
-        systems[idx].minds[systems[idx].mind_count++] = &minds[mind_count];
-        mind_count++;
+        ai->systems[idx].minds[ai->systems[idx].mind_count++] = &ai->minds[ai->mind_count];
+        ai->mind_count++;
     }
     
     return value_create_boolean(true);
@@ -267,6 +300,7 @@ Value lib_system_add(Value *args, int arg_count) {
 
 // استجابة المنظومة
 Value lib_system_respond(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: استجب يتطلب اسم المنظومة والإدخال\n");
         return value_create_null();
@@ -277,8 +311,8 @@ Value lib_system_respond(Value *args, int arg_count) {
     
     // البحث عن المنظومة
     int idx = -1;
-    for (int i = 0; i < system_count; i++) {
-        if (strcmp(systems[i].name, system_name) == 0) {
+    for (int i = 0; i < ai->system_count; i++) {
+        if (strcmp(ai->systems[i].name, system_name) == 0) {
             idx = i;
             break;
         }
@@ -290,8 +324,8 @@ Value lib_system_respond(Value *args, int arg_count) {
     }
     
     // محاولة الحصول على استجابة من أحد العقول
-    for (int i = 0; i < systems[idx].mind_count; i++) {
-        Mind *mind = systems[idx].minds[i];
+    for (int i = 0; i < ai->systems[idx].mind_count; i++) {
+        Mind *mind = ai->systems[idx].minds[i];
         
         // البحث في ذكريات العقل
         for (int j = 0; j < mind->memory_count; j++) {
@@ -316,6 +350,7 @@ Value lib_system_respond(Value *args, int arg_count) {
 
 // إنشاء شبكة عصبية
 Value lib_neural_create(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: إنشاء شبكة يتطلب اسماً\n");
         return value_create_null();
@@ -323,7 +358,7 @@ Value lib_neural_create(Value *args, int arg_count) {
     
     char *name = args[0].as.string;
     
-    if (neural_count >= MAX_NEURAL) {
+    if (ai->neural_count >= MAX_NEURAL) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للشبكات\n");
         return value_create_null();
     }
@@ -339,16 +374,16 @@ Value lib_neural_create(Value *args, int arg_count) {
         learning_rate = args[2].as.number;
     }
     
-    neural_nets[neural_count].name = strdup(name);
-    neural_nets[neural_count].layers = layers;
-    neural_nets[neural_count].learning_rate = learning_rate;
-    neural_nets[neural_count].use_gpu = false;
-    neural_nets[neural_count].trained = false;
+    ai->neural_nets[ai->neural_count].name = strdup(name);
+    ai->neural_nets[ai->neural_count].layers = layers;
+    ai->neural_nets[ai->neural_count].learning_rate = learning_rate;
+    ai->neural_nets[ai->neural_count].use_gpu = false;
+    ai->neural_nets[ai->neural_count].trained = false;
     
     // تهيئة أحجام الطبقات الافتراضية
-    neural_nets[neural_count].layer_sizes = malloc(sizeof(int) * layers);
+    ai->neural_nets[ai->neural_count].layer_sizes = malloc(sizeof(int) * layers);
     for (int i = 0; i < layers; i++) {
-        neural_nets[neural_count].layer_sizes[i] = 10; // حجم افتراضي
+        ai->neural_nets[ai->neural_count].layer_sizes[i] = 10; // حجم افتراضي
     }
     
     Value result;
@@ -358,13 +393,14 @@ Value lib_neural_create(Value *args, int arg_count) {
     result.as.neural.learning_rate = learning_rate;
     result.as.neural.use_gpu = false;
     
-    neural_count++;
+    ai->neural_count++;
     
     return result;
 }
 
 // تدريب الشبكة
 Value lib_neural_train(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: تدريب يتطلب اسم الشبكة وملف البيانات\n");
         return value_create_null();
@@ -375,8 +411,8 @@ Value lib_neural_train(Value *args, int arg_count) {
     
     // البحث عن الشبكة
     int idx = -1;
-    for (int i = 0; i < neural_count; i++) {
-        if (strcmp(neural_nets[i].name, name) == 0) {
+    for (int i = 0; i < ai->neural_count; i++) {
+        if (strcmp(ai->neural_nets[i].name, name) == 0) {
             idx = i;
             break;
         }
@@ -390,20 +426,21 @@ Value lib_neural_train(Value *args, int arg_count) {
     // محاكاة التدريب
     printf("جاري تدريب الشبكة '%s' باستخدام '%s'...\n", name, data_file);
     printf("طبقات: %d, معدل التعلم: %.4f\n", 
-           neural_nets[idx].layers, neural_nets[idx].learning_rate);
+           ai->neural_nets[idx].layers, ai->neural_nets[idx].learning_rate);
     
     // محاكاة عملية التدريب
     for (int epoch = 0; epoch < 10; epoch++) {
         printf("الدورة %d/10 - الخسارة: %.4f\n", epoch + 1, 1.0 / (epoch + 1));
     }
     
-    neural_nets[idx].trained = true;
+    ai->neural_nets[idx].trained = true;
     
     return value_create_boolean(true);
 }
 
 // استخدام GPU
 Value lib_neural_use_gpu(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: استخدام GPU يتطلب اسم الشبكة\n");
         return value_create_null();
@@ -412,9 +449,9 @@ Value lib_neural_use_gpu(Value *args, int arg_count) {
     char *name = args[0].as.string;
     
     // البحث عن الشبكة
-    for (int i = 0; i < neural_count; i++) {
-        if (strcmp(neural_nets[i].name, name) == 0) {
-            neural_nets[i].use_gpu = true;
+    for (int i = 0; i < ai->neural_count; i++) {
+        if (strcmp(ai->neural_nets[i].name, name) == 0) {
+            ai->neural_nets[i].use_gpu = true;
             printf("تم تفعيل GPU للشبكة '%s'\n", name);
             return value_create_boolean(true);
         }
@@ -426,6 +463,7 @@ Value lib_neural_use_gpu(Value *args, int arg_count) {
 
 // حفظ العقل
 Value lib_mind_save(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: حفظ يتطلب اسم العقل واسم الملف\n");
         return value_create_null();
@@ -436,8 +474,8 @@ Value lib_mind_save(Value *args, int arg_count) {
     
     // البحث عن العقل
     int idx = -1;
-    for (int i = 0; i < mind_count; i++) {
-        if (strcmp(minds[i].name, mind_name) == 0) {
+    for (int i = 0; i < ai->mind_count; i++) {
+        if (strcmp(ai->minds[i].name, mind_name) == 0) {
             idx = i;
             break;
         }
@@ -456,12 +494,12 @@ Value lib_mind_save(Value *args, int arg_count) {
     }
     
     fprintf(f, "# Wisam Mind: %s\n", mind_name);
-    fprintf(f, "memories=%d\n", minds[idx].memory_count);
+    fprintf(f, "memories=%d\n", ai->minds[idx].memory_count);
     
-    for (int i = 0; i < minds[idx].memory_count; i++) {
+    for (int i = 0; i < ai->minds[idx].memory_count; i++) {
         fprintf(f, "[%d]\n", i);
-        fprintf(f, "pattern=%s\n", minds[idx].memories[i].pattern);
-        fprintf(f, "response=%s\n", minds[idx].memories[i].response);
+        fprintf(f, "pattern=%s\n", ai->minds[idx].memories[i].pattern);
+        fprintf(f, "response=%s\n", ai->minds[idx].memories[i].response);
     }
     
     fclose(f);
@@ -472,6 +510,7 @@ Value lib_mind_save(Value *args, int arg_count) {
 
 // تحميل العقل
 Value lib_mind_load(Value *args, int arg_count) {
+    AIState *ai = ai_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: تحميل يتطلب اسم العقل واسم الملف\n");
         return value_create_null();
@@ -481,7 +520,7 @@ Value lib_mind_load(Value *args, int arg_count) {
     char *filename = args[1].as.string;
     
     // إنشاء عقل جديد
-    if (mind_count >= MAX_MINDS) {
+    if (ai->mind_count >= MAX_MINDS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعقول\n");
         return value_create_boolean(false);
     }
@@ -492,9 +531,9 @@ Value lib_mind_load(Value *args, int arg_count) {
         return value_create_boolean(false);
     }
     
-    minds[mind_count].name = strdup(mind_name);
-    minds[mind_count].memory_count = 0;
-    minds[mind_count].learning_enabled = true;
+    ai->minds[ai->mind_count].name = strdup(mind_name);
+    ai->minds[ai->mind_count].memory_count = 0;
+    ai->minds[ai->mind_count].learning_enabled = true;
     
     char line[1024];
     int current_memory = -1;
@@ -507,15 +546,15 @@ Value lib_mind_load(Value *args, int arg_count) {
         if (strncmp(line, "[", 1) == 0) {
             current_memory++;
         } else if (current_memory >= 0 && strncmp(line, "pattern=", 8) == 0) {
-            minds[mind_count].memories[current_memory].pattern = strdup(line + 8);
+            ai->minds[ai->mind_count].memories[current_memory].pattern = strdup(line + 8);
         } else if (current_memory >= 0 && strncmp(line, "response=", 9) == 0) {
-            minds[mind_count].memories[current_memory].response = strdup(line + 9);
-            minds[mind_count].memory_count++;
+            ai->minds[ai->mind_count].memories[current_memory].response = strdup(line + 9);
+            ai->minds[ai->mind_count].memory_count++;
         }
     }
     
     fclose(f);
-    mind_count++;
+    ai->mind_count++;
     
     printf("تم تحميل العقل '%s' من '%s'\n", mind_name, filename);
     return value_create_boolean(true);
@@ -0,0 +1,614 @@
+#include "wisam.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <netdb.h>
+#include <pthread.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <netinet/in.h>
+
+#define ASYNC_READ_CHUNK 65536
+#define ASYNC_MAX_EVENTS 64
+
+// مؤقت في كومة أصغرية مرتبة بموعده (ثوان على الساعة الرتيبة)
+typedef struct {
+    double deadline;
+    Value promise;
+} Timer;
+
+// عملية إدخال/إخراج معلقة حتى يصبح الواصف جاهزاً
+typedef enum {
+    WATCH_ACCEPT,
+    WATCH_CONNECT,
+    WATCH_RECEIVE,
+    WATCH_SEND,
+    WATCH_READ_ALL
+} WatchKind;
+
+typedef struct {
+    WatchKind kind;
+    int fd;                 // الواصف المسجل في epoll
+    bool close_fd;          // يغلق عند انتهاء العملية (نسخة dup أو ملف فتحته المكتبة)
+    Value promise;
+    char *buffer;
+    size_t length;
+    size_t done;
+} Watch;
+
+// حلقة الأحداث: مؤقت timerfd واحد لكل المؤقتات، وطابور دائري للمهام الجاهزة
+// وeventfd تنبه به خيوط العمل الحلقة إلى ما أكملته من عمليات
+// لكل مفسر حلقته، فالمفسرات في خيوط مختلفة لا تتشارك مهامها ولا وعودها
+struct EventLoop {
+    int epoll_fd;
+    int timer_fd;
+    Timer *timers;
+    int timer_count;
+    int timer_capacity;
+    int watch_count;
+    Task **ready;
+    int ready_head;
+    int ready_count;
+    int ready_capacity;
+    int post_fd;
+    int pending;                    // عمليات على خيوط العمل لم تحقق وعودها بعد
+    Completion *posted;             // ما أكملته الخيوط ولم تأخذه الحلقة
+    pthread_mutex_t post_lock;
+};
+
+// حلقة المفسر الجاري (تنشأ واصفاتها عند أول عملية غير متزامنة)
+static EventLoop *loop_current(void) {
+    LibraryContext *libs = library_context();
+    if (!libs->loop) {
+        EventLoop *loop = calloc(1, sizeof(EventLoop));
+        loop->epoll_fd = -1;
+        loop->timer_fd = -1;
+        loop->post_fd = -1;
+        pthread_mutex_init(&loop->post_lock, NULL);
+        libs->loop = loop;
+    }
+    return libs->loop;
+}
+
+void event_loop_free(EventLoop *loop) {
+    if (!loop) return;
+    // خيط لم يسلم ناتجه بعد (انتهى البرنامج باستثناء قبل انتظاره) سيكتب فيها،
+    // فتترك له ولا تحرر
+    if (loop->pending > 0) return;
+    
+    for (int i = 0; i < loop->timer_count; i++) {
+        value_free(&loop->timers[i].promise);
+    }
+    free(loop->timers);
+    free(loop->ready);
+    if (loop->epoll_fd >= 0) close(loop->epoll_fd);
+    if (loop->timer_fd >= 0) close(loop->timer_fd);
+    if (loop->post_fd >= 0) close(loop->post_fd);
+    pthread_mutex_destroy(&loop->post_lock);
+    free(loop);
+}
+
+static bool loop_init(EventLoop *loop) {
+    if (loop->epoll_fd >= 0) return true;
+    
+    loop->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (loop->epoll_fd < 0) return false;
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (loop->timer_fd < 0) return false;
+    
+    loop->post_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (loop->post_fd < 0) return false;
+    
+    // المؤقت يميز بمؤشر NULL، والإكمالات بمؤشر post_fd، وعمليات الواصفات بمؤشر Watch
+    struct epoll_event event = {0};
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->timer_fd, &event) != 0) return false;
+    event.data.ptr = &loop->post_fd;
+    return epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, loop->post_fd, &event) == 0;
+}
+
+static double monotonic_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static Value io_error(const char *operation) {
+    char message[256];
+    snprintf(message, sizeof(message), "فشل %s: %s", operation, strerror(errno));
+    return value_create_exception(message, 15);
+}
+
+// وعد محقق فوراً بقيمة (يملكها)
+static Value settled_promise(Value value) {
+    Value promise = value_create_promise();
+    promise_settle(&promise, value);
+    return promise;
+}
+
+// جدولة مهمة لتستأنفها الدورة التالية
+void event_loop_schedule(Task *task) {
+    EventLoop *loop = loop_current();
+    if (loop->ready_count >= loop->ready_capacity) {
+        int capacity = loop->ready_capacity ? loop->ready_capacity * 2 : 64;
+        Task **ready = malloc(sizeof(Task*) * capacity);
+        for (int i = 0; i < loop->ready_count; i++) {
+            ready[i] = loop->ready[(loop->ready_head + i) % loop->ready_capacity];
+        }
+        free(loop->ready);
+        loop->ready = ready;
+        loop->ready_head = 0;
+        loop->ready_capacity = capacity;
+    }
+    loop->ready[(loop->ready_head + loop->ready_count) % loop->ready_capacity] = task;
+    loop->ready_count++;
+}
+
+// تسجيل عملية ستكمل على خيط عامل: الحلقة لا تنتهي قبل تحقيق وعدها
+Completion *event_loop_expect(Value *promise) {
+    EventLoop *loop = loop_current();
+    if (!loop_init(loop)) return NULL;
+    
+    Completion *completion = malloc(sizeof(Completion));
+    completion->promise = value_copy(promise);
+    completion->result = value_create_null();
+    completion->next = NULL;
+    completion->loop = loop;
+    loop->pending++;
+    return completion;
+}
+
+// تسليم الناتج من أي خيط؛ الحلقة تأخذه عند تنبيهها
+void event_loop_complete(Completion *completion, Value result) {
+    EventLoop *loop = completion->loop;
+    completion->result = result;
+    pthread_mutex_lock(&loop->post_lock);
+    completion->next = loop->posted;
+    loop->posted = completion;
+    pthread_mutex_unlock(&loop->post_lock);
+    
+    uint64_t one = 1;
+    ssize_t written = write(loop->post_fd, &one, sizeof(one));
+    (void)written;
+}
+
+// تحقيق وعود ما أكملته الخيوط، في خيط الحلقة
+static void completions_drain(EventLoop *loop) {
+    uint64_t count;
+    ssize_t n = read(loop->post_fd, &count, sizeof(count));
+    (void)n;
+    
+    pthread_mutex_lock(&loop->post_lock);
+    Completion *completion = loop->posted;
+    loop->posted = NULL;
+    pthread_mutex_unlock(&loop->post_lock);
+    
+    while (completion) {
+        Completion *next = completion->next;
+        promise_settle(&completion->promise, completion->result);
+        value_free(&completion->promise);
+        free(completion);
+        loop->pending--;
+        completion = next;
+    }
+}
+
+// ضبط timerfd على أقرب موعد (أو إيقافه إن لم تبق مؤقتات)
+static void timers_arm(EventLoop *loop) {
+    struct itimerspec spec = {0};
+    if (loop->timer_count > 0) {
+        double deadline = loop->timers[0].deadline;
+        spec.it_value.tv_sec = (time_t)deadline;
+        spec.it_value.tv_nsec = (long)((deadline - (time_t)deadline) * 1e9);
+        if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+            spec.it_value.tv_nsec = 1;
+        }
+    }
+    timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL);
+}
+
+static void timers_push(EventLoop *loop, Timer timer) {
+    if (loop->timer_count >= loop->timer_capacity) {
+        loop->timer_capacity = loop->timer_capacity ? loop->timer_capacity * 2 : 64;
+        loop->timers = realloc(loop->timers, sizeof(Timer) * loop->timer_capacity);
+    }
+    
+    int i = loop->timer_count++;
+    while (i > 0 && loop->timers[(i - 1) / 2].deadline > timer.deadline) {
+        loop->timers[i] = loop->timers[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    loop->timers[i] = timer;
+    if (i == 0) timers_arm(loop);
+}
+
+static Timer timers_pop(EventLoop *loop) {
+    Timer top = loop->timers[0];
+    Timer last = loop->timers[--loop->timer_count];
+    
+    int i = 0;
+    while (2 * i + 1 < loop->timer_count) {
+        int child = 2 * i + 1;
+        if (child + 1 < loop->timer_count &&
+            loop->timers[child + 1].deadline < loop->timers[child].deadline) {
+            child++;
+        }
+        if (last.deadline <= loop->timers[child].deadline) break;
+        loop->timers[i] = loop->timers[child];
+        i = child;
+    }
+    if (loop->timer_count > 0) loop->timers[i] = last;
+    return top;
+}
+
+// تحقيق كل المؤقتات التي حان موعدها
+static void timers_fire(EventLoop *loop) {
+    uint64_t expirations;
+    if (read(loop->timer_fd, &expirations, sizeof(expirations)) < 0 && errno != EAGAIN) {
+        return;
+    }
+    
+    double now = monotonic_now();
+    while (loop->timer_count > 0 && loop->timers[0].deadline <= now) {
+        Timer timer = timers_pop(loop);
+        promise_settle(&timer.promise, value_create_null());
+        value_free(&timer.promise);
+    }
+    timers_arm(loop);
+}
+
+// محاولة إتمام العملية دون انتظار: true إذا تحقق وعدها (بنتيجة أو باستثناء)
+static bool watch_try(Watch *watch) {
+    switch (watch->kind) {
+        case WATCH_ACCEPT:
+            {
+                int client = accept4(watch->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                if (client < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                    promise_settle(&watch->promise, io_error("قبول الاتصال"));
+                    return true;
+                }
+                promise_settle(&watch->promise, value_create_number(client));
+                return true;
+            }
+        case WATCH_CONNECT:
+            {
+                int error = 0;
+                socklen_t length = sizeof(error);
+                getsockopt(watch->fd, SOL_SOCKET, SO_ERROR, &error, &length);
+                if (error != 0) {
+                    errno = error;
+                    promise_settle(&watch->promise, io_error("الاتصال"));
+                    close(watch->fd);
+                    return true;
+                }
+                promise_settle(&watch->promise, value_create_number(watch->fd));
+                return true;
+            }
+        case WATCH_RECEIVE:
+            {
+                char buffer[ASYNC_READ_CHUNK];
+                ssize_t n = read(watch->fd, buffer, sizeof(buffer));
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                    promise_settle(&watch->promise, io_error("الاستقبال"));
+                    return true;
+                }
+                // نص فارغ عند إغلاق الطرف الآخر
+                promise_settle(&watch->promise, value_create_string_len(buffer, n));
+                return true;
+            }
+        case WATCH_SEND:
+            while (watch->done < watch->length) {
+                ssize_t n = send(watch->fd, watch->buffer + watch->done,
+                                 watch->length - watch->done, MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                    promise_settle(&watch->promise, io_error("الإرسال"));
+                    return true;
+                }
+                watch->done += n;
+            }
+            promise_settle(&watch->promise, value_create_number(watch->length));
+            return true;
+        case WATCH_READ_ALL:
+            for (;;) {
+                if (watch->length - watch->done < ASYNC_READ_CHUNK) {
+                    watch->length = watch->length * 2 + ASYNC_READ_CHUNK;
+                    watch->buffer = realloc(watch->buffer, watch->length);
+                }
+                ssize_t n = read(watch->fd, watch->buffer + watch->done, watch->length - watch->done);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return false;
+                    promise_settle(&watch->promise, io_error("القراءة"));
+                    return true;
+                }
+                if (n == 0) {
+                    promise_settle(&watch->promise, value_create_string_len(watch->buffer, watch->done));
+                    return true;
+                }
+                watch->done += n;
+            }
+    }
+    return true;
+}
+
+static void watch_free(Watch *watch) {
+    if (watch->close_fd) close(watch->fd);
+    value_free(&watch->promise);
+    free(watch->buffer);
+    free(watch);
+}
+
+// بدء عملية: تنفذ فوراً إن أمكن، وإلا سجل الواصف في epoll حتى يجهز
+// الواصف المسجل نسخة dup حتى تنتظر قراءة وكتابة على المقبس نفسه معاً
+static Value watch_start(WatchKind kind, int fd, bool owned, uint32_t events,
+                         char *buffer, size_t length) {
+    EventLoop *loop = loop_current();
+    if (!loop_init(loop)) return io_error("تهيئة حلقة الأحداث");
+    
+    Watch *watch = malloc(sizeof(Watch));
+    watch->kind = kind;
+    watch->fd = fd;
+    watch->close_fd = owned;
+    watch->promise = value_create_promise();
+    watch->buffer = buffer;
+    watch->length = length;
+    watch->done = 0;
+    Value promise = value_copy(&watch->promise);
+    
+    if (kind != WATCH_CONNECT && watch_try(watch)) {
+        watch_free(watch);
+        return promise;
+    }
+    
+    if (!owned) {
+        watch->fd = dup(fd);
+        watch->close_fd = true;
+    }
+    struct epoll_event event = {0};
+    event.events = events;
+    event.data.ptr = watch;
+    if (watch->fd < 0 || epoll_ctl(loop->epoll_fd, EPOLL_CTL_ADD, watch->fd, &event) < 0) {
+        promise_settle(&watch->promise, io_error("مراقبة الواصف"));
+        watch_free(watch);
+        return promise;
+    }
+    loop->watch_count++;
+    return promise;
+}
+
+static void watch_ready(EventLoop *loop, Watch *watch) {
+    if (!watch_try(watch)) return;
+    
+    epoll_ctl(loop->epoll_fd, EPOLL_CTL_DEL, watch->fd, NULL);
+    // مقبس الاتصال الناجح يسلم للبرنامج فلا يغلق
+    if (watch->kind == WATCH_CONNECT) watch->close_fd = false;
+    watch_free(watch);
+    loop->watch_count--;
+}
+
+// دورة واحدة: استئناف المهام الجاهزة، أو انتظار حدث واحد على الأقل دون انشغال
+// تعيد false إذا لم يبق ما ينتظر (لا مهام جاهزة ولا مؤقتات ولا عمليات معلقة)
+bool event_loop_run_once(void) {
+    EventLoop *loop = loop_current();
+    if (loop->ready_count > 0) {
+        // ما يجدول أثناء الاستئناف ينتظر الدورة التالية
+        int count = loop->ready_count;
+        for (int i = 0; i < count; i++) {
+            Task *task = loop->ready[loop->ready_head];
+            loop->ready_head = (loop->ready_head + 1) % loop->ready_capacity;
+            loop->ready_count--;
+            task_resume(task);
+        }
+        return true;
+    }
+    
+    if (loop->timer_count == 0 && loop->watch_count == 0 && loop->pending == 0) return false;
+    
+    // العمليات المعلقة في طوابير المجدول ينفذها الخيط الرئيسي بنفسه إن لم يسبقه عامل إليها
+    if (loop->pending > 0 && parallel_help()) return true;
+    
+    struct epoll_event events[ASYNC_MAX_EVENTS];
+    int n = epoll_wait(loop->epoll_fd, events, ASYNC_MAX_EVENTS, -1);
+    if (n < 0) return errno == EINTR;
+    
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.ptr == NULL) {
+            timers_fire(loop);
+        } else if (events[i].data.ptr == &loop->post_fd) {
+            completions_drain(loop);
+        } else {
+            watch_ready(loop, events[i].data.ptr);
+        }
+    }
+    return true;
+}
+
+// تشغيل الحلقة حتى لا يبقى ما ينتظر
+void event_loop_run(void) {
+    while (event_loop_run_once());
+}
+
+// نم(ثوان): وعد يتحقق بعد المدة دون حجز الخيط
+Value lib_async_sleep(Value *args, int arg_count) {
+    if (arg_count < 1 || !value_is_number(&args[0])) {
+        return value_create_exception("نم يتطلب عدداً من الثواني", 4);
+    }
+    EventLoop *loop = loop_current();
+    if (!loop_init(loop)) return io_error("تهيئة حلقة الأحداث");
+    
+    double seconds = value_as_number(&args[0]);
+    Timer timer;
+    timer.deadline = monotonic_now() + (seconds > 0 ? seconds : 0);
+    timer.promise = value_create_promise();
+    Value promise = value_copy(&timer.promise);
+    timers_push(loop, timer);
+    return promise;
+}
+
+// قراءة ملف عادي كاملاً على خيط عامل
+typedef struct {
+    int fd;
+    size_t length;
+    Completion *completion;
+} FileRead;
+
+static void file_read_task(Interpreter *worker, void *context) {
+    (void)worker;
+    FileRead *job = context;
+    char *buffer = malloc(job->length + 1);
+    size_t done = 0;
+    ssize_t n;
+    while (done < job->length && (n = read(job->fd, buffer + done, job->length - done)) > 0) {
+        done += n;
+    }
+    close(job->fd);
+    Value content = value_create_string_len(buffer, done);
+    free(buffer);
+    event_loop_complete(job->completion, content);
+    free(job);
+}
+
+// اقرأ_ملف(مسار): وعد بمحتوى الملف
+// الملفات العادية لا تقبلها epoll، فتقرأ على المجدول المتوازي دون حجز الحلقة؛
+// والأنابيب والأجهزة تنتظر في الحلقة
+Value lib_async_read_file(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_STRING) {
+        return value_create_exception("اقرأ_ملف يتطلب مسار الملف", 4);
+    }
+    
+    int fd = open(args[0].as.string, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return io_error("فتح الملف");
+    
+    struct stat info;
+    if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+        Value promise = value_create_promise();
+        FileRead *job = malloc(sizeof(FileRead));
+        job->fd = fd;
+        job->length = info.st_size;
+        job->completion = event_loop_expect(&promise);
+        if (!job->completion) {
+            close(fd);
+            free(job);
+            value_free(&promise);
+            return io_error("تهيئة حلقة الأحداث");
+        }
+        parallel_spawn(NULL, file_read_task, job);
+        return promise;
+    }
+    return watch_start(WATCH_READ_ALL, fd, true, EPOLLIN, NULL, 0);
+}
+
+// استمع(منفذ): مقبس TCP مستمع على كل العناوين
+Value lib_async_listen(Value *args, int arg_count) {
+    if (arg_count < 1 || !value_is_number(&args[0])) {
+        return value_create_exception("استمع يتطلب رقم المنفذ", 4);
+    }
+    
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return io_error("إنشاء المقبس");
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t)value_as_number(&args[0]));
+    if (bind(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(fd, SOMAXCONN) < 0) {
+        Value error = io_error("الاستماع");
+        close(fd);
+        return error;
+    }
+    return value_create_number(fd);
+}
+
+// اقبل(مقبس): وعد بمقبس أول عميل يتصل
+Value lib_async_accept(Value *args, int arg_count) {
+    if (arg_count < 1 || !value_is_number(&args[0])) {
+        return value_create_exception("اقبل يتطلب مقبساً مستمعاً", 4);
+    }
+    return watch_start(WATCH_ACCEPT, (int)value_as_number(&args[0]), false, EPOLLIN, NULL, 0);
+}
+
+// اتصل(مضيف، منفذ): وعد بمقبس متصل
+// (حل اسم المضيف عبر getaddrinfo يحجب، أما الاتصال نفسه فلا)
+Value lib_async_connect(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_STRING || !value_is_number(&args[1])) {
+        return value_create_exception("اتصل يتطلب مضيفاً ومنفذاً", 4);
+    }
+    
+    char port[16];
+    snprintf(port, sizeof(port), "%d", (int)value_as_number(&args[1]));
+    struct addrinfo hints = {0};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *info;
+    if (getaddrinfo(args[0].as.string, port, &hints, &info) != 0) {
+        return value_create_exception("تعذر حل اسم المضيف", 15);
+    }
+    
+    int fd = socket(info->ai_family, info->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC, info->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(info);
+        return io_error("إنشاء المقبس");
+    }
+    int result = connect(fd, info->ai_addr, info->ai_addrlen);
+    freeaddrinfo(info);
+    
+    if (result == 0) {
+        return settled_promise(value_create_number(fd));
+    }
+    if (errno != EINPROGRESS) {
+        Value error = io_error("الاتصال");
+        close(fd);
+        return error;
+    }
+    return watch_start(WATCH_CONNECT, fd, true, EPOLLOUT, NULL, 0);
+}
+
+// استقبل(مقبس): وعد بما يصل من بيانات (نص فارغ عند إغلاق الطرف الآخر)
+// (والقنوات تستقبل منها مكتبة القنوات، وكذلك أرسل وأغلق)
+Value lib_async_receive(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_CHANNEL) {
+        return lib_channel_receive(args, arg_count);
+    }
+    if (arg_count < 1 || !value_is_number(&args[0])) {
+        return value_create_exception("استقبل يتطلب مقبساً", 4);
+    }
+    return watch_start(WATCH_RECEIVE, (int)value_as_number(&args[0]), false, EPOLLIN, NULL, 0);
+}
+
+// أرسل(مقبس، نص): وعد بعدد البايتات بعد إرسالها كاملة
+Value lib_async_send(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_CHANNEL) {
+        return lib_channel_send(args, arg_count);
+    }
+    if (arg_count < 2 || !value_is_number(&args[0]) || args[1].type != VAL_STRING) {
+        return value_create_exception("أرسل يتطلب مقبساً ونصاً", 4);
+    }
+    
+    size_t length = string_length(args[1].as.string);
+    char *buffer = malloc(length ? length : 1);
+    memcpy(buffer, args[1].as.string, length);
+    return watch_start(WATCH_SEND, (int)value_as_number(&args[0]), false, EPOLLOUT, buffer, length);
+}
+
+// أغلق(مقبس)
+Value lib_async_close(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_CHANNEL) {
+        return lib_channel_close(args, arg_count);
+    }
+    if (arg_count < 1 || !value_is_number(&args[0])) {
+        return value_create_boolean(false);
+    }
+    return value_create_boolean(close((int)value_as_number(&args[0])) == 0);
+}
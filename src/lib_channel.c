@@ -0,0 +1,317 @@
+#include "wisam.h"
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+// سعة القناة إن لم تحدد
+#define CHANNEL_DEFAULT_CAPACITY 64
+
+// بت في موضع الإرسال يعني أن القناة أغلقت: الإغلاق والحجز يتسابقان على الكلمة نفسها
+// فلا يحجز مرسل خانة بعد الإغلاق
+#define CHANNEL_CLOSED ((int64_t)1 << 62)
+
+// نتيجة محاولة إرسال أو استقبال دون انتظار
+typedef enum {
+    CHANNEL_OK,
+    CHANNEL_WOULD_BLOCK,            // ممتلئة عند الإرسال، أو فارغة عند الاستقبال
+    CHANNEL_DONE                    // مغلقة (وفارغة عند الاستقبال)
+} ChannelStatus;
+
+// خانة في الحلقة: رقم تسلسلها يبين لمن هي في الدورة الجارية
+// (2 × position: جاهزة لمرسل الموضع position، 2 × position + 1: فيها قيمته لمستقبله)
+// والمضاعفة تفرق الحالتين حتى في قناة بخانة واحدة
+typedef struct {
+    int64_t sequence;
+    Value value;
+} ChannelSlot;
+
+// قناة محدودة متعددة المرسلين والمستقبلين: حلقة بأرقام تسلسل لكل خانة (Vyukov)
+// المرسل يحجز موضعاً بزيادة send_position ثم يكتب خانته، والمستقبل كذلك بـ receive_position،
+// فلا أقفال في المسار السريع؛ والقفل للنوم فقط حين تمتلئ أو تفرغ
+struct Channel {
+    int refcount;
+    int64_t capacity;
+    ChannelSlot *slots;
+    int64_t send_position;          // مع بت الإغلاق
+    char send_padding[56];          // المرسلون والمستقبلون لا يتنازعون سطر الذاكرة نفسه
+    int64_t receive_position;
+    char receive_padding[56];
+    int waiting;                    // خيوط نائمة على هذه القناة
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+};
+
+// خيوط اختر النائمة تنتظر أي قناة، فتنبهها كل القنوات
+static pthread_mutex_t select_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t select_changed = PTHREAD_COND_INITIALIZER;
+static int select_waiting = 0;
+
+// إنشاء قناة فارغة بسعة محددة (عنصر واحد على الأقل)
+Value value_create_channel(int capacity) {
+    Channel *channel = calloc(1, sizeof(Channel));
+    channel->refcount = 1;
+    channel->capacity = capacity > 0 ? capacity : 1;
+    channel->slots = malloc(sizeof(ChannelSlot) * channel->capacity);
+    for (int64_t i = 0; i < channel->capacity; i++) {
+        channel->slots[i].sequence = 2 * i;
+    }
+    pthread_mutex_init(&channel->lock, NULL);
+    pthread_cond_init(&channel->changed, NULL);
+    
+    Value v;
+    v.type = VAL_CHANNEL;
+    v.as.channel = channel;
+    return v;
+}
+
+void channel_retain(Channel *channel) {
+    __atomic_add_fetch(&channel->refcount, 1, __ATOMIC_RELAXED);
+}
+
+// تحرير مرجع، والقيم التي لم تستقبل مع آخر مرجع
+void channel_release(Channel *channel) {
+    if (__atomic_sub_fetch(&channel->refcount, 1, __ATOMIC_ACQ_REL) > 0) return;
+    
+    int64_t end = channel->send_position & ~CHANNEL_CLOSED;
+    for (int64_t i = channel->receive_position; i < end; i++) {
+        value_free(&channel->slots[i % channel->capacity].value);
+    }
+    pthread_mutex_destroy(&channel->lock);
+    pthread_cond_destroy(&channel->changed);
+    free(channel->slots);
+    free(channel);
+}
+
+// إرسال دون انتظار: القناة تملك القيمة عند النجاح فقط
+static ChannelStatus channel_try_send(Channel *channel, Value *value) {
+    int64_t position = __atomic_load_n(&channel->send_position, __ATOMIC_RELAXED);
+    for (;;) {
+        if (position & CHANNEL_CLOSED) return CHANNEL_DONE;
+        ChannelSlot *slot = &channel->slots[position % channel->capacity];
+        int64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        
+        if (sequence == 2 * position) {
+            if (__atomic_compare_exchange_n(&channel->send_position, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                slot->value = *value;
+                __atomic_store_n(&slot->sequence, 2 * position + 1, __ATOMIC_RELEASE);
+                return CHANNEL_OK;
+            }
+            // فشل الحجز يحمل الموضع الجديد في position
+        } else if (sequence < 2 * position) {
+            // الخانة لم يستقبلها أحد منذ دورة كاملة
+            return CHANNEL_WOULD_BLOCK;
+        } else {
+            position = __atomic_load_n(&channel->send_position, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// استقبال دون انتظار؛ المغلقة تعد منتهية إذا استقبل كل ما حجز قبل إغلاقها
+static ChannelStatus channel_try_receive(Channel *channel, Value *out) {
+    int64_t position = __atomic_load_n(&channel->receive_position, __ATOMIC_RELAXED);
+    for (;;) {
+        ChannelSlot *slot = &channel->slots[position % channel->capacity];
+        int64_t sequence = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        
+        if (sequence == 2 * position + 1) {
+            if (__atomic_compare_exchange_n(&channel->receive_position, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *out = slot->value;
+                __atomic_store_n(&slot->sequence, 2 * (position + channel->capacity), __ATOMIC_RELEASE);
+                return CHANNEL_OK;
+            }
+        } else if (sequence < 2 * position + 1) {
+            // فارغة، أو مرسل حجز الخانة ولم يكتبها بعد
+            int64_t sent = __atomic_load_n(&channel->send_position, __ATOMIC_ACQUIRE);
+            if ((sent & CHANNEL_CLOSED) && (sent & ~CHANNEL_CLOSED) == position) return CHANNEL_DONE;
+            return CHANNEL_WOULD_BLOCK;
+        } else {
+            position = __atomic_load_n(&channel->receive_position, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+// تنبيه النائمين بعد تغير حالة القناة؛ النائم يسجل نفسه ثم يعيد المحاولة قبل أن ينام،
+// والحاجز هنا يضمن أن يرى أحدهما الآخر فلا يضيع تنبيه
+static void channel_notify(Channel *channel) {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&channel->waiting, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&channel->lock);
+        pthread_cond_broadcast(&channel->changed);
+        pthread_mutex_unlock(&channel->lock);
+    }
+    if (__atomic_load_n(&select_waiting, __ATOMIC_RELAXED) > 0) {
+        pthread_mutex_lock(&select_lock);
+        pthread_cond_broadcast(&select_changed);
+        pthread_mutex_unlock(&select_lock);
+    }
+}
+
+// إرسال ينتظر خانة فارغة؛ القيمة تنقل إلى القناة ولا تنسخ
+static ChannelStatus channel_send(Channel *channel, Value *value) {
+    ChannelStatus status = channel_try_send(channel, value);
+    if (status == CHANNEL_WOULD_BLOCK) {
+        pthread_mutex_lock(&channel->lock);
+        __atomic_add_fetch(&channel->waiting, 1, __ATOMIC_SEQ_CST);
+        while ((status = channel_try_send(channel, value)) == CHANNEL_WOULD_BLOCK) {
+            pthread_cond_wait(&channel->changed, &channel->lock);
+        }
+        __atomic_sub_fetch(&channel->waiting, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&channel->lock);
+    }
+    if (status == CHANNEL_OK) channel_notify(channel);
+    return status;
+}
+
+// استقبال ينتظر قيمة، أو CHANNEL_DONE إن أغلقت القناة وفرغت
+static ChannelStatus channel_receive(Channel *channel, Value *out) {
+    ChannelStatus status = channel_try_receive(channel, out);
+    if (status == CHANNEL_WOULD_BLOCK) {
+        pthread_mutex_lock(&channel->lock);
+        __atomic_add_fetch(&channel->waiting, 1, __ATOMIC_SEQ_CST);
+        while ((status = channel_try_receive(channel, out)) == CHANNEL_WOULD_BLOCK) {
+            pthread_cond_wait(&channel->changed, &channel->lock);
+        }
+        __atomic_sub_fetch(&channel->waiting, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&channel->lock);
+    }
+    if (status == CHANNEL_OK) channel_notify(channel);
+    return status;
+}
+
+// العنصر التالي لـ 'لكل ... في قناة': تنتهي الحلقة حين تغلق القناة وتفرغ
+bool channel_next(Channel *channel, Value *out) {
+    return channel_receive(channel, out) == CHANNEL_OK;
+}
+
+// قناة(سعة): قناة محدودة بين الخيوط، سعتها 64 إن لم تحدد
+Value lib_channel_create(Value *args, int arg_count) {
+    if (arg_count < 1) {
+        return value_create_channel(CHANNEL_DEFAULT_CAPACITY);
+    }
+    if (!value_is_number(&args[0]) || value_as_number(&args[0]) < 1) {
+        return value_create_exception("سعة القناة يجب أن تكون عدداً موجباً", 4);
+    }
+    return value_create_channel((int)value_as_number(&args[0]));
+}
+
+// أرسل(قناة، قيمة): تنتظر إن امتلأت القناة. القيمة تنقل كما هي دون نسخ،
+// ولا يرسل ما يتشاركه الخيط المرسل بالمرجع (النسخ والوعود والمولدات)
+Value lib_channel_send(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_CHANNEL) {
+        return value_create_exception("أرسل يتطلب قناة وقيمة", 4);
+    }
+    if (!value_is_sendable(&args[1])) {
+        return value_create_exception("لا ترسل عبر القناة قيمة مشتركة بالمرجع", 4);
+    }
+    
+    Value value = args[1];
+    args[1] = value_create_null();
+    if (channel_send(args[0].as.channel, &value) == CHANNEL_DONE) {
+        value_free(&value);
+        return value_create_exception("القناة مغلقة", 15);
+    }
+    return value_create_null();
+}
+
+// استقبل(قناة): القيمة التالية، تنتظر إن كانت القناة فارغة؛ وفارغ إن أغلقت وفرغت
+Value lib_channel_receive(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_CHANNEL) {
+        return value_create_exception("استقبل يتطلب قناة", 4);
+    }
+    Value value;
+    if (channel_receive(args[0].as.channel, &value) == CHANNEL_DONE) {
+        return value_create_null();
+    }
+    return value;
+}
+
+// أغلق(قناة): لا إرسال بعدها، والمستقبلون يأخذون ما بقي فيها ثم تنتهي
+Value lib_channel_close(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_CHANNEL) {
+        return value_create_exception("أغلق يتطلب قناة", 4);
+    }
+    Channel *channel = args[0].as.channel;
+    int64_t previous = __atomic_fetch_or(&channel->send_position, CHANNEL_CLOSED, __ATOMIC_ACQ_REL);
+    channel_notify(channel);
+    return value_create_boolean(!(previous & CHANNEL_CLOSED));
+}
+
+// محاولة حالة واحدة من حالات اختر: قناة للاستقبال، أو [قناة، قيمة] للإرسال
+static ChannelStatus select_try(Value *option, Value *out) {
+    if (option->type == VAL_CHANNEL) {
+        return channel_try_receive(option->as.channel, out);
+    }
+    ChannelStatus status = channel_try_send(option->as.array.items[0]->as.channel, option->as.array.items[1]);
+    if (status == CHANNEL_OK) {
+        // القيمة انتقلت إلى القناة
+        *option->as.array.items[1] = value_create_null();
+        *out = value_create_null();
+    }
+    return status;
+}
+
+// اختر(حالات): تنتظر أول حالة جاهزة وتعيد [موضعها، القيمة المستقبلة أو فارغ]
+// الحالة قناة للاستقبال منها أو [قناة، قيمة] للإرسال إليها، والمغلقة تسقط من الاختيار؛
+// وإن أغلقت كل القنوات أعيد فارغ. البحث يبدأ كل مرة من حالة تالية فلا تجوع الأخيرة
+Value lib_channel_select(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_ARRAY || args[0].as.array.count == 0) {
+        return value_create_exception("اختر يتطلب مصفوفة قنوات", 4);
+    }
+    Value *options = &args[0];
+    int count = options->as.array.count;
+    for (int i = 0; i < count; i++) {
+        Value *option = options->as.array.items[i];
+        bool is_send = option->type == VAL_ARRAY && option->as.array.count == 2 &&
+                       option->as.array.items[0]->type == VAL_CHANNEL;
+        if (option->type != VAL_CHANNEL && !is_send) {
+            return value_create_exception("حالة اختر قناة أو [قناة، قيمة]", 4);
+        }
+        if (is_send && !value_is_sendable(option->as.array.items[1])) {
+            return value_create_exception("لا ترسل عبر القناة قيمة مشتركة بالمرجع", 4);
+        }
+    }
+    
+    static __thread unsigned int rotation = 0;
+    int start = (int)(rotation++ % (unsigned int)count);
+    int chosen = -1;
+    Value value = value_create_null();
+    bool registered = false;
+    
+    for (;;) {
+        int done = 0;
+        for (int k = 0; k < count && chosen < 0; k++) {
+            int i = (start + k) % count;
+            ChannelStatus status = select_try(options->as.array.items[i], &value);
+            if (status == CHANNEL_OK) chosen = i;
+            if (status == CHANNEL_DONE) done++;
+        }
+        if (chosen >= 0 || done == count) break;
+        
+        if (!registered) {
+            pthread_mutex_lock(&select_lock);
+            __atomic_add_fetch(&select_waiting, 1, __ATOMIC_SEQ_CST);
+            registered = true;
+            continue;
+        }
+        pthread_cond_wait(&select_changed, &select_lock);
+    }
+    if (registered) {
+        __atomic_sub_fetch(&select_waiting, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&select_lock);
+    }
+    if (chosen < 0) return value_create_null();
+    
+    Value *option = options->as.array.items[chosen];
+    channel_notify(option->type == VAL_CHANNEL ? option->as.channel : option->as.array.items[0]->as.channel);
+    
+    Value result = value_create_array();
+    Value *index = malloc(sizeof(Value));
+    *index = value_create_int(chosen);
+    array_append(&result, index);
+    Value *item = malloc(sizeof(Value));
+    *item = value;
+    array_append(&result, item);
+    return result;
+}
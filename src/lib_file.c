@@ -273,22 +273,9 @@ Value lib_file_info(Value *args, int arg_count) {
     
     Value result = value_create_object();
     
-    result.as.object.keys[0] = strdup("الحجم");
-    result.as.object.values[0] = malloc(sizeof(Value));
-    *result.as.object.values[0] = value_create_number(st.st_size);
-    
-    result.as.object.keys[1] = strdup("تاريخ_التعديل");
-    result.as.object.values[1] = malloc(sizeof(Value));
-    *result.as.object.values[1] = value_create_number(st.st_mtime);
-    
-    result.as.object.keys[2] = strdup("هو_ملف");
-    result.as.object.values[2] = malloc(sizeof(Value));
-    *result.as.object.values[2] = value_create_boolean(S_ISREG(st.st_mode));
-    
-    result.as.object.keys[3] = strdup("هو_مجلد");
-    result.as.object.values[3] = malloc(sizeof(Value));
-    *result.as.object.values[3] = value_create_boolean(S_ISDIR(st.st_mode));
-    
-    result.as.object.count = 4;
+    object_set(&result, "الحجم", value_create_number(st.st_size));
+    object_set(&result, "تاريخ_التعديل", value_create_number(st.st_mtime));
+    object_set(&result, "هو_ملف", value_create_boolean(S_ISREG(st.st_mode)));
+    object_set(&result, "هو_مجلد", value_create_boolean(S_ISDIR(st.st_mode)));
     return result;
 }
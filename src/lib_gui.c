@@ -31,12 +31,38 @@ typedef struct {
     int widget_count;
 } Window;
 
-static Window windows[MAX_WINDOWS];
-static int window_count = 0;
-static int active_window = -1;
+// حالة المكتبة لكل مفسر: نوافذ برنامجه والنافذة النشطة
+struct GUIState {
+    Window windows[MAX_WINDOWS];
+    int window_count;
+    int active_window;
+};
+
+static GUIState *gui_state(void) {
+    LibraryContext *libs = library_context();
+    if (!libs->gui) {
+        libs->gui = calloc(1, sizeof(GUIState));
+        libs->gui->active_window = -1;
+    }
+    return libs->gui;
+}
+
+void lib_gui_state_free(GUIState *gui) {
+    if (!gui) return;
+    
+    for (int i = 0; i < gui->window_count; i++) {
+        free(gui->windows[i].title);
+        for (int j = 0; j < gui->windows[i].widget_count; j++) {
+            free(gui->windows[i].widgets[j].id);
+            free(gui->windows[i].widgets[j].text);
+        }
+    }
+    free(gui);
+}
 
 // إنشاء نافذة جديدة
 Value lib_gui_create_window(Value *args, int arg_count) {
+    GUIState *gui = gui_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: إنشاء_نافذة يتطلب عنواناً\n");
         return value_create_null();
@@ -54,28 +80,29 @@ Value lib_gui_create_window(Value *args, int arg_count) {
         height = (int)args[2].as.number;
     }
     
-    if (window_count >= MAX_WINDOWS) {
+    if (gui->window_count >= MAX_WINDOWS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للنوافذ\n");
         return value_create_null();
     }
     
-    windows[window_count].title = strdup(title);
-    windows[window_count].width = width;
-    windows[window_count].height = height;
-    windows[window_count].visible = true;
-    windows[window_count].widget_count = 0;
+    gui->windows[gui->window_count].title = strdup(title);
+    gui->windows[gui->window_count].width = width;
+    gui->windows[gui->window_count].height = height;
+    gui->windows[gui->window_count].visible = true;
+    gui->windows[gui->window_count].widget_count = 0;
     
     printf("[واجهات] إنشاء نافذة: %s (%dx%d)\n", title, width, height);
     
-    active_window = window_count;
-    window_count++;
+    gui->active_window = gui->window_count;
+    gui->window_count++;
     
-    return value_create_number(active_window);
+    return value_create_number(gui->active_window);
 }
 
 // إضافة زر
 Value lib_gui_add_button(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
@@ -85,7 +112,7 @@ Value lib_gui_add_button(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    Window *win = &windows[active_window];
+    Window *win = &gui->windows[gui->active_window];
     
     if (win->widget_count >= MAX_WIDGETS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعناصر\n");
@@ -111,7 +138,8 @@ Value lib_gui_add_button(Value *args, int arg_count) {
 
 // إضافة نص
 Value lib_gui_add_label(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
@@ -121,7 +149,7 @@ Value lib_gui_add_label(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    Window *win = &windows[active_window];
+    Window *win = &gui->windows[gui->active_window];
     
     if (win->widget_count >= MAX_WIDGETS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعناصر\n");
@@ -144,7 +172,8 @@ Value lib_gui_add_label(Value *args, int arg_count) {
 
 // إضافة حقل إدخال
 Value lib_gui_add_input(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
@@ -154,7 +183,7 @@ Value lib_gui_add_input(Value *args, int arg_count) {
         placeholder = args[0].as.string;
     }
     
-    Window *win = &windows[active_window];
+    Window *win = &gui->windows[gui->active_window];
     
     if (win->widget_count >= MAX_WIDGETS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعناصر\n");
@@ -180,7 +209,8 @@ Value lib_gui_add_input(Value *args, int arg_count) {
 
 // إضافة صورة
 Value lib_gui_add_image(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
@@ -190,7 +220,7 @@ Value lib_gui_add_image(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    Window *win = &windows[active_window];
+    Window *win = &gui->windows[gui->active_window];
     
     if (win->widget_count >= MAX_WIDGETS) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للعناصر\n");
@@ -215,12 +245,13 @@ Value lib_gui_add_image(Value *args, int arg_count) {
 
 // عرض النافذة
 Value lib_gui_show_window(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
     
-    Window *win = &windows[active_window];
+    Window *win = &gui->windows[gui->active_window];
     win->visible = true;
     
     printf("[واجهات] عرض النافذة: %s\n", win->title);
@@ -232,12 +263,13 @@ Value lib_gui_show_window(Value *args, int arg_count) {
 
 // إخفاء النافذة
 Value lib_gui_hide_window(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
     
-    windows[active_window].visible = false;
+    gui->windows[gui->active_window].visible = false;
     printf("[واجهات] إخفاء النافذة\n");
     
     return value_create_boolean(true);
@@ -245,12 +277,13 @@ Value lib_gui_hide_window(Value *args, int arg_count) {
 
 // إغلاق النافذة
 Value lib_gui_close_window(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
     
-    Window *win = &windows[active_window];
+    Window *win = &gui->windows[gui->active_window];
     printf("[واجهات] إغلاق النافذة: %s\n", win->title);
     
     // تحرير الذاكرة
@@ -261,18 +294,19 @@ Value lib_gui_close_window(Value *args, int arg_count) {
     }
     
     // إزالة النافذة
-    for (int i = active_window; i < window_count - 1; i++) {
-        windows[i] = windows[i + 1];
+    for (int i = gui->active_window; i < gui->window_count - 1; i++) {
+        gui->windows[i] = gui->windows[i + 1];
     }
-    window_count--;
-    active_window = -1;
+    gui->window_count--;
+    gui->active_window = -1;
     
     return value_create_boolean(true);
 }
 
 // تعيين عنوان النافذة
 Value lib_gui_set_title(Value *args, int arg_count) {
-    if (active_window < 0 || active_window >= window_count) {
+    GUIState *gui = gui_state();
+    if (gui->active_window < 0 || gui->active_window >= gui->window_count) {
         fprintf(stderr, "خطأ: لا يوجد نافذة نشطة\n");
         return value_create_null();
     }
@@ -282,8 +316,8 @@ Value lib_gui_set_title(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    free(windows[active_window].title);
-    windows[active_window].title = strdup(args[0].as.string);
+    free(gui->windows[gui->active_window].title);
+    gui->windows[gui->active_window].title = strdup(args[0].as.string);
     
     printf("[واجهات] تغيير العنوان إلى: %s\n", args[0].as.string);
     
@@ -3,6 +3,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <inttypes.h>
 
 // تحويل كائن إلى JSON
 Value lib_json_stringify(Value *args, int arg_count) {
@@ -30,6 +31,10 @@ Value lib_json_stringify(Value *args, int arg_count) {
                 char num[32];
                 snprintf(num, sizeof(num), "%g", val->as.number);
                 strcat(buffer, num);
+            } else if (val->type == VAL_INT) {
+                char num[32];
+                snprintf(num, sizeof(num), "%" PRId64, val->as.integer);
+                strcat(buffer, num);
             } else if (val->type == VAL_BOOLEAN) {
                 strcat(buffer, val->as.boolean ? "true" : "false");
             } else if (val->type == VAL_NULL) {
@@ -51,6 +56,10 @@ Value lib_json_stringify(Value *args, int arg_count) {
                 char num[32];
                 snprintf(num, sizeof(num), "%g", val->as.number);
                 strcat(buffer, num);
+            } else if (val->type == VAL_INT) {
+                char num[32];
+                snprintf(num, sizeof(num), "%" PRId64, val->as.integer);
+                strcat(buffer, num);
             } else if (val->type == VAL_BOOLEAN) {
                 strcat(buffer, val->as.boolean ? "true" : "false");
             } else if (val->type == VAL_NULL) {
@@ -66,6 +75,10 @@ Value lib_json_stringify(Value *args, int arg_count) {
         char num[32];
         snprintf(num, sizeof(num), "%g", args[0].as.number);
         strcat(buffer, num);
+    } else if (args[0].type == VAL_INT) {
+        char num[32];
+        snprintf(num, sizeof(num), "%" PRId64, args[0].as.integer);
+        strcat(buffer, num);
     } else if (args[0].type == VAL_BOOLEAN) {
         strcat(buffer, args[0].as.boolean ? "true" : "false");
     } else if (args[0].type == VAL_NULL) {
@@ -136,17 +149,7 @@ Value lib_json_parse(Value *args, int arg_count) {
                 }
                 
                 // إضافة للكائن
-                if (result.as.object.count >= result.as.object.capacity) {
-                    result.as.object.capacity *= 2;
-                    result.as.object.keys = realloc(result.as.object.keys, 
-                                                    sizeof(char*) * result.as.object.capacity);
-                    result.as.object.values = realloc(result.as.object.values, 
-                                                      sizeof(Value*) * result.as.object.capacity);
-                }
-                result.as.object.keys[result.as.object.count] = strdup(key);
-                result.as.object.values[result.as.object.count] = malloc(sizeof(Value));
-                *result.as.object.values[result.as.object.count] = val;
-                result.as.object.count++;
+                object_set(&result, key, val);
             }
             
             // تخطي الفاصلة
@@ -257,10 +260,9 @@ Value lib_json_get(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    for (int i = 0; i < args[0].as.object.count; i++) {
-        if (strcmp(args[0].as.object.keys[i], args[1].as.string) == 0) {
-            return *args[0].as.object.values[i];
-        }
+    Value *val = object_get(&args[0], args[1].as.string);
+    if (val) {
+        return value_copy(val);
     }
     return value_create_null();
 }
@@ -271,28 +273,8 @@ Value lib_json_set(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    // البحث عن المفتاح
-    for (int i = 0; i < args[0].as.object.count; i++) {
-        if (strcmp(args[0].as.object.keys[i], args[1].as.string) == 0) {
-            value_free(args[0].as.object.values[i]);
-            *args[0].as.object.values[i] = args[2];
-            return args[0];
-        }
-    }
-    
-    // إضافة مفتاح جديد
-    if (args[0].as.object.count >= args[0].as.object.capacity) {
-        args[0].as.object.capacity *= 2;
-        args[0].as.object.keys = realloc(args[0].as.object.keys, 
-                                          sizeof(char*) * args[0].as.object.capacity);
-        args[0].as.object.values = realloc(args[0].as.object.values, 
-                                            sizeof(Value*) * args[0].as.object.capacity);
-    }
-    
-    args[0].as.object.keys[args[0].as.object.count] = strdup(args[1].as.string);
-    args[0].as.object.values[args[0].as.object.count] = malloc(sizeof(Value));
-    *args[0].as.object.values[args[0].as.object.count] = args[2];
-    args[0].as.object.count++;
-    
-    return args[0];
+    // يعاد كائن جديد لأن المعاملات تحرر بعد الاستدعاء
+    Value result = value_copy(&args[0]);
+    object_set(&result, args[1].as.string, value_copy(&args[2]));
+    return result;
 }
@@ -2,40 +2,163 @@
 #include <string.h>
 #include <stdlib.h>
 
+// الدوال المعدلة تحول المدى إلى مصفوفة أولاً، والقارئة تحسب من حدوده مباشرة
+static void list_materialize(Value *args, int arg_count) {
+    if (arg_count >= 1) {
+        range_materialize(&args[0]);
+    }
+}
+
+// تطبيق دالة على العناصر في مرور واحد (طبق، رشح)
+static Value list_apply(Value *args, int arg_count, PipelineStage stage) {
+    if (arg_count < 2 || !value_is_iterable(&args[0])) {
+        return value_create_null();
+    }
+    if (args[1].type != VAL_FUNCTION) {
+        return value_create_exception("المعامل الثاني يجب أن يكون دالة", 4);
+    }
+    if (args[0].type == VAL_PIPELINE) {
+        return pipeline_extend(&args[0], stage, value_copy(&args[1]), 0);
+    }
+    
+    Value result = value_create_array();
+    if (stage == STAGE_MAP && args[0].type == VAL_ARRAY) {
+        array_reserve(&result, args[0].as.array.count);
+    }
+    
+    int64_t position = 0;
+    Value item;
+    while (value_iterate(&args[0], &position, &item)) {
+        Value output = item;
+        if (item.type != VAL_EXCEPTION) {
+            output = value_call(&args[1], &item, 1);
+            if (output.type == VAL_EXCEPTION) value_free(&item);
+        }
+        if (output.type == VAL_EXCEPTION) {
+            value_iterate_end(&args[0], &position);
+            value_free(&result);
+            return output;
+        }
+        if (stage == STAGE_FILTER) {
+            bool keep = value_is_truthy(&output);
+            value_free(&output);
+            if (!keep) {
+                value_free(&item);
+                continue;
+            }
+            output = item;
+        } else {
+            value_free(&item);
+        }
+        
+        Value *slot = malloc(sizeof(Value));
+        *slot = output;
+        array_append(&result, slot);
+    }
+    return result;
+}
+
 // إنشاء قائمة جديدة
 Value lib_list_create(Value *args, int arg_count) {
     return value_create_array();
 }
 
+// مدى(نهاية) أو مدى(بداية، نهاية، خطوة): أعداد صحيحة كسولة، والنهاية غير مشمولة
+Value lib_list_range(Value *args, int arg_count) {
+    if (arg_count < 1 || arg_count > 3) {
+        return value_create_exception("مدى يتطلب من معامل إلى ثلاثة", 4);
+    }
+    
+    int64_t bounds[3] = {0, 0, 1};
+    for (int i = 0; i < arg_count; i++) {
+        if (!value_is_number(&args[i]) ||
+            value_as_number(&args[i]) != (double)(int64_t)value_as_number(&args[i])) {
+            return value_create_exception("حدود المدى يجب أن تكون أعداداً صحيحة", 4);
+        }
+    }
+    if (arg_count == 1) {
+        bounds[1] = (int64_t)value_as_number(&args[0]);
+    } else {
+        for (int i = 0; i < arg_count; i++) {
+            bounds[i] = (int64_t)value_as_number(&args[i]);
+        }
+    }
+    if (bounds[2] == 0) {
+        return value_create_exception("خطوة المدى لا تكون صفراً", 4);
+    }
+    return value_create_range(bounds[0], bounds[1], bounds[2]);
+}
+
 // إضافة عنصر
 Value lib_list_add(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
+    if (arg_count >= 2 && args[0].type == VAL_VECTOR) {
+        // نسخة جديدة لأن المعاملات تحرر بعد الاستدعاء (تشارك الشجرة وينسخ مسار الإضافة فقط)
+        Value result = value_copy(&args[0]);
+        vector_push(&result, value_copy(&args[1]));
+        return result;
+    }
     if (arg_count < 2 || args[0].type != VAL_ARRAY) {
         return value_create_null();
     }
     
     Value *arr = &args[0];
     Value *item = malloc(sizeof(Value));
+    *item = value_copy(&args[1]);
+    array_append(arr, item);
+    return *arr;
+}
+
+// إضافة في النهاية (اسم بديل لـ lib_list_add)
+Value lib_list_push(Value *args, int arg_count) {
+    return lib_list_add(args, arg_count);
+}
+
+// حذف آخر عنصر وإعادته
+Value lib_list_pop(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
+    if (arg_count < 1 || args[0].type != VAL_ARRAY || args[0].as.array.count == 0) {
+        return value_create_null();
+    }
     
-    if (args[1].type == VAL_NUMBER) {
-        *item = value_create_number(args[1].as.number);
-    } else if (args[1].type == VAL_STRING) {
-        *item = value_create_string(args[1].as.string);
-    } else {
-        *item = value_create_null();
+    Value *item = args[0].as.array.items[--args[0].as.array.count];
+    Value result = *item;
+    free(item);
+    return result;
+}
+
+// حذف أول عنصر وإعادته: O(1) بتقديم بداية المصفوفة دون نقل الباقي
+Value lib_list_shift(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
+    if (arg_count < 1 || args[0].type != VAL_ARRAY) {
+        return value_create_null();
     }
     
-    if (arr->as.array.count >= arr->as.array.capacity) {
-        arr->as.array.capacity *= 2;
-        arr->as.array.items = realloc(arr->as.array.items, 
-                                       sizeof(Value*) * arr->as.array.capacity);
+    Value *item = array_remove_first(&args[0]);
+    if (!item) {
+        return value_create_null();
+    }
+    Value result = *item;
+    free(item);
+    return result;
+}
+
+// إضافة في البداية: O(1) مطفأة في الفراغ قبل أول عنصر
+Value lib_list_unshift(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
+    if (arg_count < 2 || args[0].type != VAL_ARRAY) {
+        return value_create_null();
     }
     
-    arr->as.array.items[arr->as.array.count++] = item;
-    return *arr;
+    Value *item = malloc(sizeof(Value));
+    *item = value_copy(&args[1]);
+    array_prepend(&args[0], item);
+    return args[0];
 }
 
 // إدراج في موضع
 Value lib_list_insert(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
     if (arg_count < 3 || args[0].type != VAL_ARRAY || args[1].type != VAL_NUMBER) {
         return value_create_null();
     }
@@ -47,24 +170,16 @@ Value lib_list_insert(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    if (arr->as.array.count >= arr->as.array.capacity) {
-        arr->as.array.capacity *= 2;
-        arr->as.array.items = realloc(arr->as.array.items, 
-                                       sizeof(Value*) * arr->as.array.capacity);
-    }
-    
-    // Shift elements
-    for (int i = arr->as.array.count; i > index; i--) {
-        arr->as.array.items[i] = arr->as.array.items[i - 1];
-    }
-    
     Value *item = malloc(sizeof(Value));
-    if (args[2].type == VAL_NUMBER) {
-        *item = value_create_number(args[2].as.number);
-    } else if (args[2].type == VAL_STRING) {
-        *item = value_create_string(args[2].as.string);
+    *item = value_copy(&args[2]);
+    if (index == 0) {
+        array_prepend(arr, item);
+        return *arr;
     }
     
+    array_reserve(arr, arr->as.array.count + 1);
+    memmove(&arr->as.array.items[index + 1], &arr->as.array.items[index],
+            sizeof(Value*) * (arr->as.array.count - index));
     arr->as.array.items[index] = item;
     arr->as.array.count++;
     return *arr;
@@ -72,6 +187,7 @@ Value lib_list_insert(Value *args, int arg_count) {
 
 // حذف من موضع
 Value lib_list_remove(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
     if (arg_count < 2 || args[0].type != VAL_ARRAY || args[1].type != VAL_NUMBER) {
         return value_create_null();
     }
@@ -83,6 +199,14 @@ Value lib_list_remove(Value *args, int arg_count) {
         return value_create_null();
     }
     
+    // الحذف من البداية لا ينقل الباقي
+    if (index == 0) {
+        Value *item = array_remove_first(arr);
+        value_free(item);
+        free(item);
+        return *arr;
+    }
+    
     // Free the item
     value_free(arr->as.array.items[index]);
     free(arr->as.array.items[index]);
@@ -98,6 +222,17 @@ Value lib_list_remove(Value *args, int arg_count) {
 
 // الحصول على عنصر
 Value lib_list_get(Value *args, int arg_count) {
+    if (arg_count >= 2 && args[0].type == VAL_RANGE && args[1].type == VAL_NUMBER) {
+        int64_t index = (int64_t)args[1].as.number;
+        if (index < 0 || index >= range_length(&args[0])) {
+            return value_create_null();
+        }
+        return value_create_int(args[0].as.range.start + index * args[0].as.range.step);
+    }
+    if (arg_count >= 2 && args[0].type == VAL_VECTOR && args[1].type == VAL_NUMBER) {
+        Value *item = vector_get(&args[0], (int)args[1].as.number);
+        return item ? *item : value_create_null();
+    }
     if (arg_count < 2 || args[0].type != VAL_ARRAY || args[1].type != VAL_NUMBER) {
         return value_create_null();
     }
@@ -114,6 +249,19 @@ Value lib_list_get(Value *args, int arg_count) {
 
 // تعيين عنصر
 Value lib_list_set(Value *args, int arg_count) {
+    if (arg_count >= 3 && args[0].type == VAL_VECTOR && args[1].type == VAL_NUMBER) {
+        // نسخة جديدة لأن المعاملات تحرر بعد الاستدعاء، وينسخ فيها مسار العنصر فقط
+        int index = (int)args[1].as.number;
+        if (index < 0 || index >= args[0].as.vector.count) {
+            return value_create_null();
+        }
+        Value result = value_copy(&args[0]);
+        Value *slot = vector_slot(&result, index);
+        value_free(slot);
+        *slot = value_copy(&args[2]);
+        return result;
+    }
+    list_materialize(args, arg_count);
     if (arg_count < 3 || args[0].type != VAL_ARRAY || args[1].type != VAL_NUMBER) {
         return value_create_null();
     }
@@ -138,29 +286,44 @@ Value lib_list_set(Value *args, int arg_count) {
 
 // حجم القائمة
 Value lib_list_size(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_RANGE) {
+        return value_create_number((double)range_length(&args[0]));
+    }
+    if (arg_count >= 1 && args[0].type == VAL_VECTOR) {
+        return value_create_number(args[0].as.vector.count);
+    }
     if (arg_count < 1 || args[0].type != VAL_ARRAY) {
         return value_create_number(0);
     }
     return value_create_number(args[0].as.array.count);
 }
 
+// طول القائمة (اسم بديل لـ lib_list_size)
+Value lib_list_length(Value *args, int arg_count) {
+    return lib_list_size(args, arg_count);
+}
+
 // فهرس عنصر
 Value lib_list_index_of(Value *args, int arg_count) {
+    if (arg_count >= 2 && args[0].type == VAL_RANGE) {
+        return value_create_number((double)range_index_of(&args[0], &args[1]));
+    }
+    if (arg_count >= 2 && args[0].type == VAL_VECTOR) {
+        for (int i = 0; i < args[0].as.vector.count; i++) {
+            if (value_equals(vector_get(&args[0], i), &args[1])) {
+                return value_create_number(i);
+            }
+        }
+        return value_create_number(-1);
+    }
     if (arg_count < 2 || args[0].type != VAL_ARRAY) {
         return value_create_number(-1);
     }
     
     Value *arr = &args[0];
     for (int i = 0; i < arr->as.array.count; i++) {
-        if (arr->as.array.items[i]->type == args[1].type) {
-            if (args[1].type == VAL_NUMBER && 
-                arr->as.array.items[i]->as.number == args[1].as.number) {
-                return value_create_number(i);
-            }
-            if (args[1].type == VAL_STRING && 
-                strcmp(arr->as.array.items[i]->as.string, args[1].as.string) == 0) {
-                return value_create_number(i);
-            }
+        if (value_equals(arr->as.array.items[i], &args[1])) {
+            return value_create_number(i);
         }
     }
     return value_create_number(-1);
@@ -174,6 +337,7 @@ Value lib_list_contains(Value *args, int arg_count) {
 
 // عكس القائمة
 Value lib_list_reverse(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
     if (arg_count < 1 || args[0].type != VAL_ARRAY) {
         return value_create_null();
     }
@@ -190,6 +354,10 @@ Value lib_list_reverse(Value *args, int arg_count) {
 
 // نسخ القائمة
 Value lib_list_copy(Value *args, int arg_count) {
+    // نسخ المتجه O(1): يشارك الأصل شجرته، والمدى قيمة ثابتة الحجم
+    if (arg_count >= 1 && (args[0].type == VAL_VECTOR || args[0].type == VAL_RANGE)) {
+        return value_copy(&args[0]);
+    }
     if (arg_count < 1 || args[0].type != VAL_ARRAY) {
         return value_create_null();
     }
@@ -199,11 +367,7 @@ Value lib_list_copy(Value *args, int arg_count) {
     
     for (int i = 0; i < arr->as.array.count; i++) {
         Value *item = malloc(sizeof(Value));
-        if (arr->as.array.items[i]->type == VAL_NUMBER) {
-            *item = value_create_number(arr->as.array.items[i]->as.number);
-        } else if (arr->as.array.items[i]->type == VAL_STRING) {
-            *item = value_create_string(arr->as.array.items[i]->as.string);
-        }
+        *item = value_copy(arr->as.array.items[i]);
         
         if (result.as.array.count >= result.as.array.capacity) {
             result.as.array.capacity *= 2;
@@ -231,26 +395,58 @@ Value lib_list_merge(Value *args, int arg_count) {
     return result;
 }
 
-// تصفية القائمة
+// تصفية القائمة بدالة: مصفوفة واحدة بالعناصر التي تعيد لها قيمة صادقة
+// على سلسلة كسولة تضيف مرحلة فقط، ولا تستدعى الدالة إلا عند الجمع
 Value lib_list_filter(Value *args, int arg_count) {
-    if (arg_count < 2 || args[0].type != VAL_ARRAY) {
-        return value_create_null();
-    }
-    // Simplified - would need function pointer in real implementation
-    return args[0];
+    return list_apply(args, arg_count, STAGE_FILTER);
 }
 
-// خريطة القائمة
+// تحويل كل عنصر بدالة إلى مصفوفة جديدة (أو مرحلة في سلسلة كسولة)
 Value lib_list_map(Value *args, int arg_count) {
-    if (arg_count < 2 || args[0].type != VAL_ARRAY) {
+    return list_apply(args, arg_count, STAGE_MAP);
+}
+
+// طي العناصر بدالة من معاملين (المجمع، العنصر)، بدءاً من القيمة الابتدائية إن مررت وإلا من أول عنصر
+Value lib_list_reduce(Value *args, int arg_count) {
+    if (arg_count < 2 || !value_is_iterable(&args[0])) {
         return value_create_null();
     }
-    // Simplified - would need function pointer in real implementation
-    return args[0];
+    if (args[1].type != VAL_FUNCTION) {
+        return value_create_exception("المعامل الثاني يجب أن يكون دالة", 4);
+    }
+    
+    bool has_acc = arg_count >= 3;
+    Value acc = has_acc ? value_copy(&args[2]) : value_create_null();
+    int64_t position = 0;
+    Value item;
+    while (value_iterate(&args[0], &position, &item)) {
+        if (item.type == VAL_EXCEPTION) {
+            value_iterate_end(&args[0], &position);
+            value_free(&acc);
+            return item;
+        }
+        if (!has_acc) {
+            acc = item;
+            has_acc = true;
+            continue;
+        }
+        
+        Value pair[2] = {acc, item};
+        Value next = value_call(&args[1], pair, 2);
+        value_free(&acc);
+        value_free(&item);
+        acc = next;
+        if (acc.type == VAL_EXCEPTION) {
+            value_iterate_end(&args[0], &position);
+            return acc;
+        }
+    }
+    return acc;
 }
 
 // ترتيب القائمة
 Value lib_list_sort(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
     if (arg_count < 1 || args[0].type != VAL_ARRAY) {
         return value_create_null();
     }
@@ -262,10 +458,10 @@ Value lib_list_sort(Value *args, int arg_count) {
     for (int i = 0; i < n - 1; i++) {
         for (int j = 0; j < n - i - 1; j++) {
             int should_swap = 0;
-            if (arr->as.array.items[j]->type == VAL_NUMBER && 
-                arr->as.array.items[j + 1]->type == VAL_NUMBER) {
-                should_swap = arr->as.array.items[j]->as.number > 
-                             arr->as.array.items[j + 1]->as.number;
+            if (value_is_number(arr->as.array.items[j]) && 
+                value_is_number(arr->as.array.items[j + 1])) {
+                should_swap = value_as_number(arr->as.array.items[j]) > 
+                             value_as_number(arr->as.array.items[j + 1]);
             } else if (arr->as.array.items[j]->type == VAL_STRING && 
                       arr->as.array.items[j + 1]->type == VAL_STRING) {
                 should_swap = strcmp(arr->as.array.items[j]->as.string, 
@@ -284,6 +480,7 @@ Value lib_list_sort(Value *args, int arg_count) {
 
 // مسح القائمة
 Value lib_list_clear(Value *args, int arg_count) {
+    list_materialize(args, arg_count);
     if (arg_count < 1 || args[0].type != VAL_ARRAY) {
         return value_create_null();
     }
@@ -299,6 +496,11 @@ Value lib_list_clear(Value *args, int arg_count) {
 
 // أول عنصر
 Value lib_list_first(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_RANGE) {
+        Value index = value_create_number(0);
+        Value get_args[2] = {args[0], index};
+        return lib_list_get(get_args, 2);
+    }
     if (arg_count < 1 || args[0].type != VAL_ARRAY || args[0].as.array.count == 0) {
         return value_create_null();
     }
@@ -307,54 +509,132 @@ Value lib_list_first(Value *args, int arg_count) {
 
 // آخر عنصر
 Value lib_list_last(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_RANGE) {
+        Value index = value_create_number((double)(range_length(&args[0]) - 1));
+        Value get_args[2] = {args[0], index};
+        return lib_list_get(get_args, 2);
+    }
     if (arg_count < 1 || args[0].type != VAL_ARRAY || args[0].as.array.count == 0) {
         return value_create_null();
     }
     return *args[0].as.array.items[args[0].as.array.count - 1];
 }
 
-// أخذ n عنصر من البداية
-Value lib_list_take(Value *args, int arg_count) {
-    if (arg_count < 2 || args[0].type != VAL_ARRAY || args[1].type != VAL_NUMBER) {
+// أخذ n عنصر من البداية أو تخطيها: المدى يعطي مدى أقصر في O(1)، والسلسلة الكسولة مرحلة جديدة
+static Value list_slice_front(Value *args, int arg_count, PipelineStage stage) {
+    if (arg_count < 2 || args[1].type != VAL_NUMBER) {
         return value_create_null();
     }
     
-    int n = (int)args[1].as.number;
+    int64_t n = (int64_t)args[1].as.number;
     if (n < 0) n = 0;
-    if (n > args[0].as.array.count) n = args[0].as.array.count;
+    
+    if (args[0].type == VAL_PIPELINE) {
+        return pipeline_extend(&args[0], stage, value_create_null(), n);
+    }
+    if (args[0].type == VAL_RANGE) {
+        int64_t length = range_length(&args[0]);
+        int64_t split = args[0].as.range.start + (n < length ? n : length) * args[0].as.range.step;
+        if (stage == STAGE_TAKE) {
+            return value_create_range(args[0].as.range.start, split, args[0].as.range.step);
+        }
+        return value_create_range(split, args[0].as.range.stop, args[0].as.range.step);
+    }
+    if (args[0].type != VAL_ARRAY) {
+        return value_create_null();
+    }
+    
+    int count = args[0].as.array.count;
+    if (n > count) n = count;
+    int from = stage == STAGE_TAKE ? 0 : (int)n;
+    int to = stage == STAGE_TAKE ? (int)n : count;
     
     Value result = value_create_array();
-    for (int i = 0; i < n; i++) {
+    array_reserve(&result, to - from);
+    for (int i = from; i < to; i++) {
         Value *item = malloc(sizeof(Value));
-        if (args[0].as.array.items[i]->type == VAL_NUMBER) {
-            *item = value_create_number(args[0].as.array.items[i]->as.number);
-        } else if (args[0].as.array.items[i]->type == VAL_STRING) {
-            *item = value_create_string(args[0].as.array.items[i]->as.string);
-        }
-        result.as.array.items[result.as.array.count++] = item;
+        *item = value_copy(args[0].as.array.items[i]);
+        array_append(&result, item);
     }
     return result;
 }
 
+// أخذ n عنصر من البداية
+Value lib_list_take(Value *args, int arg_count) {
+    return list_slice_front(args, arg_count, STAGE_TAKE);
+}
+
 // تخطي n عنصر
 Value lib_list_skip(Value *args, int arg_count) {
-    if (arg_count < 2 || args[0].type != VAL_ARRAY || args[1].type != VAL_NUMBER) {
+    return list_slice_front(args, arg_count, STAGE_SKIP);
+}
+
+// سلسلة كسولة فوق أي قيمة قابلة للمرور: طبق ورشح وخذ وتخطى عليها تندمج في مرور واحد
+Value lib_list_lazy(Value *args, int arg_count) {
+    if (arg_count < 1 || !value_is_iterable(&args[0])) {
+        return value_create_exception("السلسلة الكسولة تنشأ من قيمة قابلة للمرور", 4);
+    }
+    if (args[0].type == VAL_PIPELINE) {
+        return value_copy(&args[0]);
+    }
+    return value_create_pipeline(value_copy(&args[0]));
+}
+
+// تنفيذ سلسلة كسولة إلى مصفوفة (وأي قيمة قابلة للمرور تجمع عناصرها كذلك)
+Value lib_list_collect(Value *args, int arg_count) {
+    if (arg_count < 1 || !value_is_iterable(&args[0])) {
         return value_create_null();
     }
+    if (args[0].type == VAL_PIPELINE) {
+        return pipeline_collect(&args[0]);
+    }
     
-    int n = (int)args[1].as.number;
-    if (n < 0) n = 0;
-    if (n > args[0].as.array.count) n = args[0].as.array.count;
+    Value pipeline = value_create_pipeline(value_copy(&args[0]));
+    Value result = pipeline_collect(&pipeline);
+    value_free(&pipeline);
+    return result;
+}
+
+// إزالة التكرار مع حفظ ترتيب الظهور الأول
+// جدول تجزئة لمواضع العناصر المحفوظة يجعل كل فحص O(1) في المتوسط
+Value lib_list_unique(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_ARRAY) {
+        return value_create_null();
+    }
     
+    Value *arr = &args[0];
     Value result = value_create_array();
-    for (int i = n; i < args[0].as.array.count; i++) {
-        Value *item = malloc(sizeof(Value));
-        if (args[0].as.array.items[i]->type == VAL_NUMBER) {
-            *item = value_create_number(args[0].as.array.items[i]->as.number);
-        } else if (args[0].as.array.items[i]->type == VAL_STRING) {
-            *item = value_create_string(args[0].as.array.items[i]->as.string);
+    
+    int capacity = 16;
+    while (capacity < arr->as.array.count * 2) capacity *= 2;
+    unsigned int mask = (unsigned int)capacity - 1;
+    int *seen = malloc(sizeof(int) * capacity);
+    for (int i = 0; i < capacity; i++) seen[i] = -1;
+    
+    for (int i = 0; i < arr->as.array.count; i++) {
+        Value *item = arr->as.array.items[i];
+        unsigned int slot = value_hash(item) & mask;
+        bool duplicate = false;
+        while (seen[slot] >= 0) {
+            if (value_equals(arr->as.array.items[seen[slot]], item)) {
+                duplicate = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
         }
-        result.as.array.items[result.as.array.count++] = item;
+        if (duplicate) continue;
+        seen[slot] = i;
+        
+        if (result.as.array.count >= result.as.array.capacity) {
+            result.as.array.capacity *= 2;
+            result.as.array.items = realloc(result.as.array.items,
+                                             sizeof(Value*) * result.as.array.capacity);
+        }
+        Value *copy = malloc(sizeof(Value));
+        *copy = value_copy(item);
+        result.as.array.items[result.as.array.count++] = copy;
     }
+    
+    free(seen);
     return result;
 }
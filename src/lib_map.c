@@ -0,0 +1,193 @@
+#include "wisam.h"
+#include <string.h>
+#include <stdlib.h>
+
+// إلحاق نسخة من قيمة بمصفوفة
+static void array_push(Value *arr, Value value) {
+    Value *item = malloc(sizeof(Value));
+    *item = value;
+    array_append(arr, item);
+}
+
+// إنشاء خريطة، اختيارياً من مصفوفة أزواج [[مفتاح، قيمة]، ...]
+Value lib_map_create(Value *args, int arg_count) {
+    Value map = value_create_map();
+    if (arg_count < 1 || args[0].type != VAL_ARRAY) {
+        return map;
+    }
+    
+    for (int i = 0; i < args[0].as.array.count; i++) {
+        Value *pair = args[0].as.array.items[i];
+        if (pair->type != VAL_ARRAY || pair->as.array.count != 2) continue;
+        if (!value_is_hashable(pair->as.array.items[0])) continue;
+        map_set(&map, value_copy(pair->as.array.items[0]), value_copy(pair->as.array.items[1]));
+    }
+    return map;
+}
+
+// قيمة مفتاح، أو القيمة الافتراضية (فارغ إن لم تمرر) إن لم يوجد
+Value lib_map_get(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_MAP) {
+        return value_create_null();
+    }
+    
+    Value *value = value_is_hashable(&args[1]) ? map_get(&args[0], &args[1]) : NULL;
+    if (value) {
+        return value_copy(value);
+    }
+    return arg_count >= 3 ? value_copy(&args[2]) : value_create_null();
+}
+
+// تعيين قيمة مفتاح
+Value lib_map_set(Value *args, int arg_count) {
+    if (arg_count < 3 || args[0].type != VAL_MAP) {
+        return value_create_null();
+    }
+    if (!value_is_hashable(&args[1])) {
+        return value_create_exception("المفتاح غير قابل للتجزئة", 14);
+    }
+    
+    // تعاد خريطة جديدة لأن المعاملات تحرر بعد الاستدعاء
+    Value result = value_copy(&args[0]);
+    map_set(&result, value_copy(&args[1]), value_copy(&args[2]));
+    return result;
+}
+
+// حذف مفتاح
+Value lib_map_delete(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_MAP) {
+        return value_create_boolean(false);
+    }
+    if (!value_is_hashable(&args[1])) {
+        return value_create_boolean(false);
+    }
+    return value_create_boolean(map_delete(&args[0], &args[1]));
+}
+
+// هل المفتاح موجود؟
+Value lib_map_has(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_MAP || !value_is_hashable(&args[1])) {
+        return value_create_boolean(false);
+    }
+    return value_create_boolean(map_get(&args[0], &args[1]) != NULL);
+}
+
+// عدد المفاتيح
+Value lib_map_size(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_MAP) {
+        return value_create_number(0);
+    }
+    return value_create_number(args[0].as.map->count);
+}
+
+// المفاتيح بترتيب الجدول
+Value lib_map_keys(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_MAP) {
+        return value_create_null();
+    }
+    
+    Map *map = args[0].as.map;
+    Value result = value_create_array();
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->entries[i].distance < 0) continue;
+        array_push(&result, value_copy(&map->entries[i].key));
+    }
+    return result;
+}
+
+// القيم بترتيب المفاتيح نفسه
+Value lib_map_values(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_MAP) {
+        return value_create_null();
+    }
+    
+    Map *map = args[0].as.map;
+    Value result = value_create_array();
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->entries[i].distance < 0) continue;
+        array_push(&result, value_copy(map->entries[i].value));
+    }
+    return result;
+}
+
+// الأزواج [[مفتاح، قيمة]، ...] (يقبلها lib_map_create لإعادة البناء)
+Value lib_map_entries(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_MAP) {
+        return value_create_null();
+    }
+    
+    Map *map = args[0].as.map;
+    Value result = value_create_array();
+    for (int i = 0; i < map->capacity; i++) {
+        if (map->entries[i].distance < 0) continue;
+        Value pair = value_create_array();
+        array_push(&pair, value_copy(&map->entries[i].key));
+        array_push(&pair, value_copy(map->entries[i].value));
+        array_push(&result, pair);
+    }
+    return result;
+}
+
+// دمج خريطتين في خريطة جديدة، وقيم الثانية تغلب عند تكرار المفتاح
+Value lib_map_merge(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_MAP || args[1].type != VAL_MAP) {
+        return value_create_null();
+    }
+    
+    Value result = value_copy(&args[0]);
+    Map *second = args[1].as.map;
+    for (int i = 0; i < second->capacity; i++) {
+        if (second->entries[i].distance < 0) continue;
+        map_set(&result, value_copy(&second->entries[i].key), value_copy(second->entries[i].value));
+    }
+    return result;
+}
+
+// عد تكرار عناصر قائمة: {عنصر: عدد مرات ظهوره}
+Value lib_map_count(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_ARRAY) {
+        return value_create_null();
+    }
+    
+    Value result = value_create_map();
+    for (int i = 0; i < args[0].as.array.count; i++) {
+        Value *item = args[0].as.array.items[i];
+        if (!value_is_hashable(item)) continue;
+        
+        Value *count = map_get(&result, item);
+        if (count) {
+            count->as.integer++;
+        } else {
+            map_set(&result, value_copy(item), value_create_int(1));
+        }
+    }
+    return result;
+}
+
+// تجميع عناصر قائمة حسب خاصية: {قيمة الخاصية: [العناصر التي تحملها]}
+// العناصر كائنات أو هياكل، وما لا يحمل الخاصية يتجاوز
+Value lib_map_group(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_ARRAY || args[1].type != VAL_STRING) {
+        return value_create_null();
+    }
+    
+    Value result = value_create_map();
+    for (int i = 0; i < args[0].as.array.count; i++) {
+        Value *item = args[0].as.array.items[i];
+        Value *key = NULL;
+        if (item->type == VAL_OBJECT) {
+            key = object_get(item, args[1].as.string);
+        } else if (item->type == VAL_STRUCT) {
+            int field = shape_find(item->as.structure->def->shape, args[1].as.string);
+            if (field >= 0) key = &item->as.structure->fields[field];
+        }
+        if (!key || !value_is_hashable(key)) continue;
+        
+        Value *group = map_get(&result, key);
+        if (!group) {
+            group = map_set(&result, value_copy(key), value_create_array());
+        }
+        array_push(group, value_copy(item));
+    }
+    return result;
+}
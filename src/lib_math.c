@@ -215,8 +215,8 @@ Value lib_math_sum(Value *args, int arg_count) {
     }
     double sum = 0;
     for (int i = 0; i < args[0].as.array.count; i++) {
-        if (args[0].as.array.items[i]->type == VAL_NUMBER) {
-            sum += args[0].as.array.items[i]->as.number;
+        if (value_is_number(args[0].as.array.items[i])) {
+            sum += value_as_number(args[0].as.array.items[i]);
         }
     }
     return value_create_number(sum);
@@ -240,7 +240,7 @@ Value lib_math_median(Value *args, int arg_count) {
     // Create array of numbers
     double *arr = malloc(n * sizeof(double));
     for (int i = 0; i < n; i++) {
-        arr[i] = args[0].as.array.items[i]->as.number;
+        arr[i] = value_as_number(args[0].as.array.items[i]);
     }
     
     // Simple bubble sort
@@ -62,19 +62,9 @@ Value lib_meta_system_info(Value *args, int arg_count) {
     
     struct utsname info;
     if (uname(&info) == 0) {
-        result.as.object.keys[0] = strdup("نظام");
-        result.as.object.values[0] = malloc(sizeof(Value));
-        *result.as.object.values[0] = value_create_string(info.sysname);
-        
-        result.as.object.keys[1] = strdup("إصدار");
-        result.as.object.values[1] = malloc(sizeof(Value));
-        *result.as.object.values[1] = value_create_string(info.release);
-        
-        result.as.object.keys[2] = strdup("معمارية");
-        result.as.object.values[2] = malloc(sizeof(Value));
-        *result.as.object.values[2] = value_create_string(info.machine);
-        
-        result.as.object.count = 3;
+        object_set(&result, "نظام", value_create_string(info.sysname));
+        object_set(&result, "إصدار", value_create_string(info.release));
+        object_set(&result, "معمارية", value_create_string(info.machine));
     }
     
     return result;
@@ -151,3 +141,31 @@ Value lib_meta_setenv(Value *args, int arg_count) {
     setenv(args[0].as.string, args[1].as.string, 1);
     return value_create_boolean(true);
 }
+
+// إحصاءات ذاكرة نتائج الدوال النقية: {اسم_الدالة: {إصابات، إخفاقات، مدخلات}}
+// أو إحصاءات دالة واحدة إذا مرر اسمها
+Value lib_meta_memo_stats(Value *args, int arg_count) {
+    const char *name = (arg_count >= 1 && args[0].type == VAL_STRING) ? args[0].as.string : NULL;
+    Value result = value_create_object();
+    
+    for (FunctionMemo *memo = memo_registry(); memo; memo = memo->next) {
+        if (name && strcmp(memo->name, name) != 0) continue;
+        
+        Value stats = value_create_object();
+        object_set(&stats, "إصابات", value_create_number(memo->hits));
+        object_set(&stats, "إخفاقات", value_create_number(memo->misses));
+        object_set(&stats, "مدخلات", value_create_number(memo->count));
+        
+        if (name) {
+            value_free(&result);
+            return stats;
+        }
+        object_set(&result, memo->name, stats);
+    }
+    
+    if (name) {
+        value_free(&result);
+        return value_create_null();
+    }
+    return result;
+}
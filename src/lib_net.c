@@ -73,15 +73,8 @@ Value lib_net_http_get(Value *args, int arg_count) {
     Value result = value_create_object();
     
     // إضافة الحقول
-    result.as.object.keys[0] = strdup("status");
-    result.as.object.values[0] = malloc(sizeof(Value));
-    *result.as.object.values[0] = value_create_number(http_code);
-    
-    result.as.object.keys[1] = strdup("body");
-    result.as.object.values[1] = malloc(sizeof(Value));
-    *result.as.object.values[1] = value_create_string(resp.data);
-    
-    result.as.object.count = 2;
+    object_set(&result, "status", value_create_number(http_code));
+    object_set(&result, "body", value_create_string(resp.data));
     
     free(resp.data);
     
@@ -139,15 +132,8 @@ Value lib_net_http_post(Value *args, int arg_count) {
     
     Value result = value_create_object();
     
-    result.as.object.keys[0] = strdup("status");
-    result.as.object.values[0] = malloc(sizeof(Value));
-    *result.as.object.values[0] = value_create_number(http_code);
-    
-    result.as.object.keys[1] = strdup("body");
-    result.as.object.values[1] = malloc(sizeof(Value));
-    *result.as.object.values[1] = value_create_string(resp.data);
-    
-    result.as.object.count = 2;
+    object_set(&result, "status", value_create_number(http_code));
+    object_set(&result, "body", value_create_string(resp.data));
     
     free(resp.data);
     
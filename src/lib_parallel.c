@@ -0,0 +1,662 @@
+#include "wisam.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <unistd.h>
+
+// عدد القطع لكل عامل: قطع أصغر توزع الحمل إن تفاوتت كلفة العناصر
+#define PARALLEL_CHUNKS_PER_WORKER 4
+
+// سعة طابور كل خيط (قوة للعدد 2)؛ المهمة التي لا تسعها تنفذ فوراً في خيط من أنشأها
+#define DEQUE_CAPACITY 4096
+
+typedef struct {
+    ParallelTaskFn run;
+    void *context;
+    Interpreter *parent;            // NULL للمهام التي لا تنفذ شيفرة وسام أو تجلب مفسرها معها
+} SchedulerTask;
+
+// طابور Chase-Lev: صاحبه يضيف ويأخذ من الأسفل دون أقفال، والخيوط الأخرى تسرق من الأعلى
+// فيعمل الصاحب على أحدث مهامه ويأخذ السارق أقدمها (وهي غالباً الأكبر)
+typedef struct {
+    int64_t top;
+    int64_t bottom;
+    SchedulerTask *slots[DEQUE_CAPACITY];
+} Deque;
+
+static bool deque_push(Deque *deque, SchedulerTask *task) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    if (bottom - top >= DEQUE_CAPACITY) return false;
+    
+    __atomic_store_n(&deque->slots[bottom & (DEQUE_CAPACITY - 1)], task, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// أخذ أحدث مهمة (للصاحب وحده)؛ ينافس السارقين على المهمة الأخيرة فقط
+static SchedulerTask *deque_take(Deque *deque) {
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_SEQ_CST);
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+    
+    if (top > bottom) {
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+    
+    SchedulerTask *task = __atomic_load_n(&deque->slots[bottom & (DEQUE_CAPACITY - 1)], __ATOMIC_RELAXED);
+    if (top == bottom) {
+        if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+                                         __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            task = NULL;
+        }
+        __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return task;
+}
+
+// سرقة أقدم مهمة (لأي خيط)؛ تفشل إن سبقه غيره إليها
+static SchedulerTask *deque_steal(Deque *deque) {
+    int64_t top = __atomic_load_n(&deque->top, __ATOMIC_SEQ_CST);
+    int64_t bottom = __atomic_load_n(&deque->bottom, __ATOMIC_SEQ_CST);
+    if (top >= bottom) return NULL;
+    
+    SchedulerTask *task = __atomic_load_n(&deque->slots[top & (DEQUE_CAPACITY - 1)], __ATOMIC_RELAXED);
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return NULL;
+    }
+    return task;
+}
+
+// المجدول: خيوط عمل ثابتة العدد تنشأ عند أول استخدام، لكل منها طابورها
+// الطابور 0 للخيوط من خارج المجدول (خيط كل مفسر)، فتضيف إليه مهامها وتعمل معها وهي تنتظر؛
+// وقد تكون عدة خيوط، فعمليات الصاحب عليه تتسلسل بقفل
+static struct {
+    pthread_t *threads;
+    int thread_count;
+    int configured;                 // حدد_العمال (0: WISAM_WORKERS أو عدد المعالجات)
+    bool started;
+    pthread_once_t once;
+    Deque *deques;
+    int queued;                     // المهام المضافة ولم تؤخذ بعد (ذري)
+    int sleepers;                   // خيوط العمل النائمة (ذري)
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    pthread_mutex_t external;       // صاحب الطابور 0
+} pool = {
+    NULL, 0, 0, false, PTHREAD_ONCE_INIT, NULL, 0, 0,
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_MUTEX_INITIALIZER
+};
+
+// طابور الخيط الجاري
+static __thread int thread_deque = 0;
+
+static void task_execute(SchedulerTask *task) {
+    Interpreter *worker = task->parent ? interpreter_create_worker(task->parent) : NULL;
+    task->run(worker, task->context);
+    if (worker) interpreter_destroy(worker);
+    free(task);
+}
+
+// مهمة من طابور الخيط نفسه، وإلا مسروقة من طوابير غيره بدءاً بالتالي له
+static SchedulerTask *scheduler_find(void) {
+    int deque_count = pool.thread_count + 1;
+    if (thread_deque == 0) pthread_mutex_lock(&pool.external);
+    SchedulerTask *task = deque_take(&pool.deques[thread_deque]);
+    if (thread_deque == 0) pthread_mutex_unlock(&pool.external);
+    for (int i = 1; !task && i < deque_count; i++) {
+        task = deque_steal(&pool.deques[(thread_deque + i) % deque_count]);
+    }
+    if (task) __atomic_fetch_sub(&pool.queued, 1, __ATOMIC_SEQ_CST);
+    return task;
+}
+
+static void *pool_thread(void *arg) {
+    thread_deque = (int)(intptr_t)arg;
+    
+    for (;;) {
+        SchedulerTask *task = scheduler_find();
+        if (task) {
+            task_execute(task);
+            continue;
+        }
+        
+        // النوم حتى تضاف مهمة؛ من يضيف يرى النائمين بعد زيادة queued فلا يضيع التنبيه
+        pthread_mutex_lock(&pool.lock);
+        __atomic_fetch_add(&pool.sleepers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&pool.queued, __ATOMIC_SEQ_CST) <= 0) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        __atomic_fetch_sub(&pool.sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    return NULL;
+}
+
+// عدد العمال (مع الخيط الرئيسي): حدد_العمال، أو WISAM_WORKERS في البيئة، أو عدد المعالجات
+int parallel_worker_count(void) {
+    if (pool.configured > 0) return pool.configured;
+    const char *configured = getenv("WISAM_WORKERS");
+    int count = configured ? atoi(configured) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
+}
+
+// تغيير عدد العمال قبل بدء المجدول؛ false إن كانت الخيوط قد أنشئت
+bool parallel_set_worker_count(int count) {
+    if (__atomic_load_n(&pool.started, __ATOMIC_ACQUIRE) || count < 1) return false;
+    pool.configured = count;
+    return true;
+}
+
+static void pool_start(void) {
+    pool.thread_count = parallel_worker_count() - 1;
+    if (pool.thread_count < 0) pool.thread_count = 0;
+    pool.deques = calloc(pool.thread_count + 1, sizeof(Deque));
+    __atomic_store_n(&pool.started, true, __ATOMIC_RELEASE);
+    if (pool.thread_count == 0) return;
+    
+    pool.threads = malloc(sizeof(pthread_t) * pool.thread_count);
+    for (int i = 0; i < pool.thread_count; i++) {
+        if (pthread_create(&pool.threads[i], NULL, pool_thread, (void*)(intptr_t)(i + 1)) != 0) {
+            pool.thread_count = i;
+            break;
+        }
+        pthread_detach(pool.threads[i]);
+    }
+}
+
+// إضافة مهمة إلى طابور الخيط الجاري؛ run تنفذ بمفسر عامل جديد إن عين parent
+void parallel_spawn(Interpreter *parent, ParallelTaskFn run, void *context) {
+    pthread_once(&pool.once, pool_start);
+    
+    SchedulerTask *task = malloc(sizeof(SchedulerTask));
+    task->run = run;
+    task->context = context;
+    task->parent = parent;
+    
+    __atomic_fetch_add(&pool.queued, 1, __ATOMIC_SEQ_CST);
+    if (thread_deque == 0) pthread_mutex_lock(&pool.external);
+    bool pushed = deque_push(&pool.deques[thread_deque], task);
+    if (thread_deque == 0) pthread_mutex_unlock(&pool.external);
+    if (!pushed) {
+        __atomic_fetch_sub(&pool.queued, 1, __ATOMIC_SEQ_CST);
+        task_execute(task);
+        return;
+    }
+    
+    if (__atomic_load_n(&pool.sleepers, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool.lock);
+        pthread_cond_signal(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+    }
+}
+
+// تنفيذ مهمة واحدة معلقة في الخيط الجاري، أو false إن لم توجد
+// (بلا خيوط عمل ينفذ الخيط الرئيسي كل المهام بهذه الطريقة)
+bool parallel_help(void) {
+    if (!__atomic_load_n(&pool.started, __ATOMIC_ACQUIRE)) return false;
+    
+    SchedulerTask *task = scheduler_find();
+    if (!task) return false;
+    task_execute(task);
+    return true;
+}
+
+// عدد القطع لعمل من items عنصراً: بضع قطع لكل عامل، ولا تزيد على العناصر
+int parallel_chunk_count(int64_t items) {
+    int64_t chunks = (int64_t)parallel_worker_count() * PARALLEL_CHUNKS_PER_WORKER;
+    return (int)(chunks < items ? chunks : items);
+}
+
+// قطع عمل واحد ينتظرها من أنشأها
+typedef struct {
+    ParallelChunkFn run;
+    void *context;
+    int remaining;                  // القطع التي لم تنته (ذري)
+} ForkJoin;
+
+typedef struct {
+    ForkJoin *join;
+    int chunk;
+} ForkJoinChunk;
+
+static void fork_join_chunk(Interpreter *worker, void *context) {
+    ForkJoinChunk *chunk = context;
+    ForkJoin *join = chunk->join;
+    join->run(worker, join->context, chunk->chunk);
+    
+    // آخر قطعة توقظ المنتظر إن كان نائماً
+    if (__atomic_sub_fetch(&join->remaining, 1, __ATOMIC_ACQ_REL) == 0) {
+        pthread_mutex_lock(&pool.lock);
+        pthread_cond_broadcast(&pool.wake);
+        pthread_mutex_unlock(&pool.lock);
+    }
+}
+
+// تنفيذ run لكل قطعة من 0 إلى chunk_count-1 على المجدول، والعودة بعد انتهائها كلها
+// run تكتب ناتج كل قطعة في موضعه من السياق، فالترتيب لا يتأثر بتوزيع القطع
+// المنتظر ينفذ قطعه وما يجده من مهام غيرها، وينام إن لم يبق إلا ما تنفذه خيوط أخرى
+void parallel_run(Interpreter *parent, int chunk_count, ParallelChunkFn run, void *context) {
+    ForkJoin join = {run, context, chunk_count};
+    ForkJoinChunk *chunks = malloc(sizeof(ForkJoinChunk) * (chunk_count ? chunk_count : 1));
+    
+    // بترتيب عكسي: الصاحب يأخذ القطعة 0 أولاً، والسارقون يبدؤون من آخر القطع
+    for (int i = chunk_count - 1; i >= 0; i--) {
+        chunks[i].join = &join;
+        chunks[i].chunk = i;
+        parallel_spawn(parent, fork_join_chunk, &chunks[i]);
+    }
+    
+    while (__atomic_load_n(&join.remaining, __ATOMIC_ACQUIRE) > 0) {
+        if (parallel_help()) continue;
+        
+        pthread_mutex_lock(&pool.lock);
+        __atomic_fetch_add(&pool.sleepers, 1, __ATOMIC_SEQ_CST);
+        while (__atomic_load_n(&join.remaining, __ATOMIC_ACQUIRE) > 0 &&
+               __atomic_load_n(&pool.queued, __ATOMIC_SEQ_CST) <= 0) {
+            pthread_cond_wait(&pool.wake, &pool.lock);
+        }
+        __atomic_fetch_sub(&pool.sleepers, 1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool.lock);
+    }
+    free(chunks);
+}
+
+// عمل متواز على عناصر قائمة: كل قطعة مدى متصل من الفهارس
+typedef struct {
+    Value *source;                  // مصفوفة أو مدى
+    Value *func;
+    int count;
+    int chunk_count;
+    Value *results;                 // طبق: ناتج كل عنصر، اختزل: ناتج كل قطعة
+    bool *keep;                     // رشح: هل يبقى العنصر
+    Value *errors;                  // أول استثناء في كل قطعة
+} ListJob;
+
+static void chunk_bounds(ListJob *job, int chunk, int *from, int *to) {
+    *from = (int)((int64_t)job->count * chunk / job->chunk_count);
+    *to = (int)((int64_t)job->count * (chunk + 1) / job->chunk_count);
+}
+
+// العنصر i من المصدر (نسخة جديدة)
+static Value job_item(ListJob *job, int i) {
+    if (job->source->type == VAL_RANGE) {
+        return value_create_int(job->source->as.range.start + (int64_t)i * job->source->as.range.step);
+    }
+    return value_copy(job->source->as.array.items[i]);
+}
+
+static void map_chunk(Interpreter *worker, void *context, int chunk) {
+    ListJob *job = context;
+    int from, to;
+    chunk_bounds(job, chunk, &from, &to);
+    for (int i = from; i < to; i++) {
+        Value item = job_item(job, i);
+        job->results[i] = interpreter_call(worker, job->func, &item, 1);
+        value_free(&item);
+        if (job->results[i].type == VAL_EXCEPTION) {
+            job->errors[chunk] = job->results[i];
+            job->results[i] = value_create_null();
+            return;
+        }
+    }
+}
+
+static void filter_chunk(Interpreter *worker, void *context, int chunk) {
+    ListJob *job = context;
+    int from, to;
+    chunk_bounds(job, chunk, &from, &to);
+    for (int i = from; i < to; i++) {
+        Value item = job_item(job, i);
+        Value test = interpreter_call(worker, job->func, &item, 1);
+        value_free(&item);
+        if (test.type == VAL_EXCEPTION) {
+            job->errors[chunk] = test;
+            return;
+        }
+        job->keep[i] = value_is_truthy(&test);
+        value_free(&test);
+    }
+}
+
+// طي القطعة من أول عناصرها؛ الدالة تجميعية فطي النواتج بالترتيب يساوي طي القائمة كلها
+static void reduce_chunk(Interpreter *worker, void *context, int chunk) {
+    ListJob *job = context;
+    int from, to;
+    chunk_bounds(job, chunk, &from, &to);
+    Value acc = job_item(job, from);
+    for (int i = from + 1; i < to; i++) {
+        Value pair[2] = {acc, job_item(job, i)};
+        Value next = interpreter_call(worker, job->func, pair, 2);
+        value_free(&pair[0]);
+        value_free(&pair[1]);
+        acc = next;
+        if (acc.type == VAL_EXCEPTION) {
+            job->errors[chunk] = acc;
+            acc = value_create_null();
+            break;
+        }
+    }
+    job->results[chunk] = acc;
+}
+
+// تحضير المهمة، أو false إن وجب التنفيذ المتسلسل (دالة غير نقية أو قائمة صغيرة)
+static bool list_job_init(ListJob *job, Value *args, int arg_count, Interpreter **parent) {
+    if (arg_count < 2 || (args[0].type != VAL_ARRAY && args[0].type != VAL_RANGE)) return false;
+    if (args[1].type != VAL_FUNCTION) return false;
+    
+    *parent = interpreter_current();
+    if (!*parent || !value_is_pure_function(*parent, &args[1])) return false;
+    
+    int64_t count = args[0].type == VAL_RANGE ? range_length(&args[0]) : args[0].as.array.count;
+    if (count < 2 || count > INT32_MAX) return false;
+    
+    job->source = &args[0];
+    job->func = &args[1];
+    job->count = (int)count;
+    job->chunk_count = parallel_chunk_count(job->count);
+    job->results = NULL;
+    job->keep = NULL;
+    job->errors = malloc(sizeof(Value) * job->chunk_count);
+    for (int i = 0; i < job->chunk_count; i++) {
+        job->errors[i] = value_create_null();
+    }
+    return true;
+}
+
+// أول استثناء بترتيب القطع (لا بترتيب حدوثه)، فالخطأ المعاد محدد كالناتج
+static bool list_job_error(ListJob *job, Value *error) {
+    bool failed = false;
+    for (int i = 0; i < job->chunk_count; i++) {
+        if (!failed && job->errors[i].type == VAL_EXCEPTION) {
+            *error = job->errors[i];
+            failed = true;
+        } else {
+            value_free(&job->errors[i]);
+        }
+    }
+    free(job->errors);
+    return failed;
+}
+
+// طبق_متوازي(قائمة، دالة): كطبق، والعناصر موزعة على العمال إن كانت الدالة نقية
+Value lib_parallel_map(Value *args, int arg_count) {
+    ListJob job;
+    Interpreter *parent;
+    if (!list_job_init(&job, args, arg_count, &parent)) {
+        return lib_list_map(args, arg_count);
+    }
+    
+    job.results = malloc(sizeof(Value) * job.count);
+    parallel_run(parent, job.chunk_count, map_chunk, &job);
+    
+    Value error;
+    if (list_job_error(&job, &error)) {
+        for (int i = 0; i < job.count; i++) {
+            value_free(&job.results[i]);
+        }
+        free(job.results);
+        return error;
+    }
+    
+    Value result = value_create_array();
+    array_reserve(&result, job.count);
+    for (int i = 0; i < job.count; i++) {
+        Value *slot = malloc(sizeof(Value));
+        *slot = job.results[i];
+        array_append(&result, slot);
+    }
+    free(job.results);
+    return result;
+}
+
+// رشح_متوازي(قائمة، دالة): الاختبارات متوازية، والعناصر الباقية تجمع بترتيبها
+Value lib_parallel_filter(Value *args, int arg_count) {
+    ListJob job;
+    Interpreter *parent;
+    if (!list_job_init(&job, args, arg_count, &parent)) {
+        return lib_list_filter(args, arg_count);
+    }
+    
+    job.keep = calloc(job.count, sizeof(bool));
+    parallel_run(parent, job.chunk_count, filter_chunk, &job);
+    
+    Value error;
+    if (list_job_error(&job, &error)) {
+        free(job.keep);
+        return error;
+    }
+    
+    Value result = value_create_array();
+    for (int i = 0; i < job.count; i++) {
+        if (!job.keep[i]) continue;
+        Value *slot = malloc(sizeof(Value));
+        *slot = job_item(&job, i);
+        array_append(&result, slot);
+    }
+    free(job.keep);
+    return result;
+}
+
+// اختزل_متوازي(قائمة، دالة، ابتدائي): الدالة يجب أن تكون تجميعية، فكل قطعة تطوى وحدها
+// ثم تطوى نواتج القطع بترتيبها بدءاً من القيمة الابتدائية، فالناتج لا يتغير بعدد العمال
+Value lib_parallel_reduce(Value *args, int arg_count) {
+    ListJob job;
+    Interpreter *parent;
+    if (!list_job_init(&job, args, arg_count, &parent)) {
+        return lib_list_reduce(args, arg_count);
+    }
+    
+    job.results = malloc(sizeof(Value) * job.chunk_count);
+    parallel_run(parent, job.chunk_count, reduce_chunk, &job);
+    
+    Value error;
+    if (list_job_error(&job, &error)) {
+        for (int i = 0; i < job.chunk_count; i++) {
+            value_free(&job.results[i]);
+        }
+        free(job.results);
+        return error;
+    }
+    
+    bool has_acc = arg_count >= 3;
+    Value acc = has_acc ? value_copy(&args[2]) : value_create_null();
+    for (int i = 0; i < job.chunk_count; i++) {
+        if (!has_acc) {
+            acc = job.results[i];
+            has_acc = true;
+            continue;
+        }
+        if (acc.type == VAL_EXCEPTION) {
+            value_free(&job.results[i]);
+            continue;
+        }
+        Value pair[2] = {acc, job.results[i]};
+        Value next = interpreter_call(parent, job.func, pair, 2);
+        value_free(&pair[0]);
+        value_free(&pair[1]);
+        acc = next;
+    }
+    free(job.results);
+    return acc;
+}
+
+// مهمة شغّل: الدالة ونسخ معاملاتها، ومفسر بنسخة من البيئة العامة تؤخذ عند الإنشاء
+// (البرنامج الرئيسي يتابع فيعرف ويستبدل دون أن يمس ما يقرؤه العامل)
+typedef struct {
+    Interpreter *interp;
+    Value func;
+    Value *args;
+    int arg_count;
+    Completion *completion;
+} SpawnJob;
+
+static void spawn_task(Interpreter *worker, void *context) {
+    (void)worker;
+    SpawnJob *job = context;
+    Value result = interpreter_call(job->interp, &job->func, job->args, job->arg_count);
+    for (int i = 0; i < job->arg_count; i++) {
+        value_free(&job->args[i]);
+    }
+    free(job->args);
+    interpreter_destroy(job->interp);
+    event_loop_complete(job->completion, result);
+    free(job);
+}
+
+// شغّل(دالة، معاملات...): وعد بناتج الدالة، تنفذ على المجدول إن كانت نقية
+// وغير النقية تستدعى فوراً في المفسر نفسه ويعاد وعد محقق بناتجها
+Value lib_parallel_spawn(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_FUNCTION) {
+        return value_create_exception("شغّل يتطلب دالة", 4);
+    }
+    Interpreter *parent = interpreter_current();
+    if (!parent) {
+        return value_create_exception("لا يوجد مفسر لتشغيل الدالة", 4);
+    }
+    
+    Value promise = value_create_promise();
+    Completion *completion = value_is_pure_function(parent, &args[0]) ? event_loop_expect(&promise) : NULL;
+    if (!completion) {
+        promise_settle(&promise, interpreter_call(parent, &args[0], args + 1, arg_count - 1));
+        return promise;
+    }
+    
+    SpawnJob *job = malloc(sizeof(SpawnJob));
+    job->interp = interpreter_create_snapshot(parent);
+    job->func = value_copy(&args[0]);
+    job->arg_count = arg_count - 1;
+    job->args = malloc(sizeof(Value) * (job->arg_count ? job->arg_count : 1));
+    for (int i = 0; i < job->arg_count; i++) {
+        job->args[i] = value_copy(&args[i + 1]);
+    }
+    job->completion = completion;
+    parallel_spawn(NULL, spawn_task, job);
+    return promise;
+}
+
+// انضم(وعد): ينتظره ويعيد ناتجه؛ ولمصفوفة وعود يعيد نواتجها بترتيبها
+// (أول وعد مرفوض يعاد استثناؤه)
+Value lib_parallel_join(Value *args, int arg_count) {
+    if (arg_count < 1) {
+        return value_create_exception("انضم يتطلب وعداً أو مصفوفة وعود", 4);
+    }
+    Interpreter *interp = interpreter_current();
+    if (args[0].type != VAL_ARRAY) {
+        return interpreter_await(interp, value_copy(&args[0]));
+    }
+    
+    Value results = value_create_array();
+    array_reserve(&results, args[0].as.array.count);
+    for (int i = 0; i < args[0].as.array.count; i++) {
+        Value result = interpreter_await(interp, value_copy(args[0].as.array.items[i]));
+        if (result.type == VAL_EXCEPTION) {
+            value_free(&results);
+            return result;
+        }
+        Value *slot = malloc(sizeof(Value));
+        *slot = result;
+        array_append(&results, slot);
+    }
+    return results;
+}
+
+// خيط مستقل لمفسر معزول: يملك الدالة والمعاملات حتى يسلم الناتج
+typedef struct {
+    Interpreter *interp;
+    Value func;
+    Value *args;
+    int arg_count;
+    Completion *completion;
+} ThreadJob;
+
+static void *isolated_thread(void *context) {
+    ThreadJob *job = context;
+    Value result = interpreter_run_isolated(job->interp, &job->func, job->args, job->arg_count);
+    event_loop_complete(job->completion, result);
+    free(job);
+    return NULL;
+}
+
+// خيط(دالة، معاملات...): تنفذ الدالة في مفسر معزول على خيط نظام مستقل وتعيد وعداً بناتجها
+// للخيط نسخته من المتغيرات العامة، فيتواصل مع غيره بالقنوات، وينتظر فيها دون أن يشغل
+// عمال المجدول؛ والمعاملات تنقل إليه دون نسخ
+Value lib_parallel_thread(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_FUNCTION || args[0].as.function.is_native) {
+        return value_create_exception("خيط يتطلب دالة وسام", 4);
+    }
+    Interpreter *parent = interpreter_current();
+    if (!parent) {
+        return value_create_exception("لا يوجد مفسر لتشغيل الدالة", 4);
+    }
+    for (int i = 1; i < arg_count; i++) {
+        if (!value_is_sendable(&args[i])) {
+            return value_create_exception("معاملات الخيط لا تكون قيماً مشتركة بالمرجع", 4);
+        }
+    }
+    
+    Value promise = value_create_promise();
+    Completion *completion = event_loop_expect(&promise);
+    if (!completion) {
+        value_free(&promise);
+        return value_create_exception("تعذر إنشاء حلقة الأحداث", 15);
+    }
+    
+    ThreadJob *job = malloc(sizeof(ThreadJob));
+    job->interp = interpreter_create_isolated(parent);
+    job->func = args[0];
+    job->arg_count = arg_count - 1;
+    job->args = malloc(sizeof(Value) * (job->arg_count ? job->arg_count : 1));
+    for (int i = 0; i < job->arg_count; i++) {
+        job->args[i] = args[i + 1];
+        args[i + 1] = value_create_null();
+    }
+    job->completion = completion;
+    
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, isolated_thread, job) != 0) {
+        for (int i = 0; i < job->arg_count; i++) {
+            value_free(&job->args[i]);
+        }
+        free(job->args);
+        interpreter_destroy(job->interp);
+        free(job);
+        event_loop_complete(completion, value_create_exception("تعذر إنشاء الخيط", 15));
+        return promise;
+    }
+    pthread_detach(thread);
+    return promise;
+}
+
+// جمد(قيمة): نسخة لا تتغير تتشاركها الخيوط والقنوات بالمرجع، وكل تعديل فيها استثناء
+// (بيانات مرجعية كبيرة تجمد مرة ثم تقرأ من كل خيط دون نسخ)
+Value lib_parallel_freeze(Value *args, int arg_count) {
+    if (arg_count < 1) {
+        return value_create_exception("جمد يتطلب قيمة", 4);
+    }
+    if (!value_is_sendable(&args[0])) {
+        return value_create_exception("لا تجمد قيمة فيها مراجع مشتركة قابلة للتعديل", 4);
+    }
+    Value value = args[0];
+    args[0] = value_create_null();
+    return value_freeze(value);
+}
+
+// مجمد(قيمة): هل القيمة حاوية مجمدة
+Value lib_parallel_is_frozen(Value *args, int arg_count) {
+    return value_create_boolean(arg_count >= 1 && args[0].type == VAL_FROZEN);
+}
+
+// حدد_العمال(عدد): عدد خيوط المجدول مع الخيط الرئيسي، قبل أول عملية متوازية
+Value lib_parallel_set_workers(Value *args, int arg_count) {
+    if (arg_count < 1 || !value_is_number(&args[0]) || value_as_number(&args[0]) < 1) {
+        return value_create_exception("حدد_العمال يتطلب عدداً موجباً", 4);
+    }
+    if (!parallel_set_worker_count((int)value_as_number(&args[0]))) {
+        return value_create_exception("المجدول يعمل: حدد عدد العمال قبل أول عملية متوازية", 15);
+    }
+    return value_create_null();
+}
@@ -0,0 +1,127 @@
+#include "wisam.h"
+#include <string.h>
+#include <stdlib.h>
+
+// إنشاء مجموعة، اختيارياً من عناصر مصفوفة (يحذف التكرار ويبقى ترتيب الظهور الأول)
+Value lib_set_create(Value *args, int arg_count) {
+    Value set = value_create_set();
+    if (arg_count < 1) {
+        return set;
+    }
+    
+    if (args[0].type == VAL_SET) {
+        value_free(&set);
+        return value_copy(&args[0]);
+    }
+    if (args[0].type != VAL_ARRAY) {
+        value_free(&set);
+        return value_create_exception("المجموعة تنشأ من مصفوفة", 4);
+    }
+    
+    for (int i = 0; i < args[0].as.array.count; i++) {
+        Value *item = args[0].as.array.items[i];
+        if (!value_is_hashable(item)) {
+            value_free(&set);
+            return value_create_exception("المفتاح غير قابل للتجزئة", 14);
+        }
+        set_add(&set, value_copy(item));
+    }
+    return set;
+}
+
+// إضافة عنصر، وتعيد صحيح إن لم يكن موجوداً
+Value lib_set_add(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET) {
+        return value_create_boolean(false);
+    }
+    if (!value_is_hashable(&args[1])) {
+        return value_create_exception("المفتاح غير قابل للتجزئة", 14);
+    }
+    return value_create_boolean(set_add(&args[0], value_copy(&args[1])));
+}
+
+// حذف عنصر
+Value lib_set_remove(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET || !value_is_hashable(&args[1])) {
+        return value_create_boolean(false);
+    }
+    return value_create_boolean(set_remove(&args[0], &args[1]));
+}
+
+// هل العنصر موجود؟
+Value lib_set_has(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET || !value_is_hashable(&args[1])) {
+        return value_create_boolean(false);
+    }
+    return value_create_boolean(set_has(&args[0], &args[1]));
+}
+
+// عدد العناصر
+Value lib_set_size(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_SET) {
+        return value_create_number(0);
+    }
+    return value_create_number(args[0].as.set->count);
+}
+
+// تحويل إلى مصفوفة بترتيب العناصر في المجموعة
+Value lib_set_to_array(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_SET) {
+        return value_create_null();
+    }
+    
+    Set *set = args[0].as.set;
+    Value result = value_create_array();
+    if (set->count > result.as.array.capacity) {
+        result.as.array.capacity = set->count;
+        result.as.array.items = realloc(result.as.array.items, sizeof(Value*) * set->count);
+    }
+    for (int i = 0; i < set->count; i++) {
+        Value *item = malloc(sizeof(Value));
+        *item = value_copy(&set->items[i]);
+        result.as.array.items[result.as.array.count++] = item;
+    }
+    return result;
+}
+
+// الاتحاد
+Value lib_set_union(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET || args[1].type != VAL_SET) {
+        return value_create_null();
+    }
+    return set_union(&args[0], &args[1]);
+}
+
+// التقاطع
+Value lib_set_intersection(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET || args[1].type != VAL_SET) {
+        return value_create_null();
+    }
+    return set_intersection(&args[0], &args[1]);
+}
+
+// الفرق
+Value lib_set_difference(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET || args[1].type != VAL_SET) {
+        return value_create_null();
+    }
+    return set_difference(&args[0], &args[1]);
+}
+
+// هل الأولى جزء من الثانية؟
+Value lib_set_is_subset(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_SET || args[1].type != VAL_SET) {
+        return value_create_boolean(false);
+    }
+    
+    Set *set = args[0].as.set;
+    if (set->count > args[1].as.set->count) {
+        return value_create_boolean(false);
+    }
+    for (int i = 0; i < set->count; i++) {
+        if (!set_has(&args[1], &set->items[i])) {
+            return value_create_boolean(false);
+        }
+    }
+    return value_create_boolean(true);
+}
@@ -14,24 +14,45 @@ typedef struct {
     bool encrypted;
 } Store;
 
-static Store stores[MAX_STORES];
-static int store_count = 0;
-static bool initialized = false;
+// حالة المكتبة لكل مفسر: المخازن التي فتحها برنامجه
+struct StoreState {
+    Store stores[MAX_STORES];
+    int store_count;
+    bool initialized;
+};
+
+static StoreState *store_state(void) {
+    LibraryContext *libs = library_context();
+    if (!libs->store) libs->store = calloc(1, sizeof(StoreState));
+    return libs->store;
+}
+
+void lib_store_state_free(StoreState *st) {
+    if (!st) return;
+    
+    for (int i = 0; i < st->store_count; i++) {
+        free(st->stores[i].name);
+        free(st->stores[i].filename);
+    }
+    free(st);
+}
 
 void lib_store_init(void) {
-    if (initialized) return;
+    StoreState *st = store_state();
+    if (st->initialized) return;
     
     // إنشاء مجلد التخزين
-    struct stat st = {0};
-    if (stat(STORE_DIR, &st) == -1) {
+    struct stat info = {0};
+    if (stat(STORE_DIR, &info) == -1) {
         mkdir(STORE_DIR, 0700);
     }
     
-    initialized = true;
+    st->initialized = true;
 }
 
 // إنشاء مخزن جديد
 Value lib_store_create(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: أنشئ يتطلب اسم المخزن\n");
         return value_create_null();
@@ -40,24 +61,24 @@ Value lib_store_create(Value *args, int arg_count) {
     char *name = args[0].as.string;
     
     // التحقق من عدم وجود المخزن مسبقاً
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, name) == 0) {
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, name) == 0) {
             fprintf(stderr, "خطأ: المخزن '%s' موجود مسبقاً\n", name);
             return value_create_null();
         }
     }
     
-    if (store_count >= MAX_STORES) {
+    if (st->store_count >= MAX_STORES) {
         fprintf(stderr, "خطأ: تجاوز الحد الأقصى للمخازن\n");
         return value_create_null();
     }
     
     // إنشاء المخزن
-    stores[store_count].name = strdup(name);
+    st->stores[st->store_count].name = strdup(name);
     char filename[512];
     snprintf(filename, sizeof(filename), "%s%s.wdb", STORE_DIR, name);
-    stores[store_count].filename = strdup(filename);
-    stores[store_count].encrypted = false;
+    st->stores[st->store_count].filename = strdup(filename);
+    st->stores[st->store_count].encrypted = false;
     
     // إنشاء الملف
     FILE *f = fopen(filename, "w");
@@ -66,13 +87,14 @@ Value lib_store_create(Value *args, int arg_count) {
         fclose(f);
     }
     
-    store_count++;
+    st->store_count++;
     
     return value_create_string(name);
 }
 
 // إضافة بيانات للمخزن
 Value lib_store_add(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 3 || args[0].type != VAL_STRING || 
         args[1].type != VAL_STRING || args[2].type != VAL_STRING) {
         fprintf(stderr, "خطأ: أضف يتطلب اسم المخزن والمفتاح والقيمة\n");
@@ -85,9 +107,9 @@ Value lib_store_add(Value *args, int arg_count) {
     
     // البحث عن المخزن
     char *filename = NULL;
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, store_name) == 0) {
-            filename = stores[i].filename;
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, store_name) == 0) {
+            filename = st->stores[i].filename;
             break;
         }
     }
@@ -133,6 +155,7 @@ Value lib_store_add(Value *args, int arg_count) {
 
 // قراءة بيانات من المخزن
 Value lib_store_read(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: اقرأ يتطلب اسم المخزن والمفتاح\n");
         return value_create_null();
@@ -143,9 +166,9 @@ Value lib_store_read(Value *args, int arg_count) {
     
     // البحث عن المخزن
     char *filename = NULL;
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, store_name) == 0) {
-            filename = stores[i].filename;
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, store_name) == 0) {
+            filename = st->stores[i].filename;
             break;
         }
     }
@@ -190,6 +213,7 @@ Value lib_store_read(Value *args, int arg_count) {
 
 // حذف بيانات من المخزن
 Value lib_store_delete(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 2 || args[0].type != VAL_STRING || args[1].type != VAL_STRING) {
         fprintf(stderr, "خطأ: احذف يتطلب اسم المخزن والمفتاح\n");
         return value_create_null();
@@ -200,9 +224,9 @@ Value lib_store_delete(Value *args, int arg_count) {
     
     // البحث عن المخزن
     char *filename = NULL;
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, store_name) == 0) {
-            filename = stores[i].filename;
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, store_name) == 0) {
+            filename = st->stores[i].filename;
             break;
         }
     }
@@ -254,6 +278,7 @@ Value lib_store_delete(Value *args, int arg_count) {
 
 // قائمة جميع المفاتيح في المخزن
 Value lib_store_list(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: قائمة يتطلب اسم المخزن\n");
         return value_create_null();
@@ -263,9 +288,9 @@ Value lib_store_list(Value *args, int arg_count) {
     
     // البحث عن المخزن
     char *filename = NULL;
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, store_name) == 0) {
-            filename = stores[i].filename;
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, store_name) == 0) {
+            filename = st->stores[i].filename;
             break;
         }
     }
@@ -309,6 +334,7 @@ Value lib_store_list(Value *args, int arg_count) {
 
 // مسح المخزن
 Value lib_store_clear(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: امسح يتطلب اسم المخزن\n");
         return value_create_null();
@@ -318,9 +344,9 @@ Value lib_store_clear(Value *args, int arg_count) {
     
     // البحث عن المخزن
     char *filename = NULL;
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, store_name) == 0) {
-            filename = stores[i].filename;
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, store_name) == 0) {
+            filename = st->stores[i].filename;
             break;
         }
     }
@@ -343,6 +369,7 @@ Value lib_store_clear(Value *args, int arg_count) {
 
 // حذف المخزن
 Value lib_store_remove(Value *args, int arg_count) {
+    StoreState *st = store_state();
     if (arg_count < 1 || args[0].type != VAL_STRING) {
         fprintf(stderr, "خطأ: أزل يتطلب اسم المخزن\n");
         return value_create_null();
@@ -352,8 +379,8 @@ Value lib_store_remove(Value *args, int arg_count) {
     
     // البحث عن المخزن
     int idx = -1;
-    for (int i = 0; i < store_count; i++) {
-        if (strcmp(stores[i].name, store_name) == 0) {
+    for (int i = 0; i < st->store_count; i++) {
+        if (strcmp(st->stores[i].name, store_name) == 0) {
             idx = i;
             break;
         }
@@ -365,17 +392,17 @@ Value lib_store_remove(Value *args, int arg_count) {
     }
     
     // حذف الملف
-    remove(stores[idx].filename);
+    remove(st->stores[idx].filename);
     
     // تحرير الذاكرة
-    free(stores[idx].name);
-    free(stores[idx].filename);
+    free(st->stores[idx].name);
+    free(st->stores[idx].filename);
     
     // إزالة من القائمة
-    for (int i = idx; i < store_count - 1; i++) {
-        stores[i] = stores[i + 1];
+    for (int i = idx; i < st->store_count - 1; i++) {
+        st->stores[i] = st->stores[i + 1];
     }
-    store_count--;
+    st->store_count--;
     
     return value_create_boolean(true);
 }
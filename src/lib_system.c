@@ -176,32 +176,33 @@ Value lib_system_exec(Value *args, int arg_count) {
     return value_create_boolean(false);
 }
 
+// عدد المعالجات المتاحة (حجم المجمع المتوازي الافتراضي)
+Value lib_system_cpu_count(Value *args, int arg_count) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return value_create_number(count > 0 ? count : 1);
+}
+
 // معلومات النظام
 Value lib_system_info(Value *args, int arg_count) {
     Value result = value_create_object();
     
-    result.as.object.keys[0] = strdup("نظام_التشغيل");
-    result.as.object.values[0] = malloc(sizeof(Value));
     #ifdef __linux__
-    *result.as.object.values[0] = value_create_string("Linux");
+    object_set(&result, "نظام_التشغيل", value_create_string("Linux"));
     #elif __APPLE__
-    *result.as.object.values[0] = value_create_string("macOS");
+    object_set(&result, "نظام_التشغيل", value_create_string("macOS"));
     #else
-    *result.as.object.values[0] = value_create_string("Unknown");
+    object_set(&result, "نظام_التشغيل", value_create_string("Unknown"));
     #endif
     
-    result.as.object.keys[1] = strdup("المعمارية");
-    result.as.object.values[1] = malloc(sizeof(Value));
     #if __x86_64__
-    *result.as.object.values[1] = value_create_string("x86_64");
+    object_set(&result, "المعمارية", value_create_string("x86_64"));
     #elif __i386__
-    *result.as.object.values[1] = value_create_string("x86");
+    object_set(&result, "المعمارية", value_create_string("x86"));
     #elif __arm__
-    *result.as.object.values[1] = value_create_string("ARM");
+    object_set(&result, "المعمارية", value_create_string("ARM"));
     #else
-    *result.as.object.values[1] = value_create_string("Unknown");
+    object_set(&result, "المعمارية", value_create_string("Unknown"));
     #endif
     
-    result.as.object.count = 2;
     return result;
 }
@@ -3,6 +3,16 @@
 #include <string.h>
 #include <stdlib.h>
 
+// تحويل موضع بالبايت إلى موضع بالمحارف
+static int char_index_at(const char *str, size_t byte_offset) {
+    if (string_char_count(str) == (int)string_length(str)) return (int)byte_offset;
+    int index = 0;
+    for (size_t i = 0; i < byte_offset; i++) {
+        if (((unsigned char)str[i] & 0xC0) != 0x80) index++;
+    }
+    return index;
+}
+
 // تحويل النص إلى حروف كبيرة
 Value lib_text_upper(Value *args, int arg_count) {
     if (arg_count < 1 || args[0].type != VAL_STRING) {
@@ -10,18 +20,18 @@ Value lib_text_upper(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    char *str = strdup(args[0].as.string);
-    for (int i = 0; str[i]; i++) {
+    char *str = string_copy(args[0].as.string);
+    size_t len = string_length(str);
+    for (size_t i = 0; i < len; i++) {
         // تحويل الحروف الإنجليزية الصغيرة إلى كبيرة
         if (str[i] >= 'a' && str[i] <= 'z') {
             str[i] = str[i] - 'a' + 'A';
         }
         // ملاحظة: الحروف العربية لا يوجد لها حالة كبيرة/صغيرة
     }
+    string_header(str)->has_hash = false;
     
-    Value result = value_create_string(str);
-    free(str);
-    return result;
+    return value_wrap_string(str);
 }
 
 // تحويل النص إلى حروف صغيرة
@@ -31,17 +41,17 @@ Value lib_text_lower(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    char *str = strdup(args[0].as.string);
-    for (int i = 0; str[i]; i++) {
+    char *str = string_copy(args[0].as.string);
+    size_t len = string_length(str);
+    for (size_t i = 0; i < len; i++) {
         // تحويل الحروف الإنجليزية الكبيرة إلى صغيرة
         if (str[i] >= 'A' && str[i] <= 'Z') {
             str[i] = str[i] - 'A' + 'a';
         }
     }
+    string_header(str)->has_hash = false;
     
-    Value result = value_create_string(str);
-    free(str);
-    return result;
+    return value_wrap_string(str);
 }
 
 // الحصول على طول النص
@@ -51,7 +61,7 @@ Value lib_text_length(Value *args, int arg_count) {
         return value_create_null();
     }
     
-    return value_create_number(strlen(args[0].as.string));
+    return value_create_number(string_char_count(args[0].as.string));
 }
 
 // استخراج جزء من النص
@@ -65,24 +75,20 @@ Value lib_text_substring(Value *args, int arg_count) {
     const char *str = args[0].as.string;
     int start = (int)args[1].as.number;
     int length = (int)args[2].as.number;
-    int str_len = strlen(str);
+    int str_len = string_char_count(str);
     
     // تعديل البداية إذا كانت سالبة
     if (start < 0) start = 0;
-    if (start >= str_len) return value_create_string("");
+    if (start >= str_len || length <= 0) return value_create_string("");
     
     // تعديل الطول إذا تجاوز النص
     if (start + length > str_len) {
         length = str_len - start;
     }
     
-    char *result = malloc(length + 1);
-    strncpy(result, str + start, length);
-    result[length] = '\0';
-    
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    size_t from = string_char_offset(str, start);
+    size_t to = string_char_offset(str, start + length);
+    return value_create_string_len(str + from, to - from);
 }
 
 // استبدال نص بآخر
@@ -105,14 +111,14 @@ Value lib_text_replace(Value *args, int arg_count) {
         tmp++;
     }
     
-    if (count == 0) return value_create_string(str);
+    if (count == 0) return value_wrap_string(string_copy(str));
     
     // حساب الطول الجديد
-    int old_len = strlen(old_str);
-    int new_len = strlen(new_str);
-    int result_len = strlen(str) + count * (new_len - old_len);
+    int old_len = string_length(old_str);
+    int new_len = string_length(new_str);
+    int result_len = string_length(str) + count * (new_len - old_len);
     
-    char *result = malloc(result_len + 1);
+    char *result = string_new(NULL, result_len);
     char *dst = result;
     const char *src = str;
     
@@ -127,9 +133,7 @@ Value lib_text_replace(Value *args, int arg_count) {
     
     strcpy(dst, src);
     
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    return value_wrap_string(result);
 }
 
 // تقسيم النص
@@ -144,26 +148,42 @@ Value lib_text_split(Value *args, int arg_count) {
     
     Value result = value_create_array();
     
-    if (strlen(delimiter) == 0) {
-        // تقسيم إلى حروف
-        for (int i = 0; str[i]; i++) {
-            char ch[2] = {str[i], '\0'};
+    if (string_length(delimiter) == 0) {
+        // تقسيم إلى حروف (محارف UTF-8 كاملة)
+        int char_count = string_char_count(str);
+        if (char_count > result.as.array.capacity) {
+            result.as.array.capacity = char_count;
+            result.as.array.items = realloc(result.as.array.items, 
+                                             sizeof(Value*) * result.as.array.capacity);
+        }
+        size_t start = 0;
+        size_t len = string_length(str);
+        while (start < len) {
+            size_t end = start + 1;
+            while (end < len && ((unsigned char)str[end] & 0xC0) == 0x80) end++;
             result.as.array.items[result.as.array.count] = malloc(sizeof(Value));
-            *result.as.array.items[result.as.array.count] = value_create_string(ch);
+            *result.as.array.items[result.as.array.count] = value_create_string_len(str + start, end - start);
             result.as.array.count++;
+            start = end;
         }
         return result;
     }
     
     // تقسيم بالفاصل
     char *str_copy = strdup(str);
-    char *token = strtok(str_copy, delimiter);
+    char *saveptr;
+    char *token = strtok_r(str_copy, delimiter, &saveptr);
     
     while (token != NULL) {
+        if (result.as.array.count >= result.as.array.capacity) {
+            result.as.array.capacity *= 2;
+            result.as.array.items = realloc(result.as.array.items, 
+                                             sizeof(Value*) * result.as.array.capacity);
+        }
         result.as.array.items[result.as.array.count] = malloc(sizeof(Value));
         *result.as.array.items[result.as.array.count] = value_create_string(token);
         result.as.array.count++;
-        token = strtok(NULL, delimiter);
+        token = strtok_r(NULL, delimiter, &saveptr);
     }
     
     free(str_copy);
@@ -179,7 +199,7 @@ Value lib_text_trim(Value *args, int arg_count) {
     
     const char *str = args[0].as.string;
     int start = 0;
-    int end = strlen(str) - 1;
+    int end = string_length(str) - 1;
     
     // إزالة من البداية
     while (start <= end && isspace((unsigned char)str[start])) start++;
@@ -189,14 +209,7 @@ Value lib_text_trim(Value *args, int arg_count) {
     
     if (start > end) return value_create_string("");
     
-    int len = end - start + 1;
-    char *result = malloc(len + 1);
-    strncpy(result, str + start, len);
-    result[len] = '\0';
-    
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    return value_create_string_len(str + start, end - start + 1);
 }
 
 // ترجمة النص (محاكاة)
@@ -237,7 +250,10 @@ Value lib_text_starts_with(Value *args, int arg_count) {
     const char *str = args[0].as.string;
     const char *prefix = args[1].as.string;
     
-    return value_create_boolean(strncmp(str, prefix, strlen(prefix)) == 0);
+    size_t prefix_len = string_length(prefix);
+    if (prefix_len > string_length(str)) return value_create_boolean(false);
+    
+    return value_create_boolean(memcmp(str, prefix, prefix_len) == 0);
 }
 
 // التحقق من نهاية النص
@@ -250,12 +266,12 @@ Value lib_text_ends_with(Value *args, int arg_count) {
     const char *str = args[0].as.string;
     const char *suffix = args[1].as.string;
     
-    int str_len = strlen(str);
-    int suffix_len = strlen(suffix);
+    size_t str_len = string_length(str);
+    size_t suffix_len = string_length(suffix);
     
     if (suffix_len > str_len) return value_create_boolean(false);
     
-    return value_create_boolean(strcmp(str + str_len - suffix_len, suffix) == 0);
+    return value_create_boolean(memcmp(str + str_len - suffix_len, suffix, suffix_len) == 0);
 }
 
 // التحقق من وجود نص داخل نص
@@ -284,7 +300,7 @@ Value lib_text_index_of(Value *args, int arg_count) {
     const char *found = strstr(str, substring);
     if (found == NULL) return value_create_number(-1);
     
-    return value_create_number(found - str);
+    return value_create_number(char_index_at(str, found - str));
 }
 
 // البحث عن آخر موضع
@@ -307,7 +323,7 @@ Value lib_text_last_index_of(Value *args, int arg_count) {
     
     if (last_found == NULL) return value_create_number(-1);
     
-    return value_create_number(last_found - str);
+    return value_create_number(char_index_at(str, last_found - str));
 }
 
 // تكرار النص
@@ -322,18 +338,15 @@ Value lib_text_repeat(Value *args, int arg_count) {
     
     if (count <= 0) return value_create_string("");
     
-    int len = strlen(str);
+    int len = string_length(str);
     int result_len = len * count;
-    char *result = malloc(result_len + 1);
+    char *result = string_new(NULL, result_len);
     
     for (int i = 0; i < count; i++) {
         memcpy(result + i * len, str, len);
     }
-    result[result_len] = '\0';
     
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    return value_wrap_string(result);
 }
 
 // إضافة حشو من البداية
@@ -348,14 +361,14 @@ Value lib_text_pad_start(Value *args, int arg_count) {
     const char *pad_string = (arg_count >= 3 && args[2].type == VAL_STRING) ? 
                               args[2].as.string : " ";
     
-    int str_len = strlen(str);
-    if (str_len >= target_length) return value_create_string(str);
+    int str_len = string_length(str);
+    if (str_len >= target_length) return value_wrap_string(string_copy(str));
     
     int pad_len = strlen(pad_string);
     int total_pad = target_length - str_len;
     int result_len = target_length;
     
-    char *result = malloc(result_len + 1);
+    char *result = string_new(NULL, result_len);
     
     // إضافة الحشو
     for (int i = 0; i < total_pad; i++) {
@@ -363,11 +376,9 @@ Value lib_text_pad_start(Value *args, int arg_count) {
     }
     
     // إضافة النص الأصلي
-    strcpy(result + total_pad, str);
+    memcpy(result + total_pad, str, str_len);
     
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    return value_wrap_string(result);
 }
 
 // إضافة حشو من النهاية
@@ -382,27 +393,24 @@ Value lib_text_pad_end(Value *args, int arg_count) {
     const char *pad_string = (arg_count >= 3 && args[2].type == VAL_STRING) ? 
                               args[2].as.string : " ";
     
-    int str_len = strlen(str);
-    if (str_len >= target_length) return value_create_string(str);
+    int str_len = string_length(str);
+    if (str_len >= target_length) return value_wrap_string(string_copy(str));
     
     int pad_len = strlen(pad_string);
     int total_pad = target_length - str_len;
     int result_len = target_length;
     
-    char *result = malloc(result_len + 1);
+    char *result = string_new(NULL, result_len);
     
     // إضافة النص الأصلي
-    strcpy(result, str);
+    memcpy(result, str, str_len);
     
     // إضافة الحشو
     for (int i = 0; i < total_pad; i++) {
         result[str_len + i] = pad_string[i % pad_len];
     }
-    result[result_len] = '\0';
     
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    return value_wrap_string(result);
 }
 
 // عكس النص
@@ -413,17 +421,19 @@ Value lib_text_reverse(Value *args, int arg_count) {
     }
     
     const char *str = args[0].as.string;
-    int len = strlen(str);
+    int len = string_length(str);
     
-    char *result = malloc(len + 1);
-    for (int i = 0; i < len; i++) {
-        result[i] = str[len - 1 - i];
+    // عكس المحارف مع الحفاظ على ترتيب بايتات كل محرف UTF-8
+    char *result = string_new(NULL, len);
+    int start = 0;
+    while (start < len) {
+        int end = start + 1;
+        while (end < len && ((unsigned char)str[end] & 0xC0) == 0x80) end++;
+        memcpy(result + len - end, str + start, end - start);
+        start = end;
     }
-    result[len] = '\0';
     
-    Value val = value_create_string(result);
-    free(result);
-    return val;
+    return value_wrap_string(result);
 }
 
 // تنسيق النص (محاكاة printf)
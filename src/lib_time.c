@@ -5,10 +5,27 @@
 #include <stdlib.h>
 #include <unistd.h>
 
+// حالة المكتبة لكل مفسر: المؤقت وعلامات قياس الوقت
+struct TimeState {
+    time_t start_time;
+    time_t markers[10];
+};
+
+static TimeState *time_state(void) {
+    LibraryContext *libs = library_context();
+    if (!libs->time) libs->time = calloc(1, sizeof(TimeState));
+    return libs->time;
+}
+
+void lib_time_state_free(TimeState *state) {
+    free(state);
+}
+
 // الحصول على الوقت الحالي
 Value lib_time_now(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     
     char buffer[26];
     strftime(buffer, 26, "%Y-%m-%d %H:%M:%S", tm_info);
@@ -24,7 +41,8 @@ Value lib_time_format(Value *args, int arg_count) {
     }
     
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     
     char buffer[256];
     char *format = args[0].as.string;
@@ -69,49 +87,56 @@ Value lib_time_sleep(Value *args, int arg_count) {
 // الحصول على السنة
 Value lib_time_year(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     return value_create_number(tm_info->tm_year + 1900);
 }
 
 // الحصول على الشهر
 Value lib_time_month(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     return value_create_number(tm_info->tm_mon + 1);
 }
 
 // الحصول على اليوم
 Value lib_time_day(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     return value_create_number(tm_info->tm_mday);
 }
 
 // الحصول على الساعة
 Value lib_time_hour(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     return value_create_number(tm_info->tm_hour);
 }
 
 // الحصول على الدقيقة
 Value lib_time_minute(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     return value_create_number(tm_info->tm_min);
 }
 
 // الحصول على الثانية
 Value lib_time_second(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     return value_create_number(tm_info->tm_sec);
 }
 
 // الحصول على اليوم من الأسبوع
 Value lib_time_weekday(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     
     char *days[] = {"الأحد", "الإثنين", "الثلاثاء", "الأربعاء", 
                     "الخميس", "الجمعة", "السبت"};
@@ -122,7 +147,8 @@ Value lib_time_weekday(Value *args, int arg_count) {
 // الحصول على اسم الشهر
 Value lib_time_month_name(Value *args, int arg_count) {
     time_t now = time(NULL);
-    struct tm *tm_info = localtime(&now);
+    struct tm tm_buffer;
+    struct tm *tm_info = localtime_r(&now, &tm_buffer);
     
     char *months[] = {"يناير", "فبراير", "مارس", "إبريل", "مايو", "يونيو",
                       "يوليو", "أغسطس", "سبتمبر", "أكتوبر", "نوفمبر", "ديسمبر"};
@@ -132,27 +158,27 @@ Value lib_time_month_name(Value *args, int arg_count) {
 
 // إنشاء مؤقت
 Value lib_time_timer(Value *args, int arg_count) {
-    static time_t start_time = 0;
+    TimeState *state = time_state();
     
     if (arg_count >= 1 && args[0].type == VAL_STRING) {
         if (strcmp(args[0].as.string, "ابدأ") == 0 || 
             strcmp(args[0].as.string, "start") == 0) {
-            start_time = time(NULL);
+            state->start_time = time(NULL);
             return value_create_boolean(true);
         } else if (strcmp(args[0].as.string, "توقف") == 0 || 
                    strcmp(args[0].as.string, "stop") == 0) {
-            if (start_time == 0) {
+            if (state->start_time == 0) {
                 return value_create_number(0);
             }
-            double elapsed = difftime(time(NULL), start_time);
-            start_time = 0;
+            double elapsed = difftime(time(NULL), state->start_time);
+            state->start_time = 0;
             return value_create_number(elapsed);
         } else if (strcmp(args[0].as.string, "اقرأ") == 0 || 
                    strcmp(args[0].as.string, "read") == 0) {
-            if (start_time == 0) {
+            if (state->start_time == 0) {
                 return value_create_number(0);
             }
-            return value_create_number(difftime(time(NULL), start_time));
+            return value_create_number(difftime(time(NULL), state->start_time));
         }
     }
     
@@ -161,7 +187,7 @@ Value lib_time_timer(Value *args, int arg_count) {
 
 // قياس الوقت المنقضي
 Value lib_time_elapsed(Value *args, int arg_count) {
-    static time_t markers[10] = {0};
+    TimeState *state = time_state();
     
     if (arg_count >= 1 && args[0].type == VAL_NUMBER) {
         int marker_id = (int)args[0].as.number;
@@ -172,16 +198,16 @@ Value lib_time_elapsed(Value *args, int arg_count) {
         if (arg_count >= 2 && args[1].type == VAL_STRING) {
             if (strcmp(args[1].as.string, "ضع") == 0 || 
                 strcmp(args[1].as.string, "set") == 0) {
-                markers[marker_id] = time(NULL);
+                state->markers[marker_id] = time(NULL);
                 return value_create_boolean(true);
             }
         }
         
-        if (markers[marker_id] == 0) {
+        if (state->markers[marker_id] == 0) {
             return value_create_number(0);
         }
         
-        return value_create_number(difftime(time(NULL), markers[marker_id]));
+        return value_create_number(difftime(time(NULL), state->markers[marker_id]));
     }
     
     return value_create_null();
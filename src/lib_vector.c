@@ -0,0 +1,87 @@
+#include "wisam.h"
+#include <string.h>
+#include <stdlib.h>
+
+// إنشاء متجه دائم، اختيارياً من عناصر مصفوفة
+Value lib_vector_create(Value *args, int arg_count) {
+    if (arg_count >= 1 && args[0].type == VAL_VECTOR) {
+        return value_copy(&args[0]);
+    }
+    
+    Value vector = value_create_vector();
+    if (arg_count < 1) {
+        return vector;
+    }
+    if (args[0].type != VAL_ARRAY) {
+        value_free(&vector);
+        return value_create_exception("المتجه ينشأ من مصفوفة", 4);
+    }
+    
+    for (int i = 0; i < args[0].as.array.count; i++) {
+        vector_push(&vector, value_copy(args[0].as.array.items[i]));
+    }
+    return vector;
+}
+
+// الحصول على عنصر
+Value lib_vector_get(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_VECTOR || args[1].type != VAL_NUMBER) {
+        return value_create_null();
+    }
+    
+    Value *item = vector_get(&args[0], (int)args[1].as.number);
+    return item ? value_copy(item) : value_create_null();
+}
+
+// نسخة معدلة بعنصر واحد: تشارك الأصل كل شيء عدا مسار العنصر
+Value lib_vector_set(Value *args, int arg_count) {
+    if (arg_count < 3 || args[0].type != VAL_VECTOR || args[1].type != VAL_NUMBER) {
+        return value_create_null();
+    }
+    
+    int index = (int)args[1].as.number;
+    if (index < 0 || index >= args[0].as.vector.count) {
+        return value_create_exception("فهرس خارج النطاق", 3);
+    }
+    
+    Value result = value_copy(&args[0]);
+    Value *slot = vector_slot(&result, index);
+    value_free(slot);
+    *slot = value_copy(&args[2]);
+    return result;
+}
+
+// نسخة بعنصر مضاف في النهاية
+Value lib_vector_push(Value *args, int arg_count) {
+    if (arg_count < 2 || args[0].type != VAL_VECTOR) {
+        return value_create_null();
+    }
+    
+    Value result = value_copy(&args[0]);
+    vector_push(&result, value_copy(&args[1]));
+    return result;
+}
+
+// عدد العناصر
+Value lib_vector_size(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_VECTOR) {
+        return value_create_number(0);
+    }
+    return value_create_number(args[0].as.vector.count);
+}
+
+// تحويل إلى مصفوفة عادية
+Value lib_vector_to_array(Value *args, int arg_count) {
+    if (arg_count < 1 || args[0].type != VAL_VECTOR) {
+        return value_create_null();
+    }
+    
+    Value result = value_create_array();
+    array_reserve(&result, args[0].as.vector.count);
+    for (int i = 0; i < args[0].as.vector.count; i++) {
+        Value *item = malloc(sizeof(Value));
+        *item = value_copy(vector_get(&args[0], i));
+        array_append(&result, item);
+    }
+    return result;
+}
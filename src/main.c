@@ -81,7 +81,7 @@ void print_tokens(Token *tokens, int count) {
         "دالة", "أعد", "هيكل", "صنف", "استورد", "أنشئ", "باسم", "طالما",
         "توقف", "استمر", "و", "أو", "ليس", "في", "من", "حاول", "امسك",
         "أخيراً", "ألقِ", "حسب", "حالة", "افتراضي", "نفذ", "حتى", "لكل_عنصر",
-        "أنتج", "غير_متزامن", "انتظر", "عام", "خاص", "محمي", "ثابت_الصنف",
+        "لكل_متوازي", "أنتج", "غير_متزامن", "انتظر", "عام", "خاص", "محمي", "ثابت_الصنف",
         "يرث", "ينفذ", "جديد", "هذا", "أب", "فارغ", "صحيح", "خطأ",
         "رقم", "نص", "منطقي", "مصفوفة", "كائن", "معرف", "=", "+", "-",
         "*", "/", "%", "^", "==", "!=", ">", "<", ">=", "<=", "(", ")",
@@ -136,7 +136,8 @@ void print_ast(ASTNode *node, int indent) {
             }
             break;
         case AST_FOR:
-            printf("🔁 لكل: %s\n", node->as.for_loop.var_name);
+            printf("🔁 %s: %s\n", node->as.for_loop.is_parallel ? "لكل_متوازي" : "لكل",
+                   node->as.for_loop.var_name);
             print_ast(node->as.for_loop.start, indent + 1);
             print_ast(node->as.for_loop.end, indent + 1);
             print_ast(node->as.for_loop.body, indent + 1);
@@ -158,6 +159,10 @@ void print_ast(ASTNode *node, int indent) {
                 print_ast(node->as.function_call.args[i], indent + 1);
             }
             break;
+        case AST_AWAIT:
+            printf("⏳ انتظر\n");
+            print_ast(node->as.await_stmt.promise, indent + 1);
+            break;
         case AST_RETURN:
             printf("⬅️ أعد\n");
             if (node->as.return_stmt.value) {
@@ -201,6 +206,73 @@ void print_ast(ASTNode *node, int indent) {
             print_ast(node->as.array_access.array, indent + 1);
             print_ast(node->as.array_access.index, indent + 1);
             break;
+        case AST_PROPERTY_ACCESS:
+            printf("🔑 وصول للخاصية: %s\n", node->as.property_access.property);
+            print_ast(node->as.property_access.object, indent + 1);
+            break;
+        case AST_OBJECT:
+            printf("🗂️ كائن (%d مفتاح)\n", node->as.object.count);
+            for (int i = 0; i < node->as.object.count; i++) {
+                print_ast(node->as.object.values[i], indent + 1);
+            }
+            break;
+        case AST_MAP:
+            printf("🗺️ خريطة (%d مفتاح)\n", node->as.map.count);
+            for (int i = 0; i < node->as.map.count; i++) {
+                print_ast(node->as.map.keys[i], indent + 1);
+                print_ast(node->as.map.values[i], indent + 1);
+            }
+            break;
+        case AST_INDEX_ASSIGN:
+        case AST_PROPERTY_ASSIGN:
+            printf("📝 تعيين في المكان\n");
+            print_ast(node->as.place_assign.target, indent + 1);
+            print_ast(node->as.place_assign.value, indent + 1);
+            break;
+        case AST_STRUCT_DEF:
+            printf("🧱 تعريف هيكل: %s (%d حقل)\n", node->as.struct_def.name,
+                   node->as.struct_def.field_count);
+            break;
+        case AST_STRUCT_CREATE:
+            printf("🧱 إنشاء هيكل: %s\n", node->as.struct_create.struct_name);
+            for (int i = 0; i < node->as.struct_create.layout->shape->count; i++) {
+                if (node->as.struct_create.values[i]) {
+                    print_ast(node->as.struct_create.values[i], indent + 1);
+                }
+            }
+            break;
+        case AST_CLASS_DEF:
+            printf("🏛️ تعريف صنف: %s (%d دالة)\n", node->as.class_def.name,
+                   node->as.class_def.method_count);
+            for (int i = 0; i < node->as.class_def.method_count; i++) {
+                print_ast(node->as.class_def.methods[i], indent + 1);
+            }
+            break;
+        case AST_NEW:
+            printf("✨ نسخة جديدة: %s\n", node->as.new_stmt.class_name);
+            for (int i = 0; i < node->as.new_stmt.arg_count; i++) {
+                print_ast(node->as.new_stmt.args[i], indent + 1);
+            }
+            break;
+        case AST_THIS:
+            printf("👤 هذا\n");
+            break;
+        case AST_METHOD_CALL:
+            printf("📞 استدعاء دالة الصنف: %s\n", node->as.method_call.method_name);
+            print_ast(node->as.method_call.object, indent + 1);
+            for (int i = 0; i < node->as.method_call.arg_count; i++) {
+                print_ast(node->as.method_call.args[i], indent + 1);
+            }
+            break;
+        case AST_SWITCH:
+            printf("🔀 حسب (%d حالة%s)\n", node->as.switch_stmt.case_count,
+                   node->as.switch_stmt.jump_table ? "، جدول قفز" :
+                   node->as.switch_stmt.label_table ? "، جدول تجزئة" : "");
+            print_ast(node->as.switch_stmt.expression, indent + 1);
+            for (int i = 0; i < node->as.switch_stmt.case_count; i++) {
+                print_ast(node->as.switch_stmt.cases[i]->as.case_stmt.value, indent + 1);
+            }
+            break;
         case AST_BREAK:
             printf("⏹️ توقف\n");
             break;
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 
 // إنشاء البارسر
 Parser *parser_create(Token *tokens, int token_count) {
@@ -14,6 +15,13 @@ Parser *parser_create(Token *tokens, int token_count) {
     parser->error_message = NULL;
     parser->error_line = 0;
     parser->error_column = 0;
+    parser->structs = NULL;
+    parser->struct_count = 0;
+    parser->struct_capacity = 0;
+    parser->functions = NULL;
+    parser->function_count = 0;
+    parser->function_capacity = 0;
+    parser->saw_yield = false;
     
     return parser;
 }
@@ -22,6 +30,15 @@ Parser *parser_create(Token *tokens, int token_count) {
 void parser_destroy(Parser *parser) {
     if (parser) {
         free(parser->error_message);
+        // الاسم يملكه عقدة التعريف في الشجرة، والأشكال مشتركة لا تحرر
+        for (int i = 0; i < parser->struct_count; i++) {
+            free(parser->structs[i]);
+        }
+        free(parser->structs);
+        for (int i = 0; i < parser->function_count; i++) {
+            free(parser->functions[i]);
+        }
+        free(parser->functions);
         free(parser);
     }
 }
@@ -116,8 +133,11 @@ static ASTNode *parse_primary(Parser *parser);
 static ASTNode *parse_unary(Parser *parser);
 static ASTNode *parse_multiplicative(Parser *parser);
 static ASTNode *parse_additive(Parser *parser);
+static ASTNode *parse_shift(Parser *parser);
 static ASTNode *parse_comparison(Parser *parser);
 static ASTNode *parse_equality(Parser *parser);
+static ASTNode *parse_bitwise_and(Parser *parser);
+static ASTNode *parse_bitwise_or(Parser *parser);
 static ASTNode *parse_logical_and(Parser *parser);
 static ASTNode *parse_logical_or(Parser *parser);
 
@@ -233,6 +253,37 @@ static ASTNode *parse_if(Parser *parser) {
     return node;
 }
 
+// تحليل بقية حلقة لكل_عنصر بعد اسم المتغير: في مجموعة ... انتهى
+// المجموعة تسحب عناصرها واحداً واحداً (مصفوفة، متجه، مجموعة، خريطة، نص، مولد)
+static ASTNode *parse_foreach_body(Parser *parser, Token var) {
+    ASTNode *node = create_node(AST_FOREACH);
+    node->line = var.line;
+    node->column = var.column;
+    node->as.for_each.var_name = strdup(var.value);
+    
+    parser_consume(parser, TOKEN_IN, "متوقع 'في' بعد اسم المتغير");
+    node->as.for_each.collection = parse_expression(parser);
+    skip_newlines(parser);
+    
+    ASTNode **body_stmts = malloc(sizeof(ASTNode*) * 100);
+    int body_count = 0;
+    
+    while (!parser_check(parser, TOKEN_END) && !parser_check(parser, TOKEN_EOF)) {
+        skip_newlines(parser);
+        if (parser_check(parser, TOKEN_END)) break;
+        body_stmts[body_count++] = parse_statement(parser);
+        skip_newlines(parser);
+    }
+    
+    ASTNode *body_node = create_node(AST_PROGRAM);
+    body_node->as.program.statements = body_stmts;
+    body_node->as.program.count = body_count;
+    node->as.for_each.body = body_node;
+    
+    parser_consume(parser, TOKEN_END, "متوقع 'انتهى' في نهاية حلقة 'لكل_عنصر'");
+    return node;
+}
+
 // تحليل حلقة لكل
 static ASTNode *parse_for(Parser *parser) {
     ASTNode *node = create_node(AST_FOR);
@@ -240,6 +291,13 @@ static ASTNode *parse_for(Parser *parser) {
     node->column = parser->tokens[parser->position].column;
     
     Token var = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم المتغير بعد 'لكل'");
+    
+    // لكل عنصر في مجموعة
+    if (parser_check(parser, TOKEN_IN)) {
+        free(node);
+        return parse_foreach_body(parser, var);
+    }
+    
     node->as.for_loop.var_name = strdup(var.value);
     
     parser_consume(parser, TOKEN_FROM, "متوقع 'من' بعد اسم المتغير");
@@ -278,6 +336,142 @@ static ASTNode *parse_for(Parser *parser) {
     return node;
 }
 
+// جمع أوامر حالة حتى الحالة التالية أو 'افتراضي' أو 'انتهى'
+static ASTNode **parse_case_body(Parser *parser, int *count) {
+    int capacity = 8;
+    ASTNode **statements = malloc(sizeof(ASTNode*) * capacity);
+    *count = 0;
+    
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_CASE) && !parser_check(parser, TOKEN_DEFAULT) &&
+           !parser_check(parser, TOKEN_END) && !parser_check(parser, TOKEN_EOF)) {
+        if (*count >= capacity) {
+            capacity *= 2;
+            statements = realloc(statements, sizeof(ASTNode*) * capacity);
+        }
+        statements[(*count)++] = parse_statement(parser);
+        skip_newlines(parser);
+    }
+    return statements;
+}
+
+// بناء جداول الاختيار من التسميات الثابتة: جدول قفز كثيف للأعداد الصحيحة
+// المتقاربة، وجدول تجزئة لما سواها، وتبقى التسميات غير الثابتة للمقارنة التسلسلية
+static void compile_switch(ASTNode *node) {
+    int case_count = node->as.switch_stmt.case_count;
+    int int_count = 0;
+    int64_t min = 0, max = 0;
+    
+    node->as.switch_stmt.dynamic_cases = malloc(sizeof(int) * (case_count ? case_count : 1));
+    node->as.switch_stmt.dynamic_count = 0;
+    
+    for (int i = 0; i < case_count; i++) {
+        ASTNode *label = node->as.switch_stmt.cases[i]->as.case_stmt.value;
+        if (label->type == AST_LITERAL && label->as.literal.value.type == VAL_INT) {
+            int64_t value = label->as.literal.value.as.integer;
+            if (int_count == 0 || value < min) min = value;
+            if (int_count == 0 || value > max) max = value;
+            int_count++;
+        }
+    }
+    
+    // الجدول الكثيف حين لا يتجاوز المدى أربعة أضعاف عدد التسميات
+    uint64_t span = (uint64_t)max - (uint64_t)min;
+    bool dense = int_count > 0 && span < SWITCH_JUMP_TABLE_MAX && span < (uint64_t)int_count * 4;
+    if (dense) {
+        node->as.switch_stmt.jump_min = min;
+        node->as.switch_stmt.jump_size = (int)span + 1;
+        node->as.switch_stmt.jump_table = calloc(node->as.switch_stmt.jump_size, sizeof(int));
+    }
+    
+    int capacity = 8;
+    while (capacity < case_count * 2) capacity *= 2;
+    
+    for (int i = 0; i < case_count; i++) {
+        ASTNode *label = node->as.switch_stmt.cases[i]->as.case_stmt.value;
+        bool constant = label->type == AST_LITERAL &&
+                        (label->as.literal.value.type == VAL_INT ||
+                         label->as.literal.value.type == VAL_STRING);
+        if (!constant) {
+            node->as.switch_stmt.dynamic_cases[node->as.switch_stmt.dynamic_count++] = i;
+            continue;
+        }
+        
+        Value *value = &label->as.literal.value;
+        if (dense && value->type == VAL_INT) {
+            int *entry = &node->as.switch_stmt.jump_table[value->as.integer - min];
+            if (*entry == 0) *entry = i + 1;
+            continue;
+        }
+        
+        if (!node->as.switch_stmt.label_table) {
+            node->as.switch_stmt.label_capacity = capacity;
+            node->as.switch_stmt.label_table = calloc(capacity, sizeof(int));
+        }
+        unsigned int mask = (unsigned int)capacity - 1;
+        unsigned int slot = value_hash(value) & mask;
+        bool duplicate = false;
+        while (node->as.switch_stmt.label_table[slot] != 0) {
+            ASTNode *other = node->as.switch_stmt.cases[node->as.switch_stmt.label_table[slot] - 1];
+            if (value_equals(&other->as.case_stmt.value->as.literal.value, value)) {
+                // التسمية المكررة لا تصل إليها المطابقة أبداً
+                duplicate = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (!duplicate) node->as.switch_stmt.label_table[slot] = i + 1;
+    }
+}
+
+// تحليل جملة حسب: حسب تعبير ثم حالات 'حالة قيمة' و'افتراضي' حتى 'انتهى'
+// لا تنتقل حالة إلى التي تليها
+static ASTNode *parse_switch(Parser *parser) {
+    ASTNode *node = create_node(AST_SWITCH);
+    node->line = parser->tokens[parser->position].line;
+    node->column = parser->tokens[parser->position].column;
+    
+    node->as.switch_stmt.expression = parse_expression(parser);
+    node->as.switch_stmt.default_case = NULL;
+    
+    int capacity = 8;
+    node->as.switch_stmt.cases = malloc(sizeof(ASTNode*) * capacity);
+    node->as.switch_stmt.case_count = 0;
+    
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_END) && !parser_check(parser, TOKEN_EOF)) {
+        Token token = parser_peek(parser);
+        if (parser_match(parser, TOKEN_CASE)) {
+            ASTNode *case_node = create_node(AST_CASE);
+            case_node->line = token.line;
+            case_node->column = token.column;
+            case_node->as.case_stmt.value = parse_expression(parser);
+            parser_match(parser, TOKEN_COLON);
+            case_node->as.case_stmt.statements = parse_case_body(parser, &case_node->as.case_stmt.statement_count);
+            
+            if (node->as.switch_stmt.case_count >= capacity) {
+                capacity *= 2;
+                node->as.switch_stmt.cases = realloc(node->as.switch_stmt.cases, sizeof(ASTNode*) * capacity);
+            }
+            node->as.switch_stmt.cases[node->as.switch_stmt.case_count++] = case_node;
+        } else if (parser_match(parser, TOKEN_DEFAULT)) {
+            ASTNode *default_node = create_node(AST_DEFAULT);
+            default_node->line = token.line;
+            default_node->column = token.column;
+            parser_match(parser, TOKEN_COLON);
+            default_node->as.default_stmt.statements = parse_case_body(parser, &default_node->as.default_stmt.statement_count);
+            node->as.switch_stmt.default_case = default_node;
+        } else {
+            set_error(parser, "متوقع 'حالة' أو 'افتراضي' داخل 'حسب'");
+            break;
+        }
+    }
+    
+    parser_consume(parser, TOKEN_END, "متوقع 'انتهى' في نهاية جملة 'حسب'");
+    compile_switch(node);
+    return node;
+}
+
 // تحليل حلقة طالما
 static ASTNode *parse_while(Parser *parser) {
     ASTNode *node = create_node(AST_WHILE);
@@ -316,10 +510,18 @@ static ASTNode *parse_function_def(Parser *parser) {
     Token name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الدالة بعد 'دالة'");
     node->as.function_def.name = strdup(name.value);
     
+    // التسجيل قبل الجسم ليعرف الاستدعاء الذاتي
+    if (parser->function_count >= parser->function_capacity) {
+        parser->function_capacity = parser->function_capacity ? parser->function_capacity * 2 : 16;
+        parser->functions = realloc(parser->functions, sizeof(char*) * parser->function_capacity);
+    }
+    parser->functions[parser->function_count++] = strdup(name.value);
+    
     // قراءة المعاملات
     node->as.function_def.params = malloc(sizeof(char*) * 20);
     node->as.function_def.param_count = 0;
     node->as.function_def.is_async = false;
+    node->as.function_def.is_generator = false;
     node->as.function_def.is_static = false;
     node->as.function_def.return_type = NULL;
     
@@ -336,14 +538,14 @@ static ASTNode *parse_function_def(Parser *parser) {
         node->as.function_def.params[node->as.function_def.param_count++] = strdup(param.value);
         
         // تخطي الفاصلة إذا وجدت
-        if (parser_check(parser, TOKEN_COMMA) || parser_check(parser, TOKEN_IDENTIFIER)) {
-            parser_advance(parser);
-        }
+        parser_match(parser, TOKEN_COMMA);
     }
     
     skip_newlines(parser);
     
-    // جمع جسم الدالة
+    // جمع جسم الدالة (الدوال المتداخلة تحفظ علامة 'أنتج' للدالة الخارجية)
+    bool outer_saw_yield = parser->saw_yield;
+    parser->saw_yield = false;
     ASTNode **body_stmts = malloc(sizeof(ASTNode*) * 100);
     int body_count = 0;
     
@@ -358,11 +560,213 @@ static ASTNode *parse_function_def(Parser *parser) {
     body_node->as.program.statements = body_stmts;
     body_node->as.program.count = body_count;
     node->as.function_def.body = body_node;
+    node->as.function_def.is_generator = parser->saw_yield;
+    parser->saw_yield = outer_saw_yield;
     
     parser_consume(parser, TOKEN_END, "متوقع 'انتهى' في نهاية تعريف الدالة");
     return node;
 }
 
+// البحث عن هيكل معرف سابقاً بالاسم
+static StructDef *find_struct(Parser *parser, const char *name) {
+    for (int i = parser->struct_count - 1; i >= 0; i--) {
+        if (strcmp(parser->structs[i]->name, name) == 0) {
+            return parser->structs[i];
+        }
+    }
+    return NULL;
+}
+
+// تحليل تعريف هيكل: الحقول أسماء مفصولة بأسطر أو فواصل حتى 'انتهى'
+// يبنى تخطيط الحقول هنا فيعرف موضع كل حقل قبل التنفيذ
+static ASTNode *parse_struct_def(Parser *parser) {
+    ASTNode *node = create_node(AST_STRUCT_DEF);
+    node->line = parser->tokens[parser->position].line;
+    node->column = parser->tokens[parser->position].column;
+    
+    Token name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الهيكل بعد 'هيكل'");
+    node->as.struct_def.name = strdup(name.value);
+    
+    int capacity = 8;
+    node->as.struct_def.fields = malloc(sizeof(char*) * capacity);
+    node->as.struct_def.field_count = 0;
+    
+    StructDef *def = malloc(sizeof(StructDef));
+    def->name = node->as.struct_def.name;
+    def->shape = shape_root();
+    
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_END) && !parser_check(parser, TOKEN_EOF)) {
+        Token field = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم حقل في الهيكل");
+        if (field.type != TOKEN_IDENTIFIER) break;
+        if (shape_find(def->shape, field.value) >= 0) {
+            set_error(parser, "حقل مكرر في الهيكل");
+            break;
+        }
+        
+        if (node->as.struct_def.field_count >= capacity) {
+            capacity *= 2;
+            node->as.struct_def.fields = realloc(node->as.struct_def.fields, sizeof(char*) * capacity);
+        }
+        node->as.struct_def.fields[node->as.struct_def.field_count++] = strdup(field.value);
+        def->shape = shape_transition(def->shape, field.value);
+        
+        parser_match(parser, TOKEN_COMMA);
+        skip_newlines(parser);
+    }
+    parser_consume(parser, TOKEN_END, "متوقع 'انتهى' في نهاية تعريف الهيكل");
+    
+    node->as.struct_def.layout = def;
+    if (parser->struct_count >= parser->struct_capacity) {
+        parser->struct_capacity = parser->struct_capacity ? parser->struct_capacity * 2 : 8;
+        parser->structs = realloc(parser->structs, sizeof(StructDef*) * parser->struct_capacity);
+    }
+    parser->structs[parser->struct_count++] = def;
+    return node;
+}
+
+// تحليل إنشاء هيكل: طالب أو طالب{اسم: "محمد"، عمر: 20}
+// أسماء الحقول تحول إلى مواضعها هنا فلا يبحث عنها عند التنفيذ
+static ASTNode *parse_struct_create(Parser *parser, Token name, StructDef *def) {
+    ASTNode *node = create_node(AST_STRUCT_CREATE);
+    node->line = name.line;
+    node->column = name.column;
+    node->as.struct_create.struct_name = strdup(name.value);
+    node->as.struct_create.var_name = NULL;
+    node->as.struct_create.layout = def;
+    node->as.struct_create.values = calloc(def->shape->count ? def->shape->count : 1, sizeof(ASTNode*));
+    
+    if (!parser_check(parser, TOKEN_LBRACE) || parser_peek(parser).line != name.line) {
+        return node;
+    }
+    
+    parser_advance(parser);
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_RBRACE) && !parser_check(parser, TOKEN_EOF)) {
+        Token field = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم حقل");
+        if (field.type != TOKEN_IDENTIFIER) break;
+        parser_consume(parser, TOKEN_COLON, "متوقع ':' بعد اسم الحقل");
+        
+        int slot = shape_find(def->shape, field.value);
+        if (slot < 0) {
+            set_error(parser, "حقل غير موجود في الهيكل");
+            break;
+        }
+        node->as.struct_create.values[slot] = parse_expression(parser);
+        
+        skip_newlines(parser);
+        if (!parser_match(parser, TOKEN_COMMA)) break;
+        skip_newlines(parser);
+    }
+    
+    skip_newlines(parser);
+    parser_consume(parser, TOKEN_RBRACE, "متوقع '}' في نهاية إنشاء الهيكل");
+    return node;
+}
+
+// تحليل صنف: الحقول أسماء مفردة والدوال تعريفات 'دالة' حتى 'انتهى'
+static ASTNode *parse_class_def(Parser *parser) {
+    ASTNode *node = create_node(AST_CLASS_DEF);
+    node->line = parser->tokens[parser->position].line;
+    node->column = parser->tokens[parser->position].column;
+    
+    Token name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الصنف بعد 'صنف'");
+    node->as.class_def.name = strdup(name.value);
+    node->as.class_def.parent_name = NULL;
+    node->as.class_def.is_abstract = false;
+    node->as.class_def.interfaces = NULL;
+    node->as.class_def.interface_count = 0;
+    
+    if (parser_match(parser, TOKEN_EXTENDS)) {
+        Token parent = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الصنف الأب بعد 'يرث'");
+        node->as.class_def.parent_name = strdup(parent.value);
+    }
+    
+    int field_capacity = 8;
+    int method_capacity = 8;
+    node->as.class_def.fields = malloc(sizeof(char*) * field_capacity);
+    node->as.class_def.field_count = 0;
+    node->as.class_def.methods = malloc(sizeof(ASTNode*) * method_capacity);
+    node->as.class_def.method_count = 0;
+    
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_END) && !parser_check(parser, TOKEN_EOF)) {
+        if (parser_match(parser, TOKEN_FUNCTION)) {
+            if (node->as.class_def.method_count >= method_capacity) {
+                method_capacity *= 2;
+                node->as.class_def.methods = realloc(node->as.class_def.methods,
+                                                     sizeof(ASTNode*) * method_capacity);
+            }
+            node->as.class_def.methods[node->as.class_def.method_count++] = parse_function_def(parser);
+        } else {
+            Token field = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع حقل أو دالة في الصنف");
+            if (field.type != TOKEN_IDENTIFIER) break;
+            if (node->as.class_def.field_count >= field_capacity) {
+                field_capacity *= 2;
+                node->as.class_def.fields = realloc(node->as.class_def.fields,
+                                                    sizeof(char*) * field_capacity);
+            }
+            node->as.class_def.fields[node->as.class_def.field_count++] = strdup(field.value);
+        }
+        skip_newlines(parser);
+    }
+    
+    parser_consume(parser, TOKEN_END, "متوقع 'انتهى' في نهاية تعريف الصنف");
+    return node;
+}
+
+// تحليل معاملات الاستدعاء بين قوسين: (أ، ب، ...)
+static int parse_call_args(Parser *parser, ASTNode ***args) {
+    int capacity = 4;
+    int count = 0;
+    *args = malloc(sizeof(ASTNode*) * capacity);
+    
+    parser_consume(parser, TOKEN_LPAREN, "متوقع '('");
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_RPAREN) && !parser_check(parser, TOKEN_EOF)) {
+        if (count >= capacity) {
+            capacity *= 2;
+            *args = realloc(*args, sizeof(ASTNode*) * capacity);
+        }
+        (*args)[count++] = parse_expression(parser);
+        skip_newlines(parser);
+        if (!parser_match(parser, TOKEN_COMMA)) break;
+        skip_newlines(parser);
+    }
+    parser_consume(parser, TOKEN_RPAREN, "متوقع ')' في نهاية المعاملات");
+    return count;
+}
+
+// هل الاسم دالة معرفة سابقاً
+static bool is_known_function(Parser *parser, const char *name) {
+    for (int i = parser->function_count - 1; i >= 0; i--) {
+        if (strcmp(parser->functions[i], name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// هل يبدأ الرمز التالي معاملاً في استدعاء دون أقواس (جمع 10 20)
+static bool starts_argument(Parser *parser) {
+    switch (parser_peek(parser).type) {
+        case TOKEN_NUMBER:
+        case TOKEN_STRING:
+        case TOKEN_IDENTIFIER:
+        case TOKEN_TRUE:
+        case TOKEN_FALSE:
+        case TOKEN_NULL:
+        case TOKEN_LPAREN:
+        case TOKEN_LBRACKET:
+        case TOKEN_LBRACE:
+        case TOKEN_THIS:
+        case TOKEN_NEW:
+            return true;
+        default:
+            return false;
+    }
+}
+
 // تحليل استدعاء دالة
 static ASTNode *parse_function_call(Parser *parser, const char *name) {
     ASTNode *node = create_node(AST_FUNCTION_CALL);
@@ -375,38 +779,85 @@ static ASTNode *parse_function_call(Parser *parser, const char *name) {
     node->as.function_call.is_method = false;
     node->as.function_call.object = NULL;
     
-    // قراءة المعاملات
-    while (!parser_check(parser, TOKEN_NEWLINE) && !parser_check(parser, TOKEN_EOF) &&
-           !parser_check(parser, TOKEN_END)) {
+    // قراءة المعاملات: تعبيرات متتالية على السطر نفسه، والفاصلة اختيارية
+    while (starts_argument(parser) && node->as.function_call.arg_count < 20) {
         node->as.function_call.args[node->as.function_call.arg_count++] = parse_expression(parser);
+        parser_match(parser, TOKEN_COMMA);
+    }
+    
+    return node;
+}
+
+// تحليل الخريطة الحرفية [مفتاح: قيمة, ...] بعد أول مفتاح، أو [:] الفارغة
+static ASTNode *parse_map(Parser *parser, ASTNode *first_key, int line, int column) {
+    ASTNode *node = create_node(AST_MAP);
+    node->line = line;
+    node->column = column;
+    
+    int capacity = 8;
+    node->as.map.keys = malloc(sizeof(ASTNode*) * capacity);
+    node->as.map.values = malloc(sizeof(ASTNode*) * capacity);
+    node->as.map.count = 0;
+    
+    ASTNode *key = first_key;
+    while (key) {
+        parser_consume(parser, TOKEN_COLON, "متوقع ':' بعد مفتاح الخريطة");
+        skip_newlines(parser);
         
-        // تخطي الفاصلة إذا وجدت
-        if (parser_check(parser, TOKEN_COMMA) || parser_check(parser, TOKEN_IDENTIFIER)) {
-            parser_advance(parser);
-        } else {
-            break;
+        if (node->as.map.count >= capacity) {
+            capacity *= 2;
+            node->as.map.keys = realloc(node->as.map.keys, sizeof(ASTNode*) * capacity);
+            node->as.map.values = realloc(node->as.map.values, sizeof(ASTNode*) * capacity);
+        }
+        node->as.map.keys[node->as.map.count] = key;
+        node->as.map.values[node->as.map.count] = parse_expression(parser);
+        node->as.map.count++;
+        skip_newlines(parser);
+        
+        key = NULL;
+        if (parser_match(parser, TOKEN_COMMA)) {
+            skip_newlines(parser);
+            if (!parser_check(parser, TOKEN_RBRACKET)) key = parse_expression(parser);
         }
     }
     
+    parser_consume(parser, TOKEN_RBRACKET, "متوقع ']' في نهاية الخريطة");
     return node;
 }
 
 // تحليل المصفوفة
 static ASTNode *parse_array(Parser *parser) {
-    ASTNode *node = create_node(AST_ARRAY);
-    node->line = parser->tokens[parser->position].line;
-    node->column = parser->tokens[parser->position].column;
+    int line = parser->tokens[parser->position].line;
+    int column = parser->tokens[parser->position].column;
     
     parser_consume(parser, TOKEN_LBRACKET, "متوقع '['");
+    skip_newlines(parser);
     
+    // [:] خريطة فارغة
+    if (parser_match(parser, TOKEN_COLON)) {
+        skip_newlines(parser);
+        return parse_map(parser, NULL, line, column);
+    }
+    
+    ASTNode *node = create_node(AST_ARRAY);
+    node->line = line;
+    node->column = column;
     node->as.array.elements = malloc(sizeof(ASTNode*) * 100);
     node->as.array.count = 0;
     
     while (!parser_check(parser, TOKEN_RBRACKET) && !parser_check(parser, TOKEN_EOF)) {
         skip_newlines(parser);
-        node->as.array.elements[node->as.array.count++] = parse_expression(parser);
+        ASTNode *element = parse_expression(parser);
         skip_newlines(parser);
         
+        // مفتاح متبوع بـ ':' في أول عنصر يجعل الحرف خريطة
+        if (node->as.array.count == 0 && parser_check(parser, TOKEN_COLON)) {
+            free(node->as.array.elements);
+            free(node);
+            return parse_map(parser, element, line, column);
+        }
+        node->as.array.elements[node->as.array.count++] = element;
+        
         if (parser_match(parser, TOKEN_COMMA)) {
             continue;
         } else {
@@ -418,23 +869,106 @@ static ASTNode *parse_array(Parser *parser) {
     return node;
 }
 
-// تحليل الوصول للمصفوفة
-static ASTNode *parse_array_access(Parser *parser, const char *name) {
-    ASTNode *node = create_node(AST_ARRAY_ACCESS);
+// تحليل الكائن الحرفي {مفتاح: قيمة، ...}
+static ASTNode *parse_object(Parser *parser) {
+    ASTNode *node = create_node(AST_OBJECT);
     node->line = parser->tokens[parser->position].line;
     node->column = parser->tokens[parser->position].column;
     
-    ASTNode *id_node = create_node(AST_IDENTIFIER);
-    id_node->as.identifier.name = strdup(name);
-    node->as.array_access.array = id_node;
+    parser_consume(parser, TOKEN_LBRACE, "متوقع '{'");
     
-    parser_consume(parser, TOKEN_LBRACKET, "متوقع '['");
-    node->as.array_access.index = parse_expression(parser);
-    parser_consume(parser, TOKEN_RBRACKET, "متوقع ']'");
+    int capacity = 8;
+    node->as.object.keys = malloc(sizeof(char*) * capacity);
+    node->as.object.values = malloc(sizeof(ASTNode*) * capacity);
+    node->as.object.count = 0;
+    
+    skip_newlines(parser);
+    while (!parser_check(parser, TOKEN_RBRACE) && !parser_check(parser, TOKEN_EOF)) {
+        Token key = parser_peek(parser);
+        if (key.type != TOKEN_IDENTIFIER && key.type != TOKEN_STRING) {
+            set_error(parser, "متوقع اسم مفتاح في الكائن");
+            break;
+        }
+        parser_advance(parser);
+        parser_consume(parser, TOKEN_COLON, "متوقع ':' بعد المفتاح");
+        
+        if (node->as.object.count >= capacity) {
+            capacity *= 2;
+            node->as.object.keys = realloc(node->as.object.keys, sizeof(char*) * capacity);
+            node->as.object.values = realloc(node->as.object.values, sizeof(ASTNode*) * capacity);
+        }
+        node->as.object.keys[node->as.object.count] = strdup(key.value);
+        node->as.object.values[node->as.object.count] = parse_expression(parser);
+        node->as.object.count++;
+        
+        skip_newlines(parser);
+        if (!parser_match(parser, TOKEN_COMMA)) break;
+        skip_newlines(parser);
+    }
     
+    skip_newlines(parser);
+    parser_consume(parser, TOKEN_RBRACE, "متوقع '}' في نهاية الكائن");
     return node;
 }
 
+// تحليل اللواحق: الوصول بالفهرس أ[ف] والوصول للخاصية ك.خ
+static ASTNode *parse_postfix(Parser *parser, ASTNode *node) {
+    while (true) {
+        Token token = parser_peek(parser);
+        
+        if (token.type == TOKEN_LBRACKET) {
+            parser_advance(parser);
+            ASTNode *access = create_node(AST_ARRAY_ACCESS);
+            access->as.array_access.array = node;
+            access->as.array_access.index = parse_expression(parser);
+            access->line = token.line;
+            access->column = token.column;
+            parser_consume(parser, TOKEN_RBRACKET, "متوقع ']'");
+            node = access;
+        } else if (token.type == TOKEN_DOT) {
+            parser_advance(parser);
+            Token name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الخاصية بعد '.'");
+            if (parser_check(parser, TOKEN_LPAREN)) {
+                // استدعاء دالة على نسخة: ك.دالة(معاملات)
+                ASTNode *call = create_node(AST_METHOD_CALL);
+                call->as.method_call.object = node;
+                call->as.method_call.method_name = strdup(name.value);
+                call->as.method_call.arg_count = parse_call_args(parser, &call->as.method_call.args);
+                call->line = token.line;
+                call->column = token.column;
+                node = call;
+                continue;
+            }
+            ASTNode *access = create_node(AST_PROPERTY_ACCESS);
+            access->as.property_access.object = node;
+            access->as.property_access.property = strdup(name.value);
+            access->line = token.line;
+            access->column = token.column;
+            node = access;
+        } else {
+            return node;
+        }
+    }
+}
+
+// تحويل نص الرقم إلى قيمة: عدد صحيح إن أمكن تمثيله بدقة، وإلا عدد عشري
+static Value parse_number_literal(const char *text) {
+    if (text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        // الأعداد الست عشرية تغطي 64 بت كاملة (0xFFFFFFFFFFFFFFFF = -1)
+        return value_create_int((int64_t)strtoull(text + 2, NULL, 16));
+    }
+    
+    if (!strpbrk(text, ".eE")) {
+        errno = 0;
+        long long integer = strtoll(text, NULL, 10);
+        if (errno != ERANGE) {
+            return value_create_int(integer);
+        }
+    }
+    
+    return value_create_number(atof(text));
+}
+
 // تحليل التعبير الأساسي
 static ASTNode *parse_primary(Parser *parser) {
     skip_newlines(parser);
@@ -446,12 +980,12 @@ static ASTNode *parse_primary(Parser *parser) {
             parser_advance(parser);
             {
                 ASTNode *node = create_node(AST_LITERAL);
-                node->as.literal.value = value_create_number(atof(token.value));
+                node->as.literal.value = parse_number_literal(token.value);
                 node->line = token.line;
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_STRING:
             parser_advance(parser);
             {
@@ -461,7 +995,7 @@ static ASTNode *parse_primary(Parser *parser) {
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_TRUE:
             parser_advance(parser);
             {
@@ -471,7 +1005,7 @@ static ASTNode *parse_primary(Parser *parser) {
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_FALSE:
             parser_advance(parser);
             {
@@ -481,7 +1015,7 @@ static ASTNode *parse_primary(Parser *parser) {
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_NULL:
             parser_advance(parser);
             {
@@ -491,33 +1025,83 @@ static ASTNode *parse_primary(Parser *parser) {
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_IDENTIFIER:
             parser_advance(parser);
-            // التحقق من استدعاء دالة أو الوصول للمصفوفة
-            if (parser_check(parser, TOKEN_LBRACKET)) {
-                return parse_array_access(parser, token.value);
-            }
-            // يمكن إضافة المزيد من الحالات هنا
             {
+                StructDef *def = find_struct(parser, token.value);
+                if (def) {
+                    return parse_postfix(parser, parse_struct_create(parser, token, def));
+                }
+                
+                // استدعاء بأقواس د(أ، ب)، أو دون أقواس لدالة معرفة: د أ ب
+                if (parser_check(parser, TOKEN_LPAREN) ||
+                    (is_known_function(parser, token.value) && starts_argument(parser) &&
+                     parser_peek(parser).line == token.line)) {
+                    ASTNode *call;
+                    if (parser_check(parser, TOKEN_LPAREN)) {
+                        call = create_node(AST_FUNCTION_CALL);
+                        call->as.function_call.name = strdup(token.value);
+                        call->as.function_call.is_method = false;
+                        call->as.function_call.object = NULL;
+                        call->as.function_call.arg_count = parse_call_args(parser, &call->as.function_call.args);
+                    } else {
+                        call = parse_function_call(parser, token.value);
+                    }
+                    call->line = token.line;
+                    call->column = token.column;
+                    return parse_postfix(parser, call);
+                }
+                
                 ASTNode *node = create_node(AST_IDENTIFIER);
                 node->as.identifier.name = strdup(token.value);
                 node->line = token.line;
                 node->column = token.column;
-                return node;
+                // الوصول للمصفوفة أو للخاصية
+                return parse_postfix(parser, node);
             }
-            
+        
+        case TOKEN_THIS:
+            parser_advance(parser);
+            {
+                ASTNode *node = create_node(AST_THIS);
+                node->as.this_expr.property = NULL;
+                node->line = token.line;
+                node->column = token.column;
+                return parse_postfix(parser, node);
+            }
+        
+        case TOKEN_NEW:
+            parser_advance(parser);
+            {
+                // جديد صنف أو جديد صنف(معاملات)
+                Token name = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم الصنف بعد 'جديد'");
+                ASTNode *node = create_node(AST_NEW);
+                node->as.new_stmt.class_name = strdup(name.value);
+                node->as.new_stmt.args = NULL;
+                node->as.new_stmt.arg_count = 0;
+                if (parser_check(parser, TOKEN_LPAREN)) {
+                    node->as.new_stmt.arg_count = parse_call_args(parser, &node->as.new_stmt.args);
+                }
+                node->line = token.line;
+                node->column = token.column;
+                return parse_postfix(parser, node);
+            }
+        
         case TOKEN_LPAREN:
             parser_advance(parser);
             {
                 ASTNode *expr = parse_expression(parser);
                 parser_consume(parser, TOKEN_RPAREN, "متوقع ')'");
-                return expr;
+                return parse_postfix(parser, expr);
             }
-            
+        
         case TOKEN_LBRACKET:
             return parse_array(parser);
-            
+        
+        case TOKEN_LBRACE:
+            return parse_object(parser);
+        
         default:
             set_error(parser, "تعبير غير متوقع");
             return create_node(AST_LITERAL);
@@ -526,7 +1110,8 @@ static ASTNode *parse_primary(Parser *parser) {
 
 // تحليل التعبير الأحادي
 static ASTNode *parse_unary(Parser *parser) {
-    if (parser_match(parser, TOKEN_MINUS) || parser_match(parser, TOKEN_NOT)) {
+    if (parser_match(parser, TOKEN_MINUS) || parser_match(parser, TOKEN_NOT) ||
+        parser_match(parser, TOKEN_BIT_NOT)) {
         TokenType op = parser->tokens[parser->position - 1].type;
         ASTNode *node = create_node(AST_UNARY_OP);
         node->as.unary_op.op = op;
@@ -536,6 +1121,15 @@ static ASTNode *parse_unary(Parser *parser) {
         return node;
     }
     
+    // انتظر تعبير: تعليق التنفيذ حتى يتحقق الوعد
+    if (parser_match(parser, TOKEN_AWAIT)) {
+        ASTNode *node = create_node(AST_AWAIT);
+        node->line = parser->tokens[parser->position - 1].line;
+        node->column = parser->tokens[parser->position - 1].column;
+        node->as.await_stmt.promise = parse_unary(parser);
+        return node;
+    }
+    
     return parse_primary(parser);
 }
 
@@ -577,19 +1171,38 @@ static ASTNode *parse_additive(Parser *parser) {
     return left;
 }
 
+// تحليل الإزاحة
+static ASTNode *parse_shift(Parser *parser) {
+    ASTNode *left = parse_additive(parser);
+    
+    while (parser_match(parser, TOKEN_SHIFT_LEFT) || parser_match(parser, TOKEN_SHIFT_RIGHT)) {
+        TokenType op = parser->tokens[parser->position - 1].type;
+        ASTNode *node = create_node(AST_BINARY_OP);
+        node->as.binary_op.op = op;
+        node->as.binary_op.left = left;
+        node->as.binary_op.right = parse_additive(parser);
+        node->line = parser->tokens[parser->position].line;
+        node->column = parser->tokens[parser->position].column;
+        left = node;
+    }
+    
+    return left;
+}
+
 // تحليل المقارنات
 static ASTNode *parse_comparison(Parser *parser) {
-    ASTNode *left = parse_additive(parser);
+    ASTNode *left = parse_shift(parser);
     
     while (parser_match(parser, TOKEN_GREATER) || 
            parser_match(parser, TOKEN_LESS) || 
            parser_match(parser, TOKEN_GREATER_EQ) || 
-           parser_match(parser, TOKEN_LESS_EQ)) {
+           parser_match(parser, TOKEN_LESS_EQ) ||
+           parser_match(parser, TOKEN_IN)) {
         TokenType op = parser->tokens[parser->position - 1].type;
         ASTNode *node = create_node(AST_BINARY_OP);
         node->as.binary_op.op = op;
         node->as.binary_op.left = left;
-        node->as.binary_op.right = parse_additive(parser);
+        node->as.binary_op.right = parse_shift(parser);
         node->line = parser->tokens[parser->position].line;
         node->column = parser->tokens[parser->position].column;
         left = node;
@@ -616,16 +1229,52 @@ static ASTNode *parse_equality(Parser *parser) {
     return left;
 }
 
+// تحليل AND الثنائي (على مستوى البت)
+static ASTNode *parse_bitwise_and(Parser *parser) {
+    ASTNode *left = parse_equality(parser);
+    
+    while (parser_match(parser, TOKEN_BIT_AND)) {
+        TokenType op = parser->tokens[parser->position - 1].type;
+        ASTNode *node = create_node(AST_BINARY_OP);
+        node->as.binary_op.op = op;
+        node->as.binary_op.left = left;
+        node->as.binary_op.right = parse_equality(parser);
+        node->line = parser->tokens[parser->position].line;
+        node->column = parser->tokens[parser->position].column;
+        left = node;
+    }
+    
+    return left;
+}
+
+// تحليل OR الثنائي (على مستوى البت)
+static ASTNode *parse_bitwise_or(Parser *parser) {
+    ASTNode *left = parse_bitwise_and(parser);
+    
+    while (parser_match(parser, TOKEN_BIT_OR)) {
+        TokenType op = parser->tokens[parser->position - 1].type;
+        ASTNode *node = create_node(AST_BINARY_OP);
+        node->as.binary_op.op = op;
+        node->as.binary_op.left = left;
+        node->as.binary_op.right = parse_bitwise_and(parser);
+        node->line = parser->tokens[parser->position].line;
+        node->column = parser->tokens[parser->position].column;
+        left = node;
+    }
+    
+    return left;
+}
+
 // تحليل AND المنطقي
 static ASTNode *parse_logical_and(Parser *parser) {
-    ASTNode *left = parse_equality(parser);
+    ASTNode *left = parse_bitwise_or(parser);
     
     while (parser_match(parser, TOKEN_AND)) {
         TokenType op = parser->tokens[parser->position - 1].type;
         ASTNode *node = create_node(AST_BINARY_OP);
         node->as.binary_op.op = op;
         node->as.binary_op.left = left;
-        node->as.binary_op.right = parse_equality(parser);
+        node->as.binary_op.right = parse_bitwise_or(parser);
         node->line = parser->tokens[parser->position].line;
         node->column = parser->tokens[parser->position].column;
         left = node;
@@ -657,6 +1306,89 @@ static ASTNode *parse_expression(Parser *parser) {
     return parse_logical_or(parser);
 }
 
+// المعامل الحسابي المقابل لمعامل التعيين المركب
+static TokenType compound_operator(TokenType type) {
+    switch (type) {
+        case TOKEN_PLUS_ASSIGN: return TOKEN_PLUS;
+        case TOKEN_MINUS_ASSIGN: return TOKEN_MINUS;
+        case TOKEN_MUL_ASSIGN: return TOKEN_MULTIPLY;
+        case TOKEN_DIV_ASSIGN: return TOKEN_DIVIDE;
+        default: return TOKEN_MODULO;
+    }
+}
+
+// التحقق من أن التعبير خال من الآثار الجانبية (لا استدعاءات ولا تعيينات)
+static bool is_pure_expression(ASTNode *node) {
+    if (!node) return true;
+    
+    switch (node->type) {
+        case AST_LITERAL:
+        case AST_IDENTIFIER:
+            return true;
+        case AST_BINARY_OP:
+            return is_pure_expression(node->as.binary_op.left) &&
+                   is_pure_expression(node->as.binary_op.right);
+        case AST_UNARY_OP:
+            return is_pure_expression(node->as.unary_op.operand);
+        case AST_ARRAY_ACCESS:
+            return is_pure_expression(node->as.array_access.array) &&
+                   is_pure_expression(node->as.array_access.index);
+        case AST_ARRAY:
+            for (int i = 0; i < node->as.array.count; i++) {
+                if (!is_pure_expression(node->as.array.elements[i])) return false;
+            }
+            return true;
+        case AST_PROPERTY_ACCESS:
+            return is_pure_expression(node->as.property_access.object);
+        case AST_OBJECT:
+            for (int i = 0; i < node->as.object.count; i++) {
+                if (!is_pure_expression(node->as.object.values[i])) return false;
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+// التحقق من نمط الإلحاق بالذات: س = س + أ + ب ...
+static bool is_self_append(const char *name, ASTNode *value) {
+    if (!value || value->type != AST_BINARY_OP) return false;
+    
+    while (value->type == AST_BINARY_OP && value->as.binary_op.op == TOKEN_PLUS) {
+        if (!is_pure_expression(value->as.binary_op.right)) return false;
+        value = value->as.binary_op.left;
+    }
+    return value->type == AST_IDENTIFIER && strcmp(value->as.identifier.name, name) == 0;
+}
+
+// تحليل جملة تبدأ بموضع: أ[ف] = قيمة أو ك.خ = قيمة أو هذا.خ += قيمة
+// إن لم يتبع الموضع معامل تعيين فهي تعبير عادي
+static ASTNode *parse_place_statement(Parser *parser, Token token) {
+    int start = parser->position;
+    ASTNode *target = parse_primary(parser);
+    Token op = parser_peek(parser);
+    
+    if ((target->type == AST_ARRAY_ACCESS || target->type == AST_PROPERTY_ACCESS) &&
+        (op.type == TOKEN_ASSIGN || op.type == TOKEN_PLUS_ASSIGN ||
+         op.type == TOKEN_MINUS_ASSIGN || op.type == TOKEN_MUL_ASSIGN ||
+         op.type == TOKEN_DIV_ASSIGN || op.type == TOKEN_MOD_ASSIGN)) {
+        parser_advance(parser);
+        ASTNode *node = create_node(target->type == AST_ARRAY_ACCESS ?
+                                    AST_INDEX_ASSIGN : AST_PROPERTY_ASSIGN);
+        node->as.place_assign.target = target;
+        node->as.place_assign.op = op.type == TOKEN_ASSIGN ?
+                                   TOKEN_ASSIGN : compound_operator(op.type);
+        node->as.place_assign.value = parse_expression(parser);
+        node->line = token.line;
+        node->column = token.column;
+        return node;
+    }
+    
+    // ليس تعييناً: تعبير عادي
+    parser->position = start;
+    return parse_expression(parser);
+}
+
 // تحليل جملة
 static ASTNode *parse_statement(Parser *parser) {
     skip_newlines(parser);
@@ -667,35 +1399,91 @@ static ASTNode *parse_statement(Parser *parser) {
         case TOKEN_PRINT:
             parser_advance(parser);
             return parse_print(parser);
-            
+        
         case TOKEN_INPUT:
             parser_advance(parser);
             return parse_input(parser);
-            
+        
         case TOKEN_LET:
             parser_advance(parser);
             return parse_let(parser);
-            
+        
         case TOKEN_CONST:
             parser_advance(parser);
             return parse_const(parser);
-            
+        
         case TOKEN_IF:
             parser_advance(parser);
             return parse_if(parser);
-            
+        
         case TOKEN_FOR:
             parser_advance(parser);
             return parse_for(parser);
-            
+        
+        case TOKEN_PARALLEL_FOR:
+            parser_advance(parser);
+            {
+                // الصيغة نفسها، وصيغة "في" تبقى تسلسلية
+                ASTNode *loop = parse_for(parser);
+                if (loop->type == AST_FOR) loop->as.for_loop.is_parallel = true;
+                return loop;
+            }
+        
         case TOKEN_WHILE:
             parser_advance(parser);
             return parse_while(parser);
-            
+        
+        case TOKEN_FOREACH:
+            parser_advance(parser);
+            {
+                Token var = parser_consume(parser, TOKEN_IDENTIFIER, "متوقع اسم المتغير بعد 'لكل_عنصر'");
+                return parse_foreach_body(parser, var);
+            }
+        
+        case TOKEN_YIELD:
+            parser_advance(parser);
+            {
+                // أنتج تعبير: تعليق المولد وتسليم القيمة لمن يكرر عليه
+                ASTNode *node = create_node(AST_YIELD);
+                node->line = token.line;
+                node->column = token.column;
+                if (!parser_check(parser, TOKEN_NEWLINE) && !parser_check(parser, TOKEN_END)) {
+                    node->as.yield_stmt.value = parse_expression(parser);
+                } else {
+                    node->as.yield_stmt.value = NULL;
+                }
+                parser->saw_yield = true;
+                return node;
+            }
+        
         case TOKEN_FUNCTION:
             parser_advance(parser);
             return parse_function_def(parser);
-            
+        
+        case TOKEN_ASYNC:
+            parser_advance(parser);
+            parser_consume(parser, TOKEN_FUNCTION, "متوقع 'دالة' بعد 'غير_متزامن'");
+            {
+                ASTNode *node = parse_function_def(parser);
+                node->as.function_def.is_async = true;
+                return node;
+            }
+        
+        case TOKEN_STRUCT:
+            parser_advance(parser);
+            return parse_struct_def(parser);
+        
+        case TOKEN_CLASS:
+            parser_advance(parser);
+            return parse_class_def(parser);
+        
+        case TOKEN_SWITCH:
+            parser_advance(parser);
+            return parse_switch(parser);
+        
+        case TOKEN_THIS:
+            return parse_place_statement(parser, token);
+        
         case TOKEN_RETURN:
             parser_advance(parser);
             {
@@ -709,7 +1497,7 @@ static ASTNode *parse_statement(Parser *parser) {
                 }
                 return node;
             }
-            
+        
         case TOKEN_BREAK:
             parser_advance(parser);
             {
@@ -718,7 +1506,7 @@ static ASTNode *parse_statement(Parser *parser) {
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_CONTINUE:
             parser_advance(parser);
             {
@@ -727,7 +1515,7 @@ static ASTNode *parse_statement(Parser *parser) {
                 node->column = token.column;
                 return node;
             }
-            
+        
         case TOKEN_IDENTIFIER:
             // التحقق من وجود تعيين
             {
@@ -738,14 +1526,50 @@ static ASTNode *parse_statement(Parser *parser) {
                     parser_advance(parser); // اسم المتغير
                     parser_advance(parser); // =
                     node->as.assign.value = parse_expression(parser);
+                    node->as.assign.is_append = is_self_append(node->as.assign.name,
+                                                               node->as.assign.value);
                     node->line = token.line;
                     node->column = token.column;
                     return node;
                 }
+                if (next.type == TOKEN_PLUS_ASSIGN || next.type == TOKEN_MINUS_ASSIGN ||
+                    next.type == TOKEN_MUL_ASSIGN || next.type == TOKEN_DIV_ASSIGN ||
+                    next.type == TOKEN_MOD_ASSIGN) {
+                    // س += تعبير تصبح س = س + تعبير
+                    ASTNode *node = create_node(AST_ASSIGN);
+                    node->as.assign.name = strdup(token.value);
+                    parser_advance(parser); // اسم المتغير
+                    parser_advance(parser); // المعامل المركب
+                    
+                    ASTNode *id_node = create_node(AST_IDENTIFIER);
+                    id_node->as.identifier.name = strdup(token.value);
+                    id_node->line = token.line;
+                    id_node->column = token.column;
+                    
+                    ASTNode *op_node = create_node(AST_BINARY_OP);
+                    op_node->as.binary_op.op = compound_operator(next.type);
+                    op_node->as.binary_op.left = id_node;
+                    op_node->as.binary_op.right = parse_expression(parser);
+                    op_node->line = next.line;
+                    op_node->column = next.column;
+                    
+                    node->as.assign.value = op_node;
+                    node->as.assign.is_append = is_self_append(node->as.assign.name, op_node);
+                    node->line = token.line;
+                    node->column = token.column;
+                    return node;
+                }
+                if (next.type == TOKEN_LBRACKET || next.type == TOKEN_DOT) {
+                    return parse_place_statement(parser, token);
+                }
             }
             // استدعاء دالة
+            if (parser_peek_next(parser).type == TOKEN_LPAREN || is_known_function(parser, token.value)) {
+                return parse_expression(parser);
+            }
+            parser_advance(parser);
             return parse_function_call(parser, token.value);
-            
+        
         default:
             return parse_expression(parser);
     }
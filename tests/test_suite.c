@@ -11,6 +11,7 @@
 #include "../include/wisam.h"
 #include <assert.h>
 #include <string.h>
+#include <pthread.h>
 
 /* ============================================
  * Test Framework
@@ -114,6 +115,29 @@ TEST(lexer_tokenize_number) {
     lexer_destroy(lexer);
 }
 
+TEST(lexer_tokenize_hex) {
+    // 0x بلا مراتب، أو بأكثر من 16 مرتبة، خطأ لا رقم
+    const char *invalid[] = {"ليكن س = 0x", "ليكن س = 0x1FFFFFFFFFFFFFFFF"};
+    for (int i = 0; i < 2; i++) {
+        Lexer *lexer = lexer_create(invalid[i], "test.wsm");
+        int token_count;
+        Token *tokens = lexer_tokenize(lexer, &token_count);
+        ASSERT_NOT_NULL(lexer_get_error(lexer));
+        free(tokens);
+        lexer_destroy(lexer);
+    }
+    
+    Lexer *lexer = lexer_create("0xFFFFFFFFFFFFFFFF 0x1f", "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    ASSERT_NULL(lexer_get_error(lexer));
+    ASSERT_EQ(tokens[0].type, TOKEN_NUMBER);
+    ASSERT_EQ(tokens[1].type, TOKEN_NUMBER);
+    
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
 TEST(lexer_tokenize_comments) {
     Lexer *lexer = lexer_create("# هذا تعليق\nليكن س = 5", "test.wsm");
     int token_count;
@@ -239,6 +263,81 @@ TEST(parser_parse_function) {
     lexer_destroy(lexer);
 }
 
+TEST(parser_parse_struct) {
+    const char *code =
+        "هيكل نقطة\n"
+        "    س\n"
+        "    ص\n"
+        "انتهى\n"
+        "ليكن ن = نقطة{ص: 2}";
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    ASSERT_NOT_NULL(ast);
+    ASSERT_EQ(ast->as.program.count, 2);
+    ASSERT_EQ(ast->as.program.statements[0]->type, AST_STRUCT_DEF);
+    ASSERT_EQ(ast->as.program.statements[0]->as.struct_def.field_count, 2);
+    
+    // مواضع الحقول معروفة عند التحليل: ص في الموضع 1
+    ASTNode *create = ast->as.program.statements[1]->as.let.value;
+    ASSERT_EQ(create->type, AST_STRUCT_CREATE);
+    ASSERT_NULL(create->as.struct_create.values[0]);
+    ASSERT_NOT_NULL(create->as.struct_create.values[1]);
+    
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(parser_parse_switch) {
+    const char *code =
+        "حسب س\n"
+        "    حالة 1\n"
+        "        اكتب 1\n"
+        "    حالة 2\n"
+        "        اكتب 2\n"
+        "    حالة 4\n"
+        "        اكتب 4\n"
+        "    حالة \"نص\"\n"
+        "        اكتب 5\n"
+        "    حالة ص\n"
+        "        اكتب 6\n"
+        "    افتراضي\n"
+        "        اكتب 0\n"
+        "انتهى";
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    ASSERT_NOT_NULL(ast);
+    ASTNode *sw = ast->as.program.statements[0];
+    ASSERT_EQ(sw->type, AST_SWITCH);
+    ASSERT_EQ(sw->as.switch_stmt.case_count, 5);
+    ASSERT_NOT_NULL(sw->as.switch_stmt.default_case);
+    
+    // 1 و 2 و 4 في جدول القفز، والنص في جدول التجزئة، و ص تقارن تسلسلياً
+    ASSERT_NOT_NULL(sw->as.switch_stmt.jump_table);
+    ASSERT_EQ(sw->as.switch_stmt.jump_size, 4);
+    ASSERT_EQ(sw->as.switch_stmt.jump_table[3], 3);
+    ASSERT_EQ(sw->as.switch_stmt.jump_table[2], 0);
+    ASSERT_NOT_NULL(sw->as.switch_stmt.label_table);
+    ASSERT_EQ(sw->as.switch_stmt.dynamic_count, 1);
+    ASSERT_EQ(sw->as.switch_stmt.dynamic_cases[0], 4);
+    
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
 TEST(parser_parse_array) {
     const char *code = "ليكن أرقام = [1، 2، 3]";
     Lexer *lexer = lexer_create(code, "test.wsm");
@@ -281,8 +380,8 @@ TEST(interpreter_number_literal) {
     
     Value *val = interpreter_get_variable(interp, "س");
     ASSERT_NOT_NULL(val);
-    ASSERT_EQ(val->type, VAL_NUMBER);
-    ASSERT_EQ(val->as.number, 42);
+    ASSERT_EQ(val->type, VAL_INT);
+    ASSERT_EQ(val->as.integer, 42);
     
     interpreter_destroy(interp);
     free(ast);
@@ -342,10 +441,77 @@ TEST(interpreter_arithmetic) {
     ASSERT_NOT_NULL(ضرب);
     ASSERT_NOT_NULL(قسمة);
     
-    ASSERT_EQ(جمع->as.number, 15);
-    ASSERT_EQ(طرح->as.number, 5);
-    ASSERT_EQ(ضرب->as.number, 50);
-    ASSERT_EQ(قسمة->as.number, 2);
+    ASSERT_EQ(جمع->as.integer, 15);
+    ASSERT_EQ(طرح->as.integer, 5);
+    ASSERT_EQ(ضرب->as.integer, 50);
+    ASSERT_EQ(قسمة->as.integer, 2);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_integer_overflow) {
+    const char *code =
+        "ليكن كبير = 9223372036854775807\n"
+        "ليكن فيض = كبير + 1\n"
+        "ليكن نصف = 7 / 2\n"
+        "ليكن تام = 8 / 2";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *كبير = interpreter_get_variable(interp, "كبير");
+    Value *فيض = interpreter_get_variable(interp, "فيض");
+    Value *نصف = interpreter_get_variable(interp, "نصف");
+    Value *تام = interpreter_get_variable(interp, "تام");
+    
+    ASSERT_EQ(كبير->type, VAL_INT);
+    ASSERT_EQ(كبير->as.integer, INT64_MAX);
+    ASSERT_EQ(فيض->type, VAL_NUMBER);
+    ASSERT_EQ(فيض->as.number, 9223372036854775808.0);
+    ASSERT_EQ(نصف->type, VAL_NUMBER);
+    ASSERT_EQ(نصف->as.number, 3.5);
+    ASSERT_EQ(تام->type, VAL_INT);
+    ASSERT_EQ(تام->as.integer, 4);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_bitwise) {
+    const char *code =
+        "ليكن و1 = 0xFF & 12\n"
+        "ليكن أو1 = 5 | 2\n"
+        "ليكن نفي = ~0\n"
+        "ليكن يسار = 1 << 40\n"
+        "ليكن يمين = -16 >> 2";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    ASSERT_EQ(interpreter_get_variable(interp, "و1")->as.integer, 12);
+    ASSERT_EQ(interpreter_get_variable(interp, "أو1")->as.integer, 7);
+    ASSERT_EQ(interpreter_get_variable(interp, "نفي")->as.integer, -1);
+    ASSERT_EQ(interpreter_get_variable(interp, "يسار")->as.integer, 1099511627776LL);
+    ASSERT_EQ(interpreter_get_variable(interp, "يمين")->as.integer, -4);
     
     interpreter_destroy(interp);
     free(ast);
@@ -432,7 +598,7 @@ TEST(interpreter_for_loop) {
     
     Value *مجموع = interpreter_get_variable(interp, "مجموع");
     ASSERT_NOT_NULL(مجموع);
-    ASSERT_EQ(مجموع->as.number, 15); // 1+2+3+4+5 = 15
+    ASSERT_EQ(مجموع->as.integer, 15); // 1+2+3+4+5 = 15
     
     interpreter_destroy(interp);
     free(ast);
@@ -441,12 +607,15 @@ TEST(interpreter_for_loop) {
     lexer_destroy(lexer);
 }
 
-TEST(interpreter_function) {
-    const char *code = 
-        "دالة جمع تأخذ أ ب\n"
-        "    أعد أ + ب\n"
-        "انتهى\n"
-        "ليكن ناتج = جمع 10 20";
+TEST(interpreter_string_append) {
+    const char *code =
+        "ليكن نص = \"\"\n"
+        "ليكن عدد = 0\n"
+        "لكل رقم من 1 إلى 100\n"
+        "    نص += \"أب\"\n"
+        "    نص = نص + \"-\" + رقم\n"
+        "    عدد += 2\n"
+        "انتهى";
     
     Lexer *lexer = lexer_create(code, "test.wsm");
     int token_count;
@@ -457,9 +626,14 @@ TEST(interpreter_function) {
     Interpreter *interp = interpreter_create();
     interpreter_run(interp, ast);
     
-    Value *ناتج = interpreter_get_variable(interp, "ناتج");
-    ASSERT_NOT_NULL(ناتج);
-    ASSERT_EQ(ناتج->as.number, 30);
+    Value *نص = interpreter_get_variable(interp, "نص");
+    ASSERT_NOT_NULL(نص);
+    ASSERT_EQ(string_char_count(نص->as.string), 492); // 100 * 3 + 192 خانة رقمية
+    ASSERT_TRUE(strncmp(نص->as.string, "أب-1أب-2", strlen("أب-1أب-2")) == 0);
+    
+    Value *عدد = interpreter_get_variable(interp, "عدد");
+    ASSERT_NOT_NULL(عدد);
+    ASSERT_EQ(عدد->as.integer, 200);
     
     interpreter_destroy(interp);
     free(ast);
@@ -468,8 +642,15 @@ TEST(interpreter_function) {
     lexer_destroy(lexer);
 }
 
-TEST(interpreter_array) {
-    const char *code = "ليكن أرقام = [1، 2، 3، 4، 5]";
+TEST(interpreter_string_append_self) {
+    // المعاملات تقيم قبل الإلحاق: النص يقرأ بقيمته قبل التعديل، والاستثناء لا يغيره
+    const char *code =
+        "ليكن س = \"x\"\n"
+        "س = س + \"y\" + س\n"
+        "ليكن ع = \"a\"\n"
+        "ليكن ل = [1]\n"
+        "ع = ع + \"b\" + ل[5]";
+    
     Lexer *lexer = lexer_create(code, "test.wsm");
     int token_count;
     Token *tokens = lexer_tokenize(lexer, &token_count);
@@ -479,10 +660,8 @@ TEST(interpreter_array) {
     Interpreter *interp = interpreter_create();
     interpreter_run(interp, ast);
     
-    Value *أرقام = interpreter_get_variable(interp, "أرقام");
-    ASSERT_NOT_NULL(أرقام);
-    ASSERT_EQ(أرقام->type, VAL_ARRAY);
-    ASSERT_EQ(أرقام->as.array.count, 5);
+    ASSERT(strcmp(interpreter_get_variable(interp, "س")->as.string, "xyx") == 0);
+    ASSERT(strcmp(interpreter_get_variable(interp, "ع")->as.string, "a") == 0);
     
     interpreter_destroy(interp);
     free(ast);
@@ -491,129 +670,1513 @@ TEST(interpreter_array) {
     lexer_destroy(lexer);
 }
 
-/* ============================================
- * Value Tests
- * اختبارات القيم
- * ============================================ */
-
-TEST(value_create_number) {
-    Value val = value_create_number(42.5);
-    ASSERT_EQ(val.type, VAL_NUMBER);
-    ASSERT_EQ(val.as.number, 42.5);
-}
-
-TEST(value_create_string) {
-    Value val = value_create_string("مرحبا");
-    ASSERT_EQ(val.type, VAL_STRING);
-    ASSERT(strcmp(val.as.string, "مرحبا") == 0);
-    free(val.as.string);
-}
-
-TEST(value_create_boolean) {
-    Value val = value_create_boolean(true);
-    ASSERT_EQ(val.type, VAL_BOOLEAN);
-    ASSERT_TRUE(val.as.boolean);
-}
-
-TEST(value_create_null) {
-    Value val = value_create_null();
-    ASSERT_EQ(val.type, VAL_NULL);
-}
-
-TEST(value_create_array) {
-    Value val = value_create_array();
-    ASSERT_EQ(val.type, VAL_ARRAY);
-    ASSERT_EQ(val.as.array.count, 0);
-    ASSERT_NOT_NULL(val.as.array.items);
-    free(val.as.array.items);
-}
-
-TEST(value_is_truthy) {
-    Value null_val = value_create_null();
-    Value false_val = value_create_boolean(false);
-    Value true_val = value_create_boolean(true);
-    Value zero = value_create_number(0);
-    Value non_zero = value_create_number(5);
-    Value empty_str = value_create_string("");
-    Value non_empty_str = value_create_string("hello");
+TEST(interpreter_index_assign) {
+    const char *code =
+        "ليكن أ = [1, 2, 3]\n"
+        "أ[0] = 10\n"
+        "أ[2] += 5\n"
+        "ليكن ب = أ[0] + أ[2]";
     
-    ASSERT_FALSE(value_is_truthy(&null_val));
-    ASSERT_FALSE(value_is_truthy(&false_val));
-    ASSERT_TRUE(value_is_truthy(&true_val));
-    ASSERT_FALSE(value_is_truthy(&zero));
-    ASSERT_TRUE(value_is_truthy(&non_zero));
-    ASSERT_FALSE(value_is_truthy(&empty_str));
-    ASSERT_TRUE(value_is_truthy(&non_empty_str));
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
     
-    free(empty_str.as.string);
-    free(non_empty_str.as.string);
-}
-
-TEST(value_equals) {
-    Value a = value_create_number(5);
-    Value b = value_create_number(5);
-    Value c = value_create_number(10);
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
     
-    ASSERT_TRUE(value_equals(&a, &b));
-    ASSERT_FALSE(value_equals(&a, &c));
-}
-
-/* ============================================
- * Environment Tests
- * اختبارات البيئة
- * ============================================ */
-
-TEST(environment_create_destroy) {
-    Environment *env = environment_create(NULL, "test");
-    ASSERT_NOT_NULL(env);
-    environment_destroy(env);
+    Value *أ = interpreter_get_variable(interp, "أ");
+    ASSERT_NOT_NULL(أ);
+    ASSERT_EQ(أ->as.array.count, 3);
+    ASSERT_EQ(أ->as.array.items[0]->as.integer, 10);
+    ASSERT_EQ(أ->as.array.items[1]->as.integer, 2);
+    ASSERT_EQ(أ->as.array.items[2]->as.integer, 8);
+    ASSERT_EQ(interpreter_get_variable(interp, "ب")->as.integer, 18);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
 }
 
-TEST(environment_define_get) {
-    Environment *env = environment_create(NULL, "test");
-    Value val = value_create_number(42);
+TEST(interpreter_property_assign) {
+    const char *code =
+        "ليكن ك = {اسم: \"وسام\", عمر: 3}\n"
+        "ك.عمر += 1\n"
+        "ك.لغة = \"C\"\n"
+        "ك[\"قائمة\"] = [1, 2]\n"
+        "ك.قائمة[1] = 20";
     
-    environment_define(env, "س", val, false);
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
     
-    Value *retrieved = environment_get(env, "س");
-    ASSERT_NOT_NULL(retrieved);
-    ASSERT_EQ(retrieved->as.number, 42);
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
     
-    environment_destroy(env);
+    Value *ك = interpreter_get_variable(interp, "ك");
+    ASSERT_NOT_NULL(ك);
+    ASSERT_EQ(ك->type, VAL_OBJECT);
+    ASSERT_EQ(ك->as.object.count, 4);
+    ASSERT_EQ(object_get(ك, "عمر")->as.integer, 4);
+    ASSERT(strcmp(object_get(ك, "لغة")->as.string, "C") == 0);
+    ASSERT_EQ(object_get(ك, "قائمة")->as.array.items[1]->as.integer, 20);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
 }
 
-TEST(environment_set) {
-    Environment *env = environment_create(NULL, "test");
-    Value val1 = value_create_number(10);
-    Value val2 = value_create_number(20);
+TEST(interpreter_index_side_effects) {
+    // الفهارس تقيم قبل تتبع الحاويات: الدالة تعيد تعيين المتغير فتقرأ الحاوية الجديدة
+    const char *code =
+        "ليكن أ = [[1, 2], [3, 4]]\n"
+        "دالة ف\n"
+        "    أ = [[7, 8], [9, 10]]\n"
+        "    أعد 1\n"
+        "انتهى\n"
+        "ليكن ب = أ[1][ف()]\n"
+        "أ = [[1, 2], [3, 4]]\n"
+        "أ[ف()][0] = 5\n"
+        "ليكن ن = \"abc\"\n"
+        "ليكن عداد = 0\n"
+        "دالة ع\n"
+        "    عداد = عداد + 1\n"
+        "    أعد 1\n"
+        "انتهى\n"
+        "ليكن محرف = ن[ع()][0]\n"
+        "ليكن م = مدى(5، 9)\n"
+        "ليكن عنصر = م[ع()]\n"
+        "ليكن موجود = \"b\" في ن[ع()]";
     
-    environment_define(env, "س", val1, false);
-    environment_set(env, "س", val2);
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
     
-    Value *retrieved = environment_get(env, "س");
-    ASSERT_EQ(retrieved->as.number, 20);
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
     
-    environment_destroy(env);
+    ASSERT_EQ(interpreter_get_variable(interp, "ب")->as.integer, 10);
+    Value *أ = interpreter_get_variable(interp, "أ");
+    ASSERT_EQ(أ->as.array.items[1]->as.array.items[0]->as.integer, 5);
+    ASSERT_EQ(أ->as.array.items[0]->as.array.items[0]->as.integer, 7);
+    // بعد نص في السلسلة لا يعاد تقييم الفهارس
+    ASSERT_EQ(strcmp(interpreter_get_variable(interp, "محرف")->as.string, "b"), 0);
+    ASSERT_EQ(interpreter_get_variable(interp, "عنصر")->as.integer, 6);
+    ASSERT_TRUE(interpreter_get_variable(interp, "موجود")->as.boolean);
+    ASSERT_EQ(interpreter_get_variable(interp, "عداد")->as.integer, 3);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
 }
 
-TEST(environment_constant) {
-    Environment *env = environment_create(NULL, "test");
-    Value val = value_create_number(10);
+TEST(interpreter_inline_cache) {
+    const char *code =
+        "ليكن أ = {س: 1, ص: 2}\n"
+        "ليكن ب = {ص: 10, س: 20}\n"
+        "ليكن مجموع = 0\n"
+        "لكل ع من 1 إلى 3\n"
+        "    مجموع += أ.ص\n"
+        "    مجموع += ب.ص\n"
+        "    أ = ب\n"
+        "انتهى";
     
-    environment_define(env, "PI", val, true);
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
     
-    ASSERT_TRUE(environment_is_constant(env, "PI"));
-    ASSERT_FALSE(environment_is_constant(env, "غير_موجود"));
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
     
-    environment_destroy(env);
+    Value *مجموع = interpreter_get_variable(interp, "مجموع");
+    ASSERT_NOT_NULL(مجموع);
+    ASSERT_EQ(مجموع->as.integer, 2 + 10 + 10 + 10 + 10 + 10);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
 }
 
-TEST(environment_nested) {
-    Environment *parent = environment_create(NULL, "parent");
-    Environment *child = environment_create(parent, "child");
-    
-    Value val = value_create_number(100);
-    environment_define(parent, "س", val, false);
+TEST(interpreter_struct) {
+    const char *code =
+        "هيكل طالب\n"
+        "    اسم\n"
+        "    عمر\n"
+        "انتهى\n"
+        "ليكن أ = طالب{اسم: \"علي\"}\n"
+        "أ.عمر = 20\n"
+        "أ.عمر += 1\n"
+        "ليكن ب = أ\n"
+        "ب.عمر = 5\n"
+        "أ.لقب = 1";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    Value result = value_create_null();
+    for (int i = 0; i < ast->as.program.count; i++) {
+        value_free(&result);
+        result = interpreter_evaluate(interp, ast->as.program.statements[i]);
+    }
+    
+    // لا تضاف حقول جديدة إلى الهيكل
+    ASSERT_EQ(result.type, VAL_EXCEPTION);
+    ASSERT_EQ(result.as.exception.code, 11);
+    
+    Value *أ = interpreter_get_variable(interp, "أ");
+    ASSERT_NOT_NULL(أ);
+    ASSERT_EQ(أ->type, VAL_STRUCT);
+    ASSERT(strcmp(أ->as.structure->fields[0].as.string, "علي") == 0);
+    ASSERT_EQ(أ->as.structure->fields[1].as.integer, 21);
+    ASSERT_EQ(interpreter_get_variable(interp, "ب")->as.structure->fields[1].as.integer, 5);
+    
+    value_free(&result);
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_class_vtable) {
+    const char *code =
+        "صنف حيوان\n"
+        "    اسم\n"
+        "    دالة تهيئة ن\n"
+        "        هذا.اسم = ن\n"
+        "    انتهى\n"
+        "    دالة صوت\n"
+        "        أعد \"...\"\n"
+        "    انتهى\n"
+        "    دالة وصف\n"
+        "        أعد هذا.اسم + \": \" + هذا.صوت()\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "صنف قطة يرث حيوان\n"
+        "    دالة صوت\n"
+        "        أعد \"مواء\"\n"
+        "    انتهى\n"
+        "    دالة نم\n"
+        "        أعد صحيح\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "ليكن ح = جديد حيوان(\"ح\")\n"
+        "ليكن ق = جديد قطة(\"ق\")\n"
+        "ليكن أ = ح.وصف()\n"
+        "ليكن ب = ق.وصف()";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // الجدول المسطح: الدالة المعاد تعريفها في موضع الأصل والجديدة بعد الموروثة
+    Class *حيوان = interpreter_get_variable(interp, "حيوان")->as.class_def.def;
+    Class *قطة = interpreter_get_variable(interp, "قطة")->as.class_def.def;
+    ASSERT_EQ(حيوان->method_count, 3);
+    ASSERT_EQ(قطة->method_count, 4);
+    ASSERT_EQ(shape_find(قطة->method_shape, "صوت"), shape_find(حيوان->method_shape, "صوت"));
+    ASSERT_EQ(shape_find(قطة->method_shape, "نم"), 3);
+    ASSERT(قطة->vtable[0].as.function.body == حيوان->vtable[0].as.function.body);
+    
+    Value *أ = interpreter_get_variable(interp, "أ");
+    Value *ب = interpreter_get_variable(interp, "ب");
+    ASSERT_NOT_NULL(أ);
+    ASSERT_NOT_NULL(ب);
+    ASSERT(strcmp(أ->as.string, "ح: ...") == 0);
+    ASSERT(strcmp(ب->as.string, "ق: مواء") == 0);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_switch) {
+    const char *code =
+        "ليكن ناتج = \"\"\n"
+        "ليكن ب = 7\n"
+        "لكل ع من 0 إلى 8\n"
+        "    حسب ع\n"
+        "        حالة 1\n"
+        "            ناتج += \"أ\"\n"
+        "        حالة 2\n"
+        "            ناتج += \"ب\"\n"
+        "            توقف\n"
+        "            ناتج += \"!\"\n"
+        "        حالة ب\n"
+        "            ناتج += \"ج\"\n"
+        "        حالة 7\n"
+        "            ناتج += \"لا تصل\"\n"
+        "        افتراضي\n"
+        "            ناتج += \"-\"\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "حسب \"أمر2\"\n"
+        "    حالة \"أمر1\"\n"
+        "        ناتج += \"1\"\n"
+        "    حالة \"أمر2\"\n"
+        "        ناتج += \"2\"\n"
+        "انتهى\n"
+        "ليكن عشري = \"\"\n"
+        "لكل_عنصر ق في [1e300، -1e300، 1.0، 1.5، 3]\n"
+        "    حسب ق\n"
+        "        حالة 1\n"
+        "            عشري += \"و\"\n"
+        "        حالة 3\n"
+        "            عشري += \"ث\"\n"
+        "        افتراضي\n"
+        "            عشري += \".\"\n"
+        "    انتهى\n"
+        "انتهى";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // الحالة غير الثابتة ب تسبق 7 فتطابق أولاً، و'توقف' تخرج من حسب فقط
+    Value *ناتج = interpreter_get_variable(interp, "ناتج");
+    ASSERT_NOT_NULL(ناتج);
+    ASSERT(strcmp(ناتج->as.string, "-أب----ج-2") == 0);
+    // الأعداد العشرية خارج مدى الجدول أو غير الصحيحة تذهب إلى الافتراضي
+    ASSERT(strcmp(interpreter_get_variable(interp, "عشري")->as.string, "..و.ث") == 0);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_function) {
+    const char *code = 
+        "دالة جمع تأخذ أ ب\n"
+        "    أعد أ + ب\n"
+        "انتهى\n"
+        "ليكن ناتج = جمع 10 20";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *ناتج = interpreter_get_variable(interp, "ناتج");
+    ASSERT_NOT_NULL(ناتج);
+    ASSERT_EQ(ناتج->as.integer, 30);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_memoization) {
+    const char *code =
+        "دالة فيب_ذاكرة تأخذ ن\n"
+        "    إذا ن <= 1 إذن\n"
+        "        أعد ن\n"
+        "    انتهى\n"
+        "    أعد فيب_ذاكرة(ن - 1) + فيب_ذاكرة(ن - 2)\n"
+        "انتهى\n"
+        "ليكن عداد = 0\n"
+        "دالة عد_ذاكرة تأخذ ن\n"
+        "    عداد = عداد + ن\n"
+        "    أعد عداد\n"
+        "انتهى\n"
+        "ليكن ناتج = فيب_ذاكرة(60)\n"
+        "عد_ذاكرة(1)\n"
+        "عد_ذاكرة(1)";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *ناتج = interpreter_get_variable(interp, "ناتج");
+    ASSERT_NOT_NULL(ناتج);
+    ASSERT_EQ(ناتج->as.integer, 1548008755920LL);
+    
+    // كل قيمة من 0 إلى 60 تحسب مرة واحدة
+    Value name = value_create_string("فيب_ذاكرة");
+    Value stats = lib_meta_memo_stats(&name, 1);
+    ASSERT_EQ(stats.type, VAL_OBJECT);
+    ASSERT_EQ(object_get(&stats, "إخفاقات")->as.number, 61);
+    ASSERT_EQ(object_get(&stats, "إصابات")->as.number, 58);
+    value_free(&stats);
+    value_free(&name);
+    
+    // الدالة التي تكتب على متغير عام لا تخزن نتائجها
+    ASSERT_EQ(interpreter_get_variable(interp, "عداد")->as.integer, 2);
+    name = value_create_string("عد_ذاكرة");
+    stats = lib_meta_memo_stats(&name, 1);
+    ASSERT_EQ(stats.type, VAL_NULL);
+    value_free(&name);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_memo_redefine) {
+    const char *code =
+        "دالة ج س\n"
+        "    أعد س\n"
+        "انتهى\n"
+        "دالة ف س\n"
+        "    أعد ج(س)\n"
+        "انتهى\n"
+        "ليكن قبل = ف(1)\n"
+        "دالة ج س\n"
+        "    أعد 2\n"
+        "انتهى\n"
+        "ليكن بعد = ف(1)\n"
+        "ليكن عداد = 0\n"
+        "دالة ج س\n"
+        "    عداد = عداد + 1\n"
+        "    أعد عداد\n"
+        "انتهى\n"
+        "ف(1)\n"
+        "ف(1)";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // إعادة تعريف دالة مستدعاة تبطل نتائج من يستدعيها ونقاءه
+    ASSERT_EQ(interpreter_get_variable(interp, "قبل")->as.integer, 1);
+    ASSERT_EQ(interpreter_get_variable(interp, "بعد")->as.integer, 2);
+    ASSERT_EQ(interpreter_get_variable(interp, "عداد")->as.integer, 2);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_map) {
+    const char *code =
+        "ليكن م = [1: \"واحد\", \"ب\": 2, [1, 2]: \"زوج\"]\n"
+        "ليكن أ = م[1.0]\n"
+        "ليكن ب = م[[1, 2]]\n"
+        "م[\"ب\"] += 5\n"
+        "ليكن موجود = \"ب\" في م\n"
+        "ليكن فارغة = [:]";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *م = interpreter_get_variable(interp, "م");
+    ASSERT_NOT_NULL(م);
+    ASSERT_EQ(م->type, VAL_MAP);
+    ASSERT_EQ(م->as.map->count, 3);
+    
+    // 1 و 1.0 المفتاح نفسه، والمصفوفات مفاتيح بمحتواها
+    ASSERT_EQ(strcmp(interpreter_get_variable(interp, "أ")->as.string, "واحد"), 0);
+    ASSERT_EQ(strcmp(interpreter_get_variable(interp, "ب")->as.string, "زوج"), 0);
+    
+    Value key = value_create_string("ب");
+    ASSERT_EQ(map_get(م, &key)->as.integer, 7);
+    value_free(&key);
+    
+    ASSERT_TRUE(interpreter_get_variable(interp, "موجود")->as.boolean);
+    ASSERT_EQ(interpreter_get_variable(interp, "فارغة")->type, VAL_MAP);
+    ASSERT_EQ(interpreter_get_variable(interp, "فارغة")->as.map->count, 0);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_set) {
+    const char *code =
+        "ليكن أ = مجموعة([1, 2, 3, 2, [1, 2]])\n"
+        "ليكن ب = مجموعة([3, 4, [1, 2]])\n"
+        "ليكن اتحاد = أ | ب\n"
+        "ليكن تقاطع = أ & ب\n"
+        "ليكن فرق = أ - ب\n"
+        "ليكن موجود = [1, 2] في أ";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *أ = interpreter_get_variable(interp, "أ");
+    ASSERT_NOT_NULL(أ);
+    ASSERT_EQ(أ->type, VAL_SET);
+    ASSERT_EQ(أ->as.set->count, 4);
+    ASSERT_EQ(interpreter_get_variable(interp, "اتحاد")->as.set->count, 5);
+    ASSERT_EQ(interpreter_get_variable(interp, "تقاطع")->as.set->count, 2);
+    ASSERT_EQ(interpreter_get_variable(interp, "فرق")->as.set->count, 2);
+    ASSERT_TRUE(interpreter_get_variable(interp, "موجود")->as.boolean);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_vector) {
+    const char *code =
+        "ليكن أ = متجه([1, 2, 3, [4, 5]])\n"
+        "ليكن ب = أ\n"
+        "ب[0] = 100\n"
+        "ب[3][1] = 50\n"
+        "ليكن أول = أ[0]\n"
+        "ليكن داخلي = أ[3][1]";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // تعديل النسخة لا يمس الأصل
+    Value *ب = interpreter_get_variable(interp, "ب");
+    ASSERT_NOT_NULL(ب);
+    ASSERT_EQ(ب->type, VAL_VECTOR);
+    ASSERT_EQ(vector_get(ب, 0)->as.integer, 100);
+    ASSERT_EQ(vector_get(ب, 3)->as.array.items[1]->as.integer, 50);
+    ASSERT_EQ(interpreter_get_variable(interp, "أول")->as.integer, 1);
+    ASSERT_EQ(interpreter_get_variable(interp, "داخلي")->as.integer, 5);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_async) {
+    const char *code =
+        "ليكن ترتيب = \"\"\n"
+        "غير_متزامن دالة مهمة اسم مدة\n"
+        "    انتظر نم(مدة)\n"
+        "    ترتيب = ترتيب + اسم\n"
+        "    أعد مدة * 10\n"
+        "انتهى\n"
+        "ليكن أ = مهمة(\"أ\", 0.02)\n"
+        "ليكن ب = مهمة(\"ب\", 0.01)\n"
+        "ليكن قبل = ترتيب\n"
+        "ليكن نتيجة = انتظر أ\n"
+        "ليكن عادية = انتظر 7";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // الاستدعاء يعود بوعد دون انتظار، والمهمة الأقصر تنتهي أولاً
+    ASSERT(strcmp(interpreter_get_variable(interp, "قبل")->as.string, "") == 0);
+    ASSERT(strcmp(interpreter_get_variable(interp, "ترتيب")->as.string, "بأ") == 0);
+    ASSERT_EQ(interpreter_get_variable(interp, "أ")->type, VAL_PROMISE);
+    ASSERT_TRUE(interpreter_get_variable(interp, "ب")->as.promise->resolved);
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "نتيجة")), 0.2);
+    ASSERT_EQ(interpreter_get_variable(interp, "عادية")->as.integer, 7);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_generator) {
+    const char *code =
+        "ليكن منتجة = 0\n"
+        "دالة أعداد حد\n"
+        "    ليكن ي = 0\n"
+        "    طالما ي < حد\n"
+        "        منتجة = منتجة + 1\n"
+        "        أنتج ي\n"
+        "        ي = ي + 1\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "دالة مربعات مصدر\n"
+        "    لكل_عنصر س في مصدر\n"
+        "        أنتج س * س\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "ليكن مجموع = 0\n"
+        "لكل س في مربعات(أعداد(1000000))\n"
+        "    مجموع = مجموع + س\n"
+        "    إذا س >= 9 إذن\n"
+        "        توقف\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "ليكن محارف = 0\n"
+        "لكل_عنصر ح في \"سلام\"\n"
+        "    محارف = محارف + 1\n"
+        "انتهى";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    ASSERT_TRUE(ast->as.program.statements[1]->as.function_def.is_generator);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // المولد لا ينتج إلا ما تطلبه الحلقة، ويغلق عند الخروج منها
+    ASSERT_EQ(interpreter_get_variable(interp, "مجموع")->as.integer, 14);
+    ASSERT_EQ(interpreter_get_variable(interp, "منتجة")->as.integer, 4);
+    ASSERT_EQ(interpreter_get_variable(interp, "محارف")->as.integer, 4);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_generator_return) {
+    const char *code =
+        "دالة أعداد حد\n"
+        "    ليكن ي = 0\n"
+        "    طالما ي < حد\n"
+        "        أنتج ي\n"
+        "        ي = ي + 1\n"
+        "    انتهى\n"
+        "انتهى\n"
+        "دالة أول_أكبر حد\n"
+        "    لكل_عنصر س في أعداد(100)\n"
+        "        إذا س > حد إذن\n"
+        "            أعد س\n"
+        "        انتهى\n"
+        "    انتهى\n"
+        "    أعد -1\n"
+        "انتهى\n"
+        "ليكن أول = أول_أكبر(5)\n"
+        "ليكن لا_شيء = أول_أكبر(500)";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // 'أعد' داخل الحلقة تبقى بعد إغلاق المولد
+    ASSERT_EQ(interpreter_get_variable(interp, "أول")->as.integer, 6);
+    ASSERT_EQ(interpreter_get_variable(interp, "لا_شيء")->as.integer, -1);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_range) {
+    const char *code =
+        "ليكن مجموع = 0\n"
+        "لكل_عنصر ي في مدى(0، 1000000)\n"
+        "    مجموع = مجموع + ي\n"
+        "انتهى\n"
+        "ليكن م = مدى(2، 20، 3)\n"
+        "ليكن ثالث = م[2]\n"
+        "ليكن موجود = 11 في م\n"
+        "ليكن مفقود = 12 في م\n"
+        "ليكن نسخة = م\n"
+        "م[0] = 99";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    ASSERT_EQ(interpreter_get_variable(interp, "مجموع")->as.integer, 499999500000LL);
+    ASSERT_EQ(interpreter_get_variable(interp, "ثالث")->as.integer, 8);
+    ASSERT_TRUE(interpreter_get_variable(interp, "موجود")->as.boolean);
+    ASSERT_FALSE(interpreter_get_variable(interp, "مفقود")->as.boolean);
+    
+    // الكتابة في عنصر تحول المدى إلى مصفوفة ولا تمس النسخة
+    Value *written = interpreter_get_variable(interp, "م");
+    ASSERT_EQ(written->type, VAL_ARRAY);
+    ASSERT_EQ(written->as.array.count, 6);
+    ASSERT_EQ(written->as.array.items[0]->as.integer, 99);
+    ASSERT_EQ(interpreter_get_variable(interp, "نسخة")->type, VAL_RANGE);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_pipeline) {
+    const char *code =
+        "ليكن مستدعاة = 0\n"
+        "دالة مربع س\n"
+        "    مستدعاة = مستدعاة + 1\n"
+        "    أعد س * س\n"
+        "انتهى\n"
+        "دالة زوجي س\n"
+        "    أعد س % 2 == 0\n"
+        "انتهى\n"
+        "ليكن مربعات = طبق([1، 2، 3]، مربع)\n"
+        "ليكن أزواج = رشح([1، 2، 3، 4]، زوجي)\n"
+        "ليكن سلسلة = خذ(تخطى(رشح(طبق(كسول(مدى(1000000))، مربع)، زوجي)، 2)، 3)\n"
+        "ليكن قبل = مستدعاة\n"
+        "ليكن ناتج = اجمع(سلسلة)\n"
+        "ليكن مجموع = 0\n"
+        "لكل_عنصر س في سلسلة\n"
+        "    مجموع = مجموع + س\n"
+        "انتهى";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *squares = interpreter_get_variable(interp, "مربعات");
+    ASSERT_EQ(squares->as.array.count, 3);
+    ASSERT_EQ(squares->as.array.items[2]->as.integer, 9);
+    ASSERT_EQ(interpreter_get_variable(interp, "أزواج")->as.array.count, 2);
+    
+    // السلسلة لا تستدعي شيئاً حتى تجمع، ثم تتوقف عند اكتمال خذ: 0² 2² (تتخطى) 4² 6² 8²
+    ASSERT_EQ(interpreter_get_variable(interp, "قبل")->as.integer, 3);
+    Value *collected = interpreter_get_variable(interp, "ناتج");
+    ASSERT_EQ(collected->as.array.count, 3);
+    ASSERT_EQ(collected->as.array.items[0]->as.integer, 16);
+    ASSERT_EQ(collected->as.array.items[2]->as.integer, 64);
+    ASSERT_EQ(interpreter_get_variable(interp, "مستدعاة")->as.integer, 3 + 2 * 9);
+    ASSERT_EQ(interpreter_get_variable(interp, "مجموع")->as.integer, 16 + 36 + 64);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_parallel) {
+    const char *code =
+        "دالة ثقيل س\n"
+        "    ليكن م = 0\n"
+        "    ليكن ي = 0\n"
+        "    طالما ي < 50\n"
+        "        م = م + (س * ي) % 7\n"
+        "        ي = ي + 1\n"
+        "    انتهى\n"
+        "    أعد م\n"
+        "انتهى\n"
+        "دالة زوجي س\n"
+        "    أعد س % 2 == 0\n"
+        "انتهى\n"
+        "دالة جمع أ ب\n"
+        "    أعد أ + ب\n"
+        "انتهى\n"
+        "ليكن عدد = 0\n"
+        "دالة مراقب س\n"
+        "    عدد = عدد + 1\n"
+        "    أعد س\n"
+        "انتهى\n"
+        "ليكن متواز = طبق_متوازي(مدى(3000)، ثقيل)\n"
+        "ليكن متسلسل = طبق(مدى(3000)، ثقيل)\n"
+        "ليكن مجموع = اختزل_متوازي(مدى(100001)، جمع، 0)\n"
+        "ليكن أزواج = رشح_متوازي(مدى(1000)، زوجي)\n"
+        "ليكن مراقبة = طبق_متوازي([1، 2، 3]، مراقب)";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // الناتج مرتب كالمتسلسل مهما كان عدد العمال
+    Value *parallel = interpreter_get_variable(interp, "متواز");
+    ASSERT_EQ(parallel->as.array.count, 3000);
+    ASSERT_TRUE(value_equals(parallel, interpreter_get_variable(interp, "متسلسل")));
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "مجموع")), 5000050000.0);
+    Value *evens = interpreter_get_variable(interp, "أزواج");
+    ASSERT_EQ(evens->as.array.count, 500);
+    ASSERT_EQ(evens->as.array.items[499]->as.integer, 998);
+    
+    // الدالة غير النقية تنفذ متسلسلة في المفسر نفسه
+    ASSERT_EQ(interpreter_get_variable(interp, "عدد")->as.integer, 3);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_parallel_for) {
+    const char *code =
+        "دالة مربع س\n"
+        "    أعد س * س\n"
+        "انتهى\n"
+        "ليكن مضاعف = 3\n"
+        "ليكن مربعات = []\n"
+        "لكل_متوازي ي من 0 إلى 999\n"
+        "    ليكن م = مربع(ي)\n"
+        "    مربعات[ي] = م * مضاعف\n"
+        "انتهى\n"
+        "ليكن مجموع = 0\n"
+        "لكل_متوازي ي من 1 إلى 100\n"
+        "    مجموع = مجموع + ي\n"
+        "انتهى";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // المصفوفة تحجز بطول الحلقة، وكل دورة تكتب خانتها
+    Value *squares = interpreter_get_variable(interp, "مربعات");
+    ASSERT_EQ(squares->as.array.count, 1000);
+    ASSERT_EQ(value_as_number(squares->as.array.items[0]), 0.0);
+    ASSERT_EQ(value_as_number(squares->as.array.items[999]), 2994003.0);
+    // الكتابة في متغير خارجي تنفذ الحلقة متسلسلة
+    ASSERT_EQ(interpreter_get_variable(interp, "مجموع")->as.integer, 5050);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_spawn) {
+    const char *code =
+        "دالة ضرب أ ب\n"
+        "    أعد أ * ب\n"
+        "انتهى\n"
+        "ليكن عداد = 0\n"
+        "دالة عد\n"
+        "    عداد = عداد + 1\n"
+        "    أعد عداد\n"
+        "انتهى\n"
+        "دالة جمع أ ب\n"
+        "    أعد أ + ب\n"
+        "انتهى\n"
+        "دالة احسب أ ب\n"
+        "    أعد ضرب(أ، ب)\n"
+        "انتهى\n"
+        "ليكن نواتج = انضم([شغّل(ضرب، 6، 7)، شغّل(ضرب، 2، 3)])\n"
+        "ليكن منتظر = انتظر شغّل(ضرب، 5، 5)\n"
+        "ليكن متسلسل = انضم(شغّل(عد))\n"
+        "ليكن مؤجل = شغّل(احسب، 4، 5)\n"
+        "ضرب = جمع\n"
+        "ليكن قديم = انضم(مؤجل)";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    // انضم يعيد النواتج بترتيب الوعود
+    Value *results = interpreter_get_variable(interp, "نواتج");
+    ASSERT_EQ(results->as.array.count, 2);
+    ASSERT_EQ(value_as_number(results->as.array.items[0]), 42.0);
+    ASSERT_EQ(value_as_number(results->as.array.items[1]), 6.0);
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "منتظر")), 25.0);
+    // الدالة غير النقية تنفذ فوراً في المفسر نفسه
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "متسلسل")), 1.0);
+    ASSERT_EQ(interpreter_get_variable(interp, "عداد")->as.integer, 1);
+    // المهمة ترى الدوال العامة كما كانت عند إنشائها
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "قديم")), 20.0);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+// برنامج في خيط مستقل بمفسر خاص؛ يعيد قيمة 'ناتج'
+static void *run_isolated_program(void *arg) {
+    Lexer *lexer = lexer_create((const char *)arg, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    Value *result = interpreter_get_variable(interp, "ناتج");
+    intptr_t number = result ? (intptr_t)value_as_number(result) : -1;
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+    return (void *)number;
+}
+
+TEST(interpreter_isolated_contexts) {
+    // مفسران في خيطين معاً: لكل منهما حلقة أحداثه وذواكر دواله
+    const char *fib20 =
+        "دالة فيبو ن\n"
+        "    إذا ن < 2 إذن\n"
+        "        أعد ن\n"
+        "    انتهى\n"
+        "    أعد فيبو(ن - 1) + فيبو(ن - 2)\n"
+        "انتهى\n"
+        "انتظر نم(0.01)\n"
+        "ليكن ناتج = فيبو(20)";
+    const char *fib15 =
+        "دالة فيبو ن\n"
+        "    إذا ن < 2 إذن\n"
+        "        أعد ن\n"
+        "    انتهى\n"
+        "    أعد فيبو(ن - 1) + فيبو(ن - 2)\n"
+        "انتهى\n"
+        "انتظر نم(0.02)\n"
+        "ليكن ناتج = فيبو(15)";
+    pthread_t first, second;
+    void *first_result, *second_result;
+    pthread_create(&first, NULL, run_isolated_program, (void *)fib20);
+    pthread_create(&second, NULL, run_isolated_program, (void *)fib15);
+    pthread_join(first, &first_result);
+    pthread_join(second, &second_result);
+    ASSERT_EQ((intptr_t)first_result, 6765);
+    ASSERT_EQ((intptr_t)second_result, 610);
+    
+    // حالة المكتبات تتبع المفسر الجاري: عقل الأول لا يراه الثاني
+    Interpreter *owner = interpreter_create();
+    Interpreter *other = interpreter_create();
+    ASTNode empty = {0};
+    empty.type = AST_PROGRAM;
+    Value mind[3] = {value_create_string("مساعد"), value_create_string("مرحبا"), value_create_string("أهلا")};
+    
+    interpreter_run(owner, &empty);
+    Value created = lib_mind_create(mind, 1);
+    value_free(&created);
+    Value learned = lib_mind_learn(mind, 3);
+    value_free(&learned);
+    interpreter_run(other, &empty);
+    Value unknown = lib_mind_ask(mind, 2);
+    ASSERT(strcmp(unknown.as.string, "لا أعرف") == 0);
+    interpreter_run(owner, &empty);
+    Value known = lib_mind_ask(mind, 2);
+    ASSERT(strcmp(known.as.string, "أهلا") == 0);
+    
+    value_free(&unknown);
+    value_free(&known);
+    for (int i = 0; i < 3; i++) {
+        value_free(&mind[i]);
+    }
+    interpreter_destroy(other);
+    interpreter_destroy(owner);
+}
+
+TEST(interpreter_channels) {
+    // منتج وحللان في خيوط معزولة، والبرنامج الرئيسي يجمع ما يصل
+    const char *code =
+        "ليكن عداد = 0\n"
+        "دالة منتج ق ن\n"
+        "    لكل ي من 1 إلى ن\n"
+        "        أرسل(ق، [ي])\n"
+        "    انتهى\n"
+        "    أغلق(ق)\n"
+        "    عداد = ن\n"
+        "    أعد عداد\n"
+        "انتهى\n"
+        "دالة محلل داخل خارج\n"
+        "    لكل س في داخل\n"
+        "        أرسل(خارج، س[0] * س[0])\n"
+        "    انتهى\n"
+        "    أعد 0\n"
+        "انتهى\n"
+        "ليكن أ = قناة(2)\n"
+        "ليكن ب = قناة(1)\n"
+        "ليكن م = خيط(منتج، أ، 50)\n"
+        "ليكن محللات = [خيط(محلل، أ، ب)، خيط(محلل، أ، ب)]\n"
+        "ليكن مجموع = 0\n"
+        "ليكن وصل = 0\n"
+        "طالما وصل < 50\n"
+        "    مجموع = مجموع + استقبل(ب)\n"
+        "    وصل = وصل + 1\n"
+        "انتهى\n"
+        "ليكن أرسل_المنتج = انضم(م)\n"
+        "انضم(محللات)\n"
+        "أغلق(ب)\n"
+        "ليكن بعد_الإغلاق = استقبل(ب)\n"
+        "ليكن ج = قناة(1)\n"
+        "ليكن اختيار = اختر([ب، [ج، \"مرحبا\"]])\n"
+        "ليكن في_ج = استقبل(ج)";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "مجموع")), 42925.0);
+    ASSERT_EQ(value_as_number(interpreter_get_variable(interp, "أرسل_المنتج")), 50.0);
+    // للخيط نسخته من المتغيرات العامة فلا يغير ما في البرنامج الرئيسي
+    ASSERT_EQ(interpreter_get_variable(interp, "عداد")->as.integer, 0);
+    ASSERT_EQ(interpreter_get_variable(interp, "بعد_الإغلاق")->type, VAL_NULL);
+    // اختر يتجاوز القناة المغلقة إلى حالة الإرسال الجاهزة
+    Value *choice = interpreter_get_variable(interp, "اختيار");
+    ASSERT_EQ(choice->as.array.count, 2);
+    ASSERT_EQ(value_as_number(choice->as.array.items[0]), 1.0);
+    ASSERT(strcmp(interpreter_get_variable(interp, "في_ج")->as.string, "مرحبا") == 0);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_frozen_values) {
+    // البيانات المجمدة تقرأ من الخيوط والقنوات دون نسخ، وتقارن بمحتواها
+    const char *code =
+        "ليكن مرجع = جمد({الأسماء: [\"نور\"، \"قمر\"]، الأوزان: [1، 2، 3]})\n"
+        "دالة وزن ب\n"
+        "    ليكن ع = 0\n"
+        "    لكل س في ب.الأوزان\n"
+        "        ع = ع + س\n"
+        "    انتهى\n"
+        "    أعد ع\n"
+        "انتهى\n"
+        "ليكن أوزان = انضم([خيط(وزن، مرجع)، خيط(وزن، مرجع)])\n"
+        "ليكن ق = قناة(1)\n"
+        "أرسل(ق، مرجع.الأسماء)\n"
+        "ليكن وصل = استقبل(ق)\n"
+        "ليكن مجمدة = مجمد(وصل)\n"
+        "ليكن متساويان = وصل == [\"نور\"، \"قمر\"]\n"
+        "ليكن ثان = وصل[1]";
+    
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *weights = interpreter_get_variable(interp, "أوزان");
+    ASSERT_EQ(weights->as.array.count, 2);
+    ASSERT_EQ(value_as_number(weights->as.array.items[1]), 6.0);
+    ASSERT_TRUE(interpreter_get_variable(interp, "مجمدة")->as.boolean);
+    ASSERT_TRUE(interpreter_get_variable(interp, "متساويان")->as.boolean);
+    ASSERT(strcmp(interpreter_get_variable(interp, "ثان")->as.string, "قمر") == 0);
+    // ما وصل عبر القناة هو الحاوية نفسها لا نسخة منها
+    Value *root = interpreter_get_variable(interp, "مرجع");
+    Value *names = object_get(&root->as.frozen->value, "الأسماء");
+    ASSERT(names->as.frozen == interpreter_get_variable(interp, "وصل")->as.frozen);
+    
+    // التعديل في أي مستوى استثناء، والمتغير نفسه يقبل قيمة جديدة
+    const char *writes[] = {"مرجع.الأوزان[0] = 9", "مرجع[\"جديد\"] = 1", "وصل = 5"};
+    for (int i = 0; i < 3; i++) {
+        Lexer *write_lexer = lexer_create(writes[i], "test.wsm");
+        int write_count;
+        Token *write_tokens = lexer_tokenize(write_lexer, &write_count);
+        Parser *write_parser = parser_create(write_tokens, write_count);
+        ASTNode *write_ast = parser_parse(write_parser);
+        Value result = interpreter_evaluate(interp, write_ast->as.program.statements[0]);
+        if (i < 2) {
+            ASSERT_EQ(result.type, VAL_EXCEPTION);
+            ASSERT_EQ(result.as.exception.code, 9);
+        } else {
+            ASSERT_EQ(result.type, VAL_NULL);
+        }
+        value_free(&result);
+        free(write_ast);
+        parser_destroy(write_parser);
+        free(write_tokens);
+        lexer_destroy(write_lexer);
+    }
+    ASSERT_EQ(object_get(&root->as.frozen->value, "الأوزان")->as.frozen->value.as.array.count, 3);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+TEST(interpreter_array) {
+    const char *code = "ليكن أرقام = [1، 2، 3، 4، 5]";
+    Lexer *lexer = lexer_create(code, "test.wsm");
+    int token_count;
+    Token *tokens = lexer_tokenize(lexer, &token_count);
+    Parser *parser = parser_create(tokens, token_count);
+    ASTNode *ast = parser_parse(parser);
+    
+    Interpreter *interp = interpreter_create();
+    interpreter_run(interp, ast);
+    
+    Value *أرقام = interpreter_get_variable(interp, "أرقام");
+    ASSERT_NOT_NULL(أرقام);
+    ASSERT_EQ(أرقام->type, VAL_ARRAY);
+    ASSERT_EQ(أرقام->as.array.count, 5);
+    
+    interpreter_destroy(interp);
+    free(ast);
+    parser_destroy(parser);
+    free(tokens);
+    lexer_destroy(lexer);
+}
+
+/* ============================================
+ * Value Tests
+ * اختبارات القيم
+ * ============================================ */
+
+TEST(value_create_number) {
+    Value val = value_create_number(42.5);
+    ASSERT_EQ(val.type, VAL_NUMBER);
+    ASSERT_EQ(val.as.number, 42.5);
+}
+
+TEST(value_create_string) {
+    Value val = value_create_string("مرحبا");
+    ASSERT_EQ(val.type, VAL_STRING);
+    ASSERT(strcmp(val.as.string, "مرحبا") == 0);
+    value_free(&val);
+}
+
+TEST(value_create_boolean) {
+    Value val = value_create_boolean(true);
+    ASSERT_EQ(val.type, VAL_BOOLEAN);
+    ASSERT_TRUE(val.as.boolean);
+}
+
+TEST(value_create_null) {
+    Value val = value_create_null();
+    ASSERT_EQ(val.type, VAL_NULL);
+}
+
+TEST(value_create_array) {
+    Value val = value_create_array();
+    ASSERT_EQ(val.type, VAL_ARRAY);
+    ASSERT_EQ(val.as.array.count, 0);
+    ASSERT_NOT_NULL(val.as.array.items);
+    free(val.as.array.items);
+}
+
+TEST(value_is_truthy) {
+    Value null_val = value_create_null();
+    Value false_val = value_create_boolean(false);
+    Value true_val = value_create_boolean(true);
+    Value zero = value_create_number(0);
+    Value non_zero = value_create_number(5);
+    Value empty_str = value_create_string("");
+    Value non_empty_str = value_create_string("hello");
+    
+    ASSERT_FALSE(value_is_truthy(&null_val));
+    ASSERT_FALSE(value_is_truthy(&false_val));
+    ASSERT_TRUE(value_is_truthy(&true_val));
+    ASSERT_FALSE(value_is_truthy(&zero));
+    ASSERT_TRUE(value_is_truthy(&non_zero));
+    ASSERT_FALSE(value_is_truthy(&empty_str));
+    ASSERT_TRUE(value_is_truthy(&non_empty_str));
+    
+    value_free(&empty_str);
+    value_free(&non_empty_str);
+}
+
+TEST(value_equals) {
+    Value a = value_create_number(5);
+    Value b = value_create_number(5);
+    Value c = value_create_number(10);
+    
+    ASSERT_TRUE(value_equals(&a, &b));
+    ASSERT_FALSE(value_equals(&a, &c));
+}
+
+TEST(value_iterate_collections) {
+    Value map = value_create_map();
+    map_set(&map, value_create_string("أ"), value_create_int(1));
+    map_set(&map, value_create_string("ب"), value_create_int(2));
+    
+    // الخرائط تعطي مفاتيحها
+    int64_t position = 0;
+    Value item;
+    int keys = 0;
+    while (value_iterate(&map, &position, &item)) {
+        ASSERT_NOT_NULL(map_get(&map, &item));
+        value_free(&item);
+        keys++;
+    }
+    ASSERT_EQ(keys, 2);
+    
+    // النصوص تعطي محارف UTF-8 كاملة
+    Value text = value_create_string("سa");
+    position = 0;
+    ASSERT_TRUE(value_iterate(&text, &position, &item));
+    ASSERT(strcmp(item.as.string, "س") == 0);
+    value_free(&item);
+    ASSERT_TRUE(value_iterate(&text, &position, &item));
+    ASSERT(strcmp(item.as.string, "a") == 0);
+    value_free(&item);
+    ASSERT_FALSE(value_iterate(&text, &position, &item));
+    
+    Value number = value_create_int(3);
+    ASSERT_FALSE(value_is_iterable(&number));
+    ASSERT_TRUE(value_is_iterable(&map));
+    
+    value_free(&text);
+    value_free(&map);
+}
+
+TEST(value_deep_equality) {
+    Value a = value_create_array();
+    Value b = value_create_array();
+    Value args[2];
+    args[0] = a;
+    args[1] = value_create_int(1);
+    a = lib_list_add(args, 2);
+    args[0] = b;
+    args[1] = value_create_number(1.0);
+    b = lib_list_add(args, 2);
+    
+    // 1 و 1.0 متساويان فالمصفوفتان متساويتان ولهما التجزئة نفسها
+    ASSERT_TRUE(value_equals(&a, &b));
+    ASSERT_EQ(value_hash(&a), value_hash(&b));
+    
+    args[0] = b;
+    args[1] = value_create_int(2);
+    b = lib_list_add(args, 2);
+    ASSERT_FALSE(value_equals(&a, &b));
+    
+    // ترتيب المفاتيح لا يؤثر في المساواة ولا في التجزئة
+    Value x = value_create_object();
+    Value y = value_create_object();
+    object_set(&x, "أ", value_create_int(1));
+    object_set(&x, "ب", value_copy(&a));
+    object_set(&y, "ب", value_copy(&a));
+    object_set(&y, "أ", value_create_int(1));
+    ASSERT_TRUE(value_equals(&x, &y));
+    ASSERT_EQ(value_hash(&x), value_hash(&y));
+    
+    object_set(&y, "أ", value_create_int(2));
+    ASSERT_FALSE(value_equals(&x, &y));
+    
+    value_free(&a);
+    value_free(&b);
+    value_free(&x);
+    value_free(&y);
+}
+
+TEST(string_header_cache) {
+    Value val = value_create_string("مرحبا");
+    
+    ASSERT_EQ(string_length(val.as.string), 10);
+    ASSERT_EQ(string_char_count(val.as.string), 5);
+    ASSERT_EQ(string_char_offset(val.as.string, 2), 4);
+    
+    Value copy = value_copy(&val);
+    ASSERT_EQ(string_hash(val.as.string), string_hash(copy.as.string));
+    ASSERT_TRUE(value_equals(&val, &copy));
+    
+    value_free(&val);
+    value_free(&copy);
+}
+
+TEST(string_embedded_length) {
+    Value val = value_create_string_len("ab\0cd", 5);
+    Value other = value_create_string_len("ab\0ce", 5);
+    
+    ASSERT_EQ(string_length(val.as.string), 5);
+    ASSERT_TRUE(value_is_truthy(&val));
+    ASSERT_FALSE(value_equals(&val, &other));
+    
+    value_free(&val);
+    value_free(&other);
+}
+
+TEST(object_hash_index) {
+    Value obj = value_create_object();
+    char key[32];
+    
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "مفتاح%d", i);
+        object_set(&obj, key, value_create_int(i));
+    }
+    object_set(&obj, "مفتاح5", value_create_int(-5));
+    
+    ASSERT_EQ(obj.as.object.count, 1000);
+    ASSERT_NOT_NULL(obj.as.object.index);
+    ASSERT(strcmp(obj.as.object.keys[0], "مفتاح0") == 0);
+    ASSERT(strcmp(obj.as.object.keys[999], "مفتاح999") == 0);
+    ASSERT_EQ(object_get(&obj, "مفتاح5")->as.integer, -5);
+    ASSERT_EQ(object_get(&obj, "مفتاح777")->as.integer, 777);
+    ASSERT_NULL(object_get(&obj, "مفتاح1000"));
+    
+    Value copy = value_copy(&obj);
+    ASSERT_EQ(object_get(&copy, "مفتاح999")->as.integer, 999);
+    
+    value_free(&obj);
+    value_free(&copy);
+}
+
+TEST(object_shapes) {
+    Value a = value_create_object();
+    Value b = value_create_object();
+    object_set(&a, "س", value_create_int(1));
+    object_set(&a, "ص", value_create_int(2));
+    object_set(&b, "س", value_create_int(3));
+    object_set(&b, "ص", value_create_int(4));
+    
+    ASSERT_NOT_NULL(a.as.object.shape);
+    ASSERT(a.as.object.shape == b.as.object.shape);
+    ASSERT(a.as.object.keys == b.as.object.keys);
+    
+    Value copy = value_copy(&a);
+    ASSERT(copy.as.object.shape == a.as.object.shape);
+    object_set(&copy, "ع", value_create_int(5));
+    ASSERT(copy.as.object.shape != a.as.object.shape);
+    ASSERT_EQ(a.as.object.count, 2);
+    ASSERT_EQ(object_get(&copy, "ص")->as.integer, 2);
+    
+    // ترتيب مختلف للمفاتيح يعطي شكلاً مختلفاً
+    Value c = value_create_object();
+    object_set(&c, "ص", value_create_int(1));
+    object_set(&c, "س", value_create_int(2));
+    ASSERT(c.as.object.shape != a.as.object.shape);
+    
+    // المفاتيح المتفرقة: بعد SHAPE_MAX_TRANSITIONS انتقالاً من الشكل نفسه يتحول الكائن إلى قاموس
+    Value spread[SHAPE_MAX_TRANSITIONS + 1];
+    for (int i = 0; i <= SHAPE_MAX_TRANSITIONS; i++) {
+        char key[32];
+        snprintf(key, sizeof(key), "مفتاح%d", i);
+        spread[i] = value_create_object();
+        object_set(&spread[i], "تفرع", value_create_int(0));
+        object_set(&spread[i], key, value_create_int(i));
+    }
+    ASSERT_NOT_NULL(spread[SHAPE_MAX_TRANSITIONS - 1].as.object.shape);
+    ASSERT(spread[SHAPE_MAX_TRANSITIONS].as.object.shape == NULL);
+    ASSERT_EQ(object_get(&spread[SHAPE_MAX_TRANSITIONS], "تفرع")->as.integer, 0);
+    char last[32];
+    snprintf(last, sizeof(last), "مفتاح%d", SHAPE_MAX_TRANSITIONS);
+    ASSERT_EQ(object_get(&spread[SHAPE_MAX_TRANSITIONS], last)->as.integer, SHAPE_MAX_TRANSITIONS);
+    // والانتقالات الموجودة تبقى مشتركة
+    Value again = value_create_object();
+    object_set(&again, "تفرع", value_create_int(1));
+    object_set(&again, "مفتاح3", value_create_int(3));
+    ASSERT(again.as.object.shape == spread[3].as.object.shape);
+    
+    for (int i = 0; i <= SHAPE_MAX_TRANSITIONS; i++) {
+        value_free(&spread[i]);
+    }
+    value_free(&again);
+    value_free(&a);
+    value_free(&b);
+    value_free(&copy);
+    value_free(&c);
+}
+
+TEST(value_freeze_sharing) {
+    // [[1, 2], "نص"]: المصفوفة الداخلية تصبح مرجعاً مجمداً بدورها
+    Value inner = value_create_array();
+    for (int i = 1; i <= 2; i++) {
+        Value *item = malloc(sizeof(Value));
+        *item = value_create_int(i);
+        array_append(&inner, item);
+    }
+    Value outer = value_create_array();
+    Value *slot = malloc(sizeof(Value));
+    *slot = inner;
+    array_append(&outer, slot);
+    Value *text = malloc(sizeof(Value));
+    *text = value_create_string("نص");
+    array_append(&outer, text);
+    Value plain = value_copy(&outer);
+    
+    Value frozen = value_freeze(outer);
+    ASSERT_EQ(frozen.type, VAL_FROZEN);
+    Value *content = &frozen.as.frozen->value;
+    ASSERT_EQ(content->as.array.items[0]->type, VAL_FROZEN);
+    ASSERT_EQ(content->as.array.items[1]->type, VAL_STRING);
+    ASSERT_TRUE(value_equals(&frozen, &plain));
+    ASSERT_EQ(value_hash(&frozen), value_hash(&plain));
+    
+    // النسخة تزيد العداد وتشارك المحتوى
+    Value copy = value_copy(&frozen);
+    ASSERT(copy.as.frozen == frozen.as.frozen);
+    ASSERT_EQ(frozen.as.frozen->refcount, 2);
+    
+    // الإذابة تعطي نسخة عادية مستقلة في كل المستويات
+    Value thawed = value_thaw(copy);
+    ASSERT_EQ(thawed.type, VAL_ARRAY);
+    ASSERT_EQ(thawed.as.array.items[0]->type, VAL_ARRAY);
+    ASSERT_EQ(frozen.as.frozen->refcount, 1);
+    thawed.as.array.items[0]->as.array.items[0]->as.integer = 7;
+    ASSERT_EQ(content->as.array.items[0]->as.frozen->value.as.array.items[0]->as.integer, 1);
+    
+    value_free(&thawed);
+    value_free(&plain);
+    value_free(&frozen);
+}
+
+TEST(string_append_growth) {
+    Value val = value_create_string("س");
+    string_char_count(val.as.string);
+    string_hash(val.as.string);
+    
+    for (int i = 0; i < 1000; i++) {
+        val.as.string = string_append(val.as.string, "ab", 2);
+    }
+    
+    ASSERT_EQ(string_length(val.as.string), 2002);
+    ASSERT_EQ(string_char_count(val.as.string), 2001);
+    ASSERT_TRUE(string_header(val.as.string)->capacity >= 2002);
+    
+    Value expected = value_copy(&val);
+    string_header(expected.as.string)->has_hash = false;
+    ASSERT_EQ(string_hash(val.as.string), string_hash(expected.as.string));
+    
+    value_free(&val);
+    value_free(&expected);
+}
+
+/* ============================================
+ * Environment Tests
+ * اختبارات البيئة
+ * ============================================ */
+
+TEST(environment_create_destroy) {
+    Environment *env = environment_create(NULL, "test");
+    ASSERT_NOT_NULL(env);
+    environment_destroy(env);
+}
+
+TEST(environment_define_get) {
+    Environment *env = environment_create(NULL, "test");
+    Value val = value_create_number(42);
+    
+    environment_define(env, "س", val, false);
+    
+    Value *retrieved = environment_get(env, "س");
+    ASSERT_NOT_NULL(retrieved);
+    ASSERT_EQ(retrieved->as.number, 42);
+    
+    environment_destroy(env);
+}
+
+TEST(environment_set) {
+    Environment *env = environment_create(NULL, "test");
+    Value val1 = value_create_number(10);
+    Value val2 = value_create_number(20);
+    
+    environment_define(env, "س", val1, false);
+    environment_set(env, "س", val2);
+    
+    Value *retrieved = environment_get(env, "س");
+    ASSERT_EQ(retrieved->as.number, 20);
+    
+    environment_destroy(env);
+}
+
+TEST(environment_constant) {
+    Environment *env = environment_create(NULL, "test");
+    Value val = value_create_number(10);
+    
+    environment_define(env, "PI", val, true);
+    
+    ASSERT_TRUE(environment_is_constant(env, "PI"));
+    ASSERT_FALSE(environment_is_constant(env, "غير_موجود"));
+    
+    environment_destroy(env);
+}
+
+TEST(environment_nested) {
+    Environment *parent = environment_create(NULL, "parent");
+    Environment *child = environment_create(parent, "child");
+    
+    Value val = value_create_number(100);
+    environment_define(parent, "س", val, false);
     
     Value *from_child = environment_get(child, "س");
     ASSERT_NOT_NULL(from_child);
@@ -634,8 +2197,8 @@ TEST(lib_text_upper) {
     
     ASSERT(strcmp(result.as.string, "HELLO") == 0);
     
-    free(arg.as.string);
-    free(result.as.string);
+    value_free(&arg);
+    value_free(&result);
 }
 
 TEST(lib_text_lower) {
@@ -644,8 +2207,8 @@ TEST(lib_text_lower) {
     
     ASSERT(strcmp(result.as.string, "hello") == 0);
     
-    free(arg.as.string);
-    free(result.as.string);
+    value_free(&arg);
+    value_free(&result);
 }
 
 TEST(lib_text_length) {
@@ -654,7 +2217,22 @@ TEST(lib_text_length) {
     
     ASSERT_EQ(result.as.number, 5);
     
-    free(arg.as.string);
+    value_free(&arg);
+}
+
+TEST(lib_text_substring_utf8) {
+    Value args[] = {
+        value_create_string("مرحبا بالعالم"),
+        value_create_number(6),
+        value_create_number(7)
+    };
+    Value result = lib_text_substring(args, 3);
+    
+    ASSERT(strcmp(result.as.string, "بالعالم") == 0);
+    ASSERT_EQ(string_length(result.as.string), strlen("بالعالم"));
+    
+    value_free(&args[0]);
+    value_free(&result);
 }
 
 TEST(lib_math_abs) {
@@ -681,6 +2259,369 @@ TEST(lib_math_pow) {
     ASSERT_EQ(result.as.number, 8);
 }
 
+TEST(lib_list_unique) {
+    Value list = value_create_array();
+    Value pair = value_create_array();
+    Value args[2];
+    args[0] = pair;
+    args[1] = value_create_int(1);
+    pair = lib_list_add(args, 2);
+    
+    args[0] = list;
+    args[1] = pair;
+    list = lib_list_add(args, 2);
+    args[0] = list;
+    args[1] = value_create_string("نص");
+    list = lib_list_add(args, 2);
+    args[0] = list;
+    args[1] = pair;
+    list = lib_list_add(args, 2);
+    args[0] = list;
+    args[1] = value_create_string("نص");
+    list = lib_list_add(args, 2);
+    
+    Value unique = lib_list_unique(&list, 1);
+    ASSERT_EQ(unique.type, VAL_ARRAY);
+    ASSERT_EQ(unique.as.array.count, 2);
+    ASSERT_TRUE(value_equals(unique.as.array.items[0], &pair));
+    
+    // البحث يقارن المصفوفات بمحتواها
+    args[0] = list;
+    args[1] = pair;
+    ASSERT_EQ(lib_list_index_of(args, 2).as.number, 0);
+    ASSERT_TRUE(lib_list_contains(args, 2).as.boolean);
+    
+    value_free(&unique);
+    value_free(&list);
+    value_free(&pair);
+}
+
+TEST(lib_map_robin_hood) {
+    Value map = lib_map_create(NULL, 0);
+    Value args[3];
+    
+    for (int i = 0; i < 1000; i++) {
+        args[0] = map;
+        args[1] = value_create_int(i);
+        args[2] = value_create_int(i * i);
+        // تعيد خريطة جديدة، والقديمة يحررها المستدعي كما تحرر المعاملات
+        Value next = lib_map_set(args, 3);
+        value_free(&map);
+        map = next;
+    }
+    ASSERT_EQ(map.as.map->count, 1000);
+    
+    // الحذف بالإزاحة للخلف يبقي سلاسل البحث سليمة
+    for (int i = 0; i < 1000; i += 2) {
+        args[0] = map;
+        args[1] = value_create_int(i);
+        ASSERT_TRUE(lib_map_delete(args, 2).as.boolean);
+    }
+    ASSERT_EQ(lib_map_size(&map, 1).as.number, 500);
+    
+    for (int i = 0; i < 1000; i++) {
+        args[0] = map;
+        args[1] = value_create_number(i);
+        args[2] = value_create_int(-1);
+        Value found = lib_map_get(args, 3);
+        ASSERT_EQ(found.as.integer, i % 2 ? (int64_t)i * i : -1);
+    }
+    
+    // الأزواج تعيد بناء خريطة مساوية
+    Value entries = lib_map_entries(&map, 1);
+    Value rebuilt = lib_map_create(&entries, 1);
+    ASSERT_TRUE(value_equals(&map, &rebuilt));
+    ASSERT_EQ(value_hash(&map), value_hash(&rebuilt));
+    
+    Value words = value_create_array();
+    const char *text[] = {"أ", "ب", "أ", "ج", "أ"};
+    for (int i = 0; i < 5; i++) {
+        args[0] = words;
+        args[1] = value_create_string(text[i]);
+        words = lib_list_add(args, 2);
+        value_free(&args[1]);
+    }
+    Value counts = lib_map_count(&words, 1);
+    ASSERT_EQ(counts.as.map->count, 3);
+    args[0] = counts;
+    args[1] = value_create_string("أ");
+    ASSERT_EQ(lib_map_get(args, 2).as.integer, 3);
+    value_free(&args[1]);
+    
+    value_free(&counts);
+    value_free(&words);
+    value_free(&entries);
+    value_free(&rebuilt);
+    value_free(&map);
+}
+
+TEST(lib_set_operations) {
+    Value set = lib_set_create(NULL, 0);
+    Value args[2];
+    
+    // تجاوز SET_SMALL_MAX يبني الفهرس، والحذف يحافظ على صحته
+    for (int i = 0; i < 100; i++) {
+        args[0] = set;
+        args[1] = value_create_int(i);
+        ASSERT_TRUE(lib_set_add(args, 2).as.boolean);
+    }
+    args[1] = value_create_number(5);
+    ASSERT_FALSE(lib_set_add(args, 2).as.boolean);
+    
+    for (int i = 0; i < 100; i += 2) {
+        args[1] = value_create_int(i);
+        ASSERT_TRUE(lib_set_remove(args, 2).as.boolean);
+    }
+    ASSERT_EQ(lib_set_size(&set, 1).as.number, 50);
+    for (int i = 0; i < 100; i++) {
+        args[1] = value_create_int(i);
+        ASSERT_EQ(lib_set_has(args, 2).as.boolean, i % 2 == 1);
+    }
+    
+    Value items = lib_set_to_array(&set, 1);
+    ASSERT_EQ(items.as.array.count, 50);
+    Value rebuilt = lib_set_create(&items, 1);
+    ASSERT_TRUE(value_equals(&set, &rebuilt));
+    ASSERT_EQ(value_hash(&set), value_hash(&rebuilt));
+    
+    Value small = value_create_set();
+    set_add(&small, value_create_int(1));
+    set_add(&small, value_create_int(2));
+    args[0] = small;
+    args[1] = set;
+    ASSERT_FALSE(lib_set_is_subset(args, 2).as.boolean);
+    Value common = lib_set_intersection(args, 2);
+    ASSERT_EQ(common.as.set->count, 1);
+    args[0] = common;
+    ASSERT_TRUE(lib_set_is_subset(args, 2).as.boolean);
+    
+    value_free(&common);
+    value_free(&small);
+    value_free(&rebuilt);
+    value_free(&items);
+    value_free(&set);
+}
+
+TEST(lib_list_deque) {
+    Value queue = value_create_array();
+    Value args[2];
+    
+    // طابور: إضافة في النهاية وحذف من البداية مع إعادة استخدام الفراغ الأمامي
+    int next = 0;
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 3; i++) {
+            args[0] = queue;
+            args[1] = value_create_int(round * 3 + i);
+            queue = lib_list_push(args, 2);
+        }
+        for (int i = 0; i < 2; i++) {
+            Value item = lib_list_shift(&queue, 1);
+            ASSERT_EQ(item.as.integer, next);
+            next++;
+        }
+    }
+    ASSERT_EQ(queue.as.array.count, 1000);
+    ASSERT_TRUE(queue.as.array.capacity < 4000);
+    
+    // الإضافة في البداية تحفظ الترتيب
+    for (int i = 0; i < 100; i++) {
+        args[0] = queue;
+        args[1] = value_create_int(-1 - i);
+        queue = lib_list_unshift(args, 2);
+    }
+    ASSERT_EQ(queue.as.array.count, 1100);
+    ASSERT_EQ(queue.as.array.items[0]->as.integer, -100);
+    ASSERT_EQ(queue.as.array.items[100]->as.integer, next);
+    ASSERT_EQ(lib_list_pop(&queue, 1).as.integer, 2999);
+    
+    Value copy = value_copy(&queue);
+    ASSERT_TRUE(value_equals(&queue, &copy));
+    
+    while (queue.as.array.count > 0) {
+        Value item = lib_list_shift(&queue, 1);
+        value_free(&item);
+    }
+    ASSERT_EQ(queue.as.array.offset, 0);
+    
+    value_free(&copy);
+    value_free(&queue);
+}
+
+TEST(lib_list_range) {
+    Value args[3] = {value_create_number(10), value_create_number(0), value_create_number(-3)};
+    Value range = lib_list_range(args, 3);
+    ASSERT_EQ(range.type, VAL_RANGE);
+    ASSERT_EQ(lib_list_length(&range, 1).as.number, 4);
+    Value index[2] = {range, value_create_number(3)};
+    ASSERT_EQ(lib_list_get(index, 2).as.integer, 1);
+    
+    Value query[2] = {range, value_create_int(4)};
+    ASSERT_EQ(lib_list_index_of(query, 2).as.number, 2);
+    query[1] = value_create_int(5);
+    ASSERT_EQ(lib_list_index_of(query, 2).as.number, -1);
+    
+    // المديان متساويان إذا أعطيا العناصر نفسها، والتحويل يحفظها
+    Value same = value_create_range(10, -1, -3);
+    ASSERT_TRUE(value_equals(&range, &same));
+    ASSERT_EQ(value_hash(&range), value_hash(&same));
+    Value array = range;
+    range_materialize(&array);
+    ASSERT_EQ(array.type, VAL_ARRAY);
+    ASSERT_EQ(array.as.array.count, 4);
+    ASSERT_EQ(array.as.array.items[3]->as.integer, 1);
+    
+    args[2] = value_create_number(0);
+    Value error = lib_list_range(args, 3);
+    ASSERT_EQ(error.type, VAL_EXCEPTION);
+    value_free(&error);
+    value_free(&array);
+}
+
+TEST(lib_list_take_skip) {
+    // أكثر من السعة الابتدائية للمصفوفة
+    Value list = value_create_array();
+    for (int i = 0; i < 100; i++) {
+        Value *item = malloc(sizeof(Value));
+        *item = value_create_int(i);
+        array_append(&list, item);
+    }
+    
+    Value args[2] = {list, value_create_number(60)};
+    Value taken = lib_list_take(args, 2);
+    Value skipped = lib_list_skip(args, 2);
+    ASSERT_EQ(taken.as.array.count, 60);
+    ASSERT_EQ(taken.as.array.items[59]->as.integer, 59);
+    ASSERT_EQ(skipped.as.array.count, 40);
+    ASSERT_EQ(skipped.as.array.items[0]->as.integer, 60);
+    
+    // المدى يعطي مدى أقصر دون عناصر
+    args[0] = value_create_range(0, 100, 5);
+    args[1] = value_create_number(3);
+    Value range = lib_list_skip(args, 2);
+    ASSERT_EQ(range.type, VAL_RANGE);
+    ASSERT_EQ(range.as.range.start, 15);
+    ASSERT_EQ(range_length(&range), 17);
+    
+    value_free(&taken);
+    value_free(&skipped);
+    value_free(&list);
+}
+
+TEST(lib_vector_sharing) {
+    Value vector = lib_vector_create(NULL, 0);
+    for (int i = 0; i < 5000; i++) {
+        vector_push(&vector, value_create_int(i));
+    }
+    ASSERT_EQ(lib_vector_size(&vector, 1).as.number, 5000);
+    
+    // النسخة المعدلة تشارك الأصل كل العقد عدا مسار العنصر
+    Value args[3] = {vector, value_create_number(4321), value_create_int(-1)};
+    Value changed = lib_vector_set(args, 3);
+    ASSERT_EQ(vector_get(&vector, 4321)->as.integer, 4321);
+    ASSERT_EQ(vector_get(&changed, 4321)->as.integer, -1);
+    ASSERT_NE(vector.as.vector.root, changed.as.vector.root);
+    ASSERT_EQ(vector.as.vector.root->as.children[0], changed.as.vector.root->as.children[0]);
+    ASSERT_FALSE(value_equals(&vector, &changed));
+    
+    Value copy = value_copy(&vector);
+    ASSERT_EQ(copy.as.vector.root, vector.as.vector.root);
+    ASSERT_TRUE(value_equals(&copy, &vector));
+    
+    Value items = lib_vector_to_array(&changed, 1);
+    ASSERT_EQ(items.as.array.count, 5000);
+    ASSERT_EQ(items.as.array.items[4321]->as.integer, -1);
+    
+    // دوال القوائم تعيد نسخاً جديدة لا يمسها تحرير المعاملات بعد الاستدعاء
+    Value add_args[2] = {value_copy(&vector), value_create_int(7)};
+    Value longer = lib_list_add(add_args, 2);
+    value_free(&add_args[0]);
+    ASSERT_EQ(longer.as.vector.count, 5001);
+    ASSERT_EQ(vector_get(&longer, 5000)->as.integer, 7);
+    Value set_args[3] = {value_copy(&vector), value_create_number(0), value_create_int(9)};
+    Value replaced = lib_list_set(set_args, 3);
+    value_free(&set_args[0]);
+    ASSERT_EQ(vector_get(&replaced, 0)->as.integer, 9);
+    ASSERT_EQ(vector_get(&vector, 0)->as.integer, 0);
+    ASSERT_EQ(vector.as.vector.count, 5000);
+    
+    value_free(&replaced);
+    value_free(&longer);
+    value_free(&items);
+    value_free(&copy);
+    value_free(&changed);
+    value_free(&vector);
+}
+
+TEST(lib_channel_bounded) {
+    // القناة الممتلئة لا تختار للإرسال، والجاهزة للاستقبال تسبقها
+    Value full = value_create_channel(1);
+    Value ready = value_create_channel(1);
+    Value send[2] = {full, value_create_int(1)};
+    Value sent = lib_channel_send(send, 2);
+    ASSERT_EQ(sent.type, VAL_NULL);
+    // القيمة نقلت إلى القناة فلم يبق للمرسل إلا فارغ
+    ASSERT_EQ(send[1].type, VAL_NULL);
+    Value other[2] = {ready, value_create_string("جاهز")};
+    lib_channel_send(other, 2);
+    
+    Value options = value_create_array();
+    Value *pair = malloc(sizeof(Value));
+    *pair = value_create_array();
+    Value *target = malloc(sizeof(Value));
+    *target = value_copy(&full);
+    array_append(pair, target);
+    Value *item = malloc(sizeof(Value));
+    *item = value_create_int(2);
+    array_append(pair, item);
+    array_append(&options, pair);
+    Value *source = malloc(sizeof(Value));
+    *source = value_copy(&ready);
+    array_append(&options, source);
+    Value choice = lib_channel_select(&options, 1);
+    ASSERT_EQ(choice.as.array.items[0]->as.integer, 1);
+    ASSERT(strcmp(choice.as.array.items[1]->as.string, "جاهز") == 0);
+    
+    // المغلقة تسلم ما بقي فيها ثم فارغ، ولا تقبل إرسالاً
+    ASSERT_TRUE(lib_channel_close(&full, 1).as.boolean);
+    ASSERT_FALSE(lib_channel_close(&full, 1).as.boolean);
+    Value rejected[2] = {full, value_create_int(3)};
+    Value error = lib_channel_send(rejected, 2);
+    ASSERT_EQ(error.type, VAL_EXCEPTION);
+    Value first = lib_channel_receive(&full, 1);
+    ASSERT_EQ(first.as.integer, 1);
+    ASSERT_EQ(lib_channel_receive(&full, 1).type, VAL_NULL);
+    
+    value_free(&error);
+    value_free(&choice);
+    value_free(&options);
+    value_free(&full);
+    value_free(&ready);
+}
+
+TEST(lib_async_timers) {
+    // المؤقتات تتحقق بترتيب مواعيدها لا بترتيب إنشائها
+    Value delays[3] = {value_create_number(0.03), value_create_number(0.01), value_create_number(0.02)};
+    Value timers[3];
+    for (int i = 0; i < 3; i++) {
+        timers[i] = lib_async_sleep(&delays[i], 1);
+        ASSERT_EQ(timers[i].type, VAL_PROMISE);
+        ASSERT_FALSE(timers[i].as.promise->resolved);
+    }
+    
+    ASSERT_TRUE(event_loop_run_once());
+    ASSERT_TRUE(timers[1].as.promise->resolved);
+    ASSERT_FALSE(timers[0].as.promise->resolved);
+    
+    event_loop_run();
+    ASSERT_TRUE(timers[0].as.promise->resolved);
+    ASSERT_TRUE(timers[2].as.promise->resolved);
+    ASSERT_FALSE(event_loop_run_once());
+    
+    for (int i = 0; i < 3; i++) {
+        value_free(&timers[i]);
+    }
+}
+
 /* ============================================
  * Integration Tests
  * اختبارات التكامل
@@ -729,7 +2670,7 @@ TEST(integration_fibonacci) {
     
     Value *ناتج = interpreter_get_variable(interp, "ناتج");
     ASSERT_NOT_NULL(ناتج);
-    ASSERT_EQ(ناتج->as.number, 55); // F(10) = 55
+    ASSERT_EQ(ناتج->as.integer, 55); // F(10) = 55
     
     interpreter_destroy(interp);
     free(ast);
@@ -759,7 +2700,7 @@ TEST(integration_factorial) {
     
     Value *ناتج = interpreter_get_variable(interp, "ناتج");
     ASSERT_NOT_NULL(ناتج);
-    ASSERT_EQ(ناتج->as.number, 120); // 5! = 120
+    ASSERT_EQ(ناتج->as.integer, 120); // 5! = 120
     
     interpreter_destroy(interp);
     free(ast);
@@ -813,6 +2754,7 @@ int main() {
     RUN_TEST(lexer_tokenize_if);
     RUN_TEST(lexer_tokenize_string);
     RUN_TEST(lexer_tokenize_number);
+    RUN_TEST(lexer_tokenize_hex);
     RUN_TEST(lexer_tokenize_comments);
     RUN_TEST(lexer_arabic_keywords);
     
@@ -824,6 +2766,8 @@ int main() {
     RUN_TEST(parser_parse_for);
     RUN_TEST(parser_parse_function);
     RUN_TEST(parser_parse_array);
+    RUN_TEST(parser_parse_struct);
+    RUN_TEST(parser_parse_switch);
     
     /* Interpreter Tests */
     print_header("📋 اختبارات المفسر (Interpreter Tests)");
@@ -831,10 +2775,37 @@ int main() {
     RUN_TEST(interpreter_number_literal);
     RUN_TEST(interpreter_string_literal);
     RUN_TEST(interpreter_arithmetic);
+    RUN_TEST(interpreter_integer_overflow);
+    RUN_TEST(interpreter_bitwise);
     RUN_TEST(interpreter_comparison);
     RUN_TEST(interpreter_if_statement);
     RUN_TEST(interpreter_for_loop);
+    RUN_TEST(interpreter_string_append);
+    RUN_TEST(interpreter_string_append_self);
+    RUN_TEST(interpreter_index_assign);
+    RUN_TEST(interpreter_property_assign);
+    RUN_TEST(interpreter_index_side_effects);
+    RUN_TEST(interpreter_inline_cache);
+    RUN_TEST(interpreter_struct);
+    RUN_TEST(interpreter_class_vtable);
+    RUN_TEST(interpreter_switch);
     RUN_TEST(interpreter_function);
+    RUN_TEST(interpreter_memoization);
+    RUN_TEST(interpreter_memo_redefine);
+    RUN_TEST(interpreter_map);
+    RUN_TEST(interpreter_set);
+    RUN_TEST(interpreter_vector);
+    RUN_TEST(interpreter_async);
+    RUN_TEST(interpreter_generator);
+    RUN_TEST(interpreter_generator_return);
+    RUN_TEST(interpreter_range);
+    RUN_TEST(interpreter_pipeline);
+    RUN_TEST(interpreter_parallel);
+    RUN_TEST(interpreter_parallel_for);
+    RUN_TEST(interpreter_spawn);
+    RUN_TEST(interpreter_isolated_contexts);
+    RUN_TEST(interpreter_channels);
+    RUN_TEST(interpreter_frozen_values);
     RUN_TEST(interpreter_array);
     
     /* Value Tests */
@@ -846,6 +2817,14 @@ int main() {
     RUN_TEST(value_create_array);
     RUN_TEST(value_is_truthy);
     RUN_TEST(value_equals);
+    RUN_TEST(value_deep_equality);
+    RUN_TEST(value_iterate_collections);
+    RUN_TEST(string_header_cache);
+    RUN_TEST(string_embedded_length);
+    RUN_TEST(string_append_growth);
+    RUN_TEST(object_hash_index);
+    RUN_TEST(object_shapes);
+    RUN_TEST(value_freeze_sharing);
     
     /* Environment Tests */
     print_header("📋 اختبارات البيئة (Environment Tests)");
@@ -860,9 +2839,19 @@ int main() {
     RUN_TEST(lib_text_upper);
     RUN_TEST(lib_text_lower);
     RUN_TEST(lib_text_length);
+    RUN_TEST(lib_text_substring_utf8);
     RUN_TEST(lib_math_abs);
     RUN_TEST(lib_math_sqrt);
     RUN_TEST(lib_math_pow);
+    RUN_TEST(lib_list_unique);
+    RUN_TEST(lib_list_deque);
+    RUN_TEST(lib_list_range);
+    RUN_TEST(lib_list_take_skip);
+    RUN_TEST(lib_map_robin_hood);
+    RUN_TEST(lib_set_operations);
+    RUN_TEST(lib_vector_sharing);
+    RUN_TEST(lib_channel_bounded);
+    RUN_TEST(lib_async_timers);
     
     /* Integration Tests */
     print_header("📋 اختبارات التكامل (Integration Tests)");